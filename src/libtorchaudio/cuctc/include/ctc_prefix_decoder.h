@@ -29,6 +29,7 @@
 #include <cstdint>
 #include <tuple>
 #include <vector>
+#include "ctc_prefix_decoder_workspace.h"
 namespace cu_ctc {
 
 struct InternalData;
@@ -49,6 +50,23 @@ std::tuple<size_t, int> calculate_require_buff_and_init_internal_data(
     const std::vector<int>& prob_strides,
     int blid,
     float threshold);
+// Same as calculate_require_buff_and_init_internal_data, but the buffer is
+// the workspace of inter_data, which is grown to the largest batch decoded so
+// far and freed with it. Returns max_select_seq_len.
+int init_internal_data_with_workspace(
+    InternalData* inter_data,
+    int batch_size,
+    int seq_len,
+    int vocab_size,
+    int beam,
+    float* log_prob_data_ptr,
+    int* original_lens,
+    const std::vector<int>& prob_sizes,
+    const std::vector<int>& prob_strides,
+    int blid,
+    float threshold);
+WorkspaceStats prefixCTC_workspace_stats(InternalData* inter_data);
+
 int ctc_beam_search_decoder_batch_gpu(
     InternalData* inter_data,
     int blid,
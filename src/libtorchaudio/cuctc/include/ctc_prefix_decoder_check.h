@@ -0,0 +1,58 @@
+// Copyright 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#ifndef __ctc_prefix_decoder_check_h_
+#define __ctc_prefix_decoder_check_h_
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#define CHECK(X, ERROR_INFO)                        \
+  do {                                              \
+    auto result = (X);                              \
+    if (!result) {                                  \
+      fprintf(                                      \
+          stderr,                                   \
+          " File %s Line %d %s ERROR_INFO: %s .\n", \
+          __FILE__,                                 \
+          __LINE__,                                 \
+          #X,                                       \
+          ERROR_INFO);                              \
+      abort();                                      \
+    }                                               \
+  } while (0)
+
+// Same as CHECK, but throws std::invalid_argument instead of aborting, for
+// the checks of the inputs of the CPU decoder, which pybind11 raises as
+// ValueError.
+#define CHECK_ARG(X, ERROR_INFO)               \
+  do {                                         \
+    if (!(X)) {                                \
+      throw std::invalid_argument(ERROR_INFO); \
+    }                                          \
+  } while (0)
+
+#endif
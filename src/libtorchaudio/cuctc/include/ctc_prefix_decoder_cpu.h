@@ -0,0 +1,108 @@
+// CPU implementation of the CTC prefix beam search decoder.
+//
+// Unlike the CUDA decoder (ctc_prefix_decoder.h), the CPU decoder owns its
+// memory, since the beams of a stream grow with it, so it has no buffer
+// protocol: every batch calls init_internal_data_with_workspace and then
+// ctc_beam_search_decoder_batch_cpu, which writes the beam lists, their
+// lengths and their scores in the same layout as the CUDA decoder.
+//
+// A stream is decoded by chunks with ctc_beam_search_begin, then
+// ctc_beam_search_step for every chunk, and ctc_beam_search_finalize. The
+// beams are kept between the chunks, and ctc_beam_search_partial returns the
+// beams so far. The one-shot decoding is a stream of a single chunk.
+#ifndef __ctc_prefix_decoder_cpu_h_
+#define __ctc_prefix_decoder_cpu_h_
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "ctc_prefix_decoder_workspace.h"
+namespace cu_ctc {
+namespace cpu {
+
+struct InternalData;
+// num_threads: number of threads the batch is split across, or 0 to use
+// the hardware concurrency.
+std::uintptr_t prefixCTC_alloc(int num_threads);
+void prefixCTC_free(std::uintptr_t inter_data_ptr);
+// The buffers of the decoder are kept across batches and streams, and only
+// grow when a batch needs more memory than the previous ones.
+WorkspaceStats prefixCTC_workspace_stats(InternalData* inter_data);
+
+// Sets the inputs of the one-shot decoding, which can not run while a stream
+// is decoded. Returns max_select_seq_len.
+int init_internal_data_with_workspace(
+    InternalData* inter_data,
+    int batch_size,
+    int seq_len,
+    int vocab_size,
+    int beam,
+    const float* log_prob_data_ptr,
+    const int* original_lens,
+    const std::vector<int>& prob_sizes,
+    const std::vector<int>& prob_strides,
+    int blid,
+    float threshold);
+// clist: (batch_size, beam, max_select_seq_len) beam lists.
+// clen: (batch_size, beam) lengths of the beam lists.
+// score: (batch_size, beam) log probabilities of the beams, sorted from the
+//   best.
+int ctc_beam_search_decoder_batch_cpu(
+    InternalData* inter_data,
+    int blid,
+    int spid,
+    int* clist,
+    int* clen,
+    float* score);
+
+// Starts decoding a stream of batch_size sequences.
+void ctc_beam_search_begin(
+    InternalData* inter_data,
+    int batch_size,
+    int vocab_size,
+    int beam,
+    int blid,
+    int spid,
+    float threshold);
+// Decodes the next chunk of the stream, of prob_sizes (batch_size, seq_len,
+// vocab_size). original_lens: (batch_size, ) number of valid frames of the
+// chunk in each sequence.
+void ctc_beam_search_step(
+    InternalData* inter_data,
+    const float* log_prob_data_ptr,
+    const int* original_lens,
+    const std::vector<int>& prob_sizes,
+    const std::vector<int>& prob_strides);
+// Returns the length of the longest beam list so far.
+int ctc_beam_search_max_len(InternalData* inter_data);
+// Writes the beams so far, with clist of shape (batch_size, beam, max_len),
+// where max_len is at least ctc_beam_search_max_len.
+void ctc_beam_search_partial(
+    InternalData* inter_data,
+    int max_len,
+    int* clist,
+    int* clen,
+    float* score);
+// Writes the final beams like ctc_beam_search_partial, and ends the stream.
+void ctc_beam_search_finalize(
+    InternalData* inter_data,
+    int max_len,
+    int* clist,
+    int* clen,
+    float* score);
+
+// Biases the search towards hotwords, for the streams started afterwards.
+// hotwords: token ids of each hotword, without blank.
+// scores: bonus added to the log prob of a beam for every token of each
+//   hotword it matches. The bonus of a hotword is kept once it is complete,
+//   and the beams are reported without the bonus of unfinished matches.
+// An empty list removes the hotwords.
+void ctc_beam_search_set_hotwords(
+    InternalData* inter_data,
+    const std::vector<std::vector<int>>& hotwords,
+    const std::vector<float>& scores);
+
+} // namespace cpu
+} // namespace cu_ctc
+
+#endif
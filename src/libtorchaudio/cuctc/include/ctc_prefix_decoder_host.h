@@ -26,20 +26,7 @@
 #ifndef __ctc_prefix_decoder_host_h_
 #define __ctc_prefix_decoder_host_h_
 
-#define CHECK(X, ERROR_INFO)                        \
-  do {                                              \
-    auto result = (X);                              \
-    if (!result) {                                  \
-      fprintf(                                      \
-          stderr,                                   \
-          " File %s Line %d %s ERROR_INFO: %s .\n", \
-          __FILE__,                                 \
-          __LINE__,                                 \
-          #X,                                       \
-          ERROR_INFO);                              \
-      abort();                                      \
-    }                                               \
-  } while (0)
+#include "ctc_prefix_decoder_check.h"
 
 namespace cu_ctc {
 
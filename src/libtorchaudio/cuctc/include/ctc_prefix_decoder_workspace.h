@@ -0,0 +1,22 @@
+// Statistics of the memory a decoder keeps across calls.
+#ifndef __ctc_prefix_decoder_workspace_h_
+#define __ctc_prefix_decoder_workspace_h_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cu_ctc {
+
+// the workspace of the CUDA decoder is aligned to, and sized in multiples of,
+// WORKSPACE_ALIGN_BYTES.
+constexpr size_t WORKSPACE_ALIGN_BYTES = 256;
+
+struct WorkspaceStats {
+  size_t capacity = 0; // bytes held by the decoder.
+  int64_t reallocations = 0; // number of times the memory was grown.
+  int64_t calls = 0; // number of batches or streams decoded.
+};
+
+} // namespace cu_ctc
+
+#endif
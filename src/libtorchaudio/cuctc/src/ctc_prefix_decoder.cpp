@@ -56,6 +56,10 @@ struct InternalData {
   DeviceDataWrap<int> select_seq_lens;
   LogProb log_prob;
   int max_select_seq_len;
+
+  // buffer of init_internal_data_with_workspace.
+  void* workspace = nullptr;
+  WorkspaceStats workspace_stats;
 };
 
 std::tuple<size_t, int> calculate_require_buff_and_init_internal_data(
@@ -288,9 +292,65 @@ std::uintptr_t prefixCTC_alloc(std::uintptr_t stream_ptr) {
 
 void prefixCTC_free(std::uintptr_t inter_data_ptr) {
   InternalData* inter_data = reinterpret_cast<InternalData*>(inter_data_ptr);
+  if (inter_data->workspace != nullptr) {
+    CUDA_CHECK(cudaFree(inter_data->workspace));
+  }
   delete inter_data;
 }
 
+int init_internal_data_with_workspace(
+    InternalData* inter_data,
+    int batch_size,
+    int seq_len,
+    int vocab_size,
+    int beam,
+    float* log_prob_data_ptr,
+    int* original_lens,
+    const std::vector<int>& prob_sizes,
+    const std::vector<int>& prob_strides,
+    int blid,
+    float threshold) {
+  WorkspaceStats& stats = inter_data->workspace_stats;
+  auto init = [&]() {
+    return calculate_require_buff_and_init_internal_data(
+        inter_data,
+        batch_size,
+        seq_len,
+        vocab_size,
+        beam,
+        reinterpret_cast<std::uintptr_t>(inter_data->workspace),
+        stats.capacity,
+        log_prob_data_ptr,
+        original_lens,
+        prob_sizes,
+        prob_strides,
+        blid,
+        threshold);
+  };
+  ++stats.calls;
+  auto [require_size, max_select_seq_len] = init();
+  if (require_size > 0) {
+    // the previous batch is done, since ctc_beam_search_decoder_batch_gpu
+    // synchronizes the stream.
+    if (inter_data->workspace != nullptr) {
+      CUDA_CHECK(cudaFree(inter_data->workspace));
+      inter_data->workspace = nullptr;
+    }
+    const size_t capacity = (require_size + WORKSPACE_ALIGN_BYTES - 1) /
+        WORKSPACE_ALIGN_BYTES * WORKSPACE_ALIGN_BYTES;
+    CUDA_CHECK(cudaMalloc(&inter_data->workspace, capacity));
+    stats.capacity = capacity;
+    ++stats.reallocations;
+    std::tie(require_size, max_select_seq_len) = init();
+    CHECK(require_size == 0, "the workspace is too small.");
+  }
+  return max_select_seq_len;
+}
+
+WorkspaceStats prefixCTC_workspace_stats(InternalData* inter_data) {
+  return inter_data->workspace_stats;
+}
+
 int ctc_beam_search_decoder_batch_gpu(
     InternalData* inter_data,
     int blid,
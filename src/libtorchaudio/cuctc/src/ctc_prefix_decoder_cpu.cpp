@@ -0,0 +1,799 @@
+// CPU port of the CTC prefix beam search of ctc_prefix_decoder_kernel_v2.cu.
+//
+// The GPU kernels process one step of the whole batch at a time. Here, the
+// sequences of the batch are independent, so each thread decodes its
+// sequences frame by frame. The beams of a sequence are kept between calls,
+// so that a stream can be decoded chunk by chunk.
+#include <float.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "../include/ctc_prefix_decoder_check.h"
+#include "../include/ctc_prefix_decoder_cpu.h"
+#include "hotword_trie.h"
+
+namespace cu_ctc {
+namespace cpu {
+
+namespace {
+
+// the GPU merge kernel holds the beam lengths in a 128 element buffer.
+constexpr int MAX_BEAM = 128;
+// number of keys the top-k compares to its threshold at once.
+constexpr int TOPK_BLOCK = 16;
+
+inline float _logsumexp(float a, float b) {
+  float max_ab = a > b ? a : b;
+  float neg_abs_ab = (a - b) > 0 ? (b - a) : (a - b);
+  return max_ab + std::log(1.f + std::exp(neg_abs_ab));
+}
+
+struct Float2 {
+  float x; // log prob of the prefix ending in blank.
+  float y; // log prob of the prefix ending in non-blank.
+};
+
+struct Candidate {
+  float key;
+  int value;
+};
+
+// higher keys first, ties go to the lower value.
+inline bool better(const Candidate& a, const Candidate& b) {
+  return a.key > b.key || (a.key == b.key && a.value < b.value);
+}
+
+// Writes the top k of keys[0, n) into out[0, k), sorted from the best.
+//
+// Candidates are kept in a heap whose front is the worst of them. Once it
+// is full, keys are compared to the front in blocks with a branch-free loop
+// the compiler vectorizes, and a block is only looked into if one of its
+// keys beats the front, which is rare after the first few blocks.
+void topk(const float* keys, int n, int k, Candidate* out) {
+  int size = 0;
+  auto push = [&](float key, int value) {
+    if (size < k) {
+      out[size++] = Candidate{key, value};
+      std::push_heap(out, out + size, better);
+    } else if (key > out[0].key) {
+      std::pop_heap(out, out + k, better);
+      out[k - 1] = Candidate{key, value};
+      std::push_heap(out, out + k, better);
+    }
+  };
+  int i = 0;
+  for (; i < n && size < k; ++i) {
+    push(keys[i], i);
+  }
+  for (; i + TOPK_BLOCK <= n; i += TOPK_BLOCK) {
+    const float threshold = out[0].key;
+    int hits = 0;
+    for (int j = 0; j < TOPK_BLOCK; ++j) {
+      hits += keys[i + j] > threshold;
+    }
+    if (hits > 0) {
+      for (int j = 0; j < TOPK_BLOCK; ++j) {
+        push(keys[i + j], i + j);
+      }
+    }
+  }
+  for (; i < n; ++i) {
+    push(keys[i], i);
+  }
+  std::sort_heap(out, out + k, better);
+}
+
+// (batch, seq_len, vocab_size) log probs of a chunk of the stream.
+struct LogProb {
+  const float* data_ptr;
+  int batch;
+  int seq_len;
+  int vocab_size;
+  int batch_stride;
+  int seq_len_stride;
+  int vocab_stride;
+  const int* origin_seq_lens; // batchs
+
+  float at(int batch_id, int seq_id, int char_id) const {
+    return data_ptr
+        [int64_t(batch_id) * batch_stride + int64_t(seq_id) * seq_len_stride +
+         int64_t(char_id) * vocab_stride];
+  }
+};
+
+LogProb make_log_prob(
+    const float* log_prob_data_ptr,
+    const int* original_lens,
+    const std::vector<int>& prob_sizes,
+    const std::vector<int>& prob_strides) {
+  CHECK_ARG(prob_sizes.size() == 3, "only support 3D log_prob.");
+  CHECK_ARG(prob_strides.size() == 3, "only support 3D log_prob. ");
+  LogProb log_prob;
+  log_prob.data_ptr = log_prob_data_ptr;
+  log_prob.origin_seq_lens = original_lens;
+  log_prob.batch = prob_sizes[0];
+  log_prob.seq_len = prob_sizes[1];
+  log_prob.vocab_size = prob_sizes[2];
+  log_prob.batch_stride = prob_strides[0];
+  log_prob.seq_len_stride = prob_strides[1];
+  log_prob.vocab_stride = prob_strides[2];
+  for (int batch_id = 0; batch_id < log_prob.batch; ++batch_id) {
+    CHECK_ARG(
+        original_lens[batch_id] >= 0 &&
+            original_lens[batch_id] <= log_prob.seq_len,
+        "seq lens must be in [0, seq_len].");
+  }
+  return log_prob;
+}
+
+// Beams of one sequence. The beams of step s are in clist[s % 2] and
+// clen[s % 2], with ldseq_len entries per beam.
+struct Sequence {
+  std::vector<Float2> pprev;
+  std::vector<int> clast;
+  std::vector<int> clen[2];
+  std::vector<int> clist[2];
+  std::vector<float> score;
+  std::vector<int> hotword_state; // node of the hotword trie.
+  int ldseq_len = 0;
+  int steps = 0; // number of selected frames decoded.
+  int last_frame = -1; // index of the last selected frame in the stream.
+  int frames = 0; // number of frames received.
+  int64_t reallocations = 0; // number of times a buffer was grown.
+
+  const int* beam_lens() const {
+    return clen[steps > 0 ? (steps - 1) % 2 : 0].data();
+  }
+  const int* beam_lists() const {
+    return clist[steps > 0 ? (steps - 1) % 2 : 0].data();
+  }
+  size_t capacity_bytes() const;
+};
+
+// Scratch buffers of a thread, reused for all its sequences.
+struct Worker {
+  std::vector<float> ptable; // beam: the blank column, the only finite
+                             // entry of ptable.
+  std::vector<float> ptablen; // beam * lc, then the top-k keys.
+  std::vector<float> ptablen_blank; // beam: the blank column of ptablen.
+  std::vector<float> cur; // lc: log probs of the current frame.
+  std::vector<Candidate> topk; // beam
+  std::vector<char> seen; // lc: scratch buffer of HotwordTrie::add_bonus.
+
+  size_t capacity_bytes() const {
+    return ptable.capacity() * sizeof(float) +
+        ptablen.capacity() * sizeof(float) +
+        ptablen_blank.capacity() * sizeof(float) +
+        cur.capacity() * sizeof(float) + topk.capacity() * sizeof(Candidate) +
+        seen.capacity() * sizeof(char);
+  }
+};
+
+size_t Sequence::capacity_bytes() const {
+  size_t bytes = pprev.capacity() * sizeof(Float2) +
+      clast.capacity() * sizeof(int) + score.capacity() * sizeof(float) +
+      hotword_state.capacity() * sizeof(int);
+  for (int parity = 0; parity < 2; ++parity) {
+    bytes += (clen[parity].capacity() + clist[parity].capacity()) * sizeof(int);
+  }
+  return bytes;
+}
+
+// Resizes v to size elements, or assigns them value, and counts the
+// reallocations. The buffers are kept across streams, so that they are only
+// reallocated when they grow past their largest size.
+template <typename T>
+void resize(std::vector<T>& v, size_t size, int64_t& reallocations) {
+  reallocations += size > v.capacity();
+  v.resize(size);
+}
+template <typename T>
+void assign(
+    std::vector<T>& v,
+    size_t size,
+    const T& value,
+    int64_t& reallocations) {
+  reallocations += size > v.capacity();
+  v.assign(size, value);
+}
+
+// Threads of the decoder, started by the first step that needs them and
+// kept until the decoder is freed, so that the steps of a stream only wake
+// them up.
+class ThreadPool {
+ public:
+  ThreadPool() = default;
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Runs fn(w) for w in [0, n), fn(0) on the calling thread, and returns
+  // once they are all done.
+  void run(int n, const std::function<void(int)>& fn) {
+    while (int(threads_.size()) < n - 1) {
+      const int w = int(threads_.size()) + 1;
+      threads_.emplace_back(&ThreadPool::loop, this, w, generation_);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      fn_ = &fn;
+      n_ = n;
+      pending_ = std::max(n - 1, 0);
+      ++generation_;
+    }
+    start_.notify_all();
+    if (n > 0) {
+      fn(0);
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+  }
+
+ private:
+  void loop(int w, int64_t generation) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      start_.wait(
+          lock, [&] { return stop_ || generation_ != generation; });
+      if (stop_) {
+        return;
+      }
+      generation = generation_;
+      if (w >= n_) {
+        continue;
+      }
+      const std::function<void(int)>& fn = *fn_;
+      lock.unlock();
+      fn(w);
+      lock.lock();
+      if (--pending_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  std::vector<std::thread> threads_;
+  const std::function<void(int)>* fn_ = nullptr;
+  int n_ = 0;
+  int pending_ = 0;
+  int64_t generation_ = 0; // incremented by every run.
+  bool stop_ = false;
+};
+
+} // namespace
+
+struct InternalData {
+  int num_threads;
+
+  // state of the stream, set by ctc_beam_search_begin.
+  bool active = false;
+  int lc;
+  int bs;
+  int beam;
+  int blid;
+  int spid;
+  float threshold;
+  // seqs and worker are kept across streams, and only their first bs and
+  // num_workers entries are used.
+  std::vector<Sequence> seqs;
+  std::vector<Worker> worker;
+  int num_workers = 0;
+  ThreadPool pool; // num_workers - 1 threads, kept across streams.
+  WorkspaceStats workspace_stats;
+
+  // hotwords to bias the search, kept across streams.
+  HotwordTrie hotwords;
+  std::vector<float> root_bonus; // lc
+
+  // inputs of the one-shot decoding, set by
+  // init_internal_data_with_workspace.
+  LogProb log_prob;
+  int max_select_seq_len;
+};
+
+namespace {
+
+// Grows the beam lists of the sequence to hold len tokens.
+void reserve(Sequence& seq, int beam, int len) {
+  if (len <= seq.ldseq_len) {
+    return;
+  }
+  const size_t prev_ld = seq.ldseq_len;
+  const size_t ldseq_len = std::max(len, 2 * seq.ldseq_len);
+  for (std::vector<int>& clist : seq.clist) {
+    resize(clist, beam * ldseq_len, seq.reallocations);
+    // move the lists to their new rows, from the last one since the rows
+    // only move forward.
+    for (size_t beamid = beam - 1; beamid > 0; --beamid) {
+      std::copy_backward(
+          clist.begin() + beamid * prev_ld,
+          clist.begin() + beamid * prev_ld + prev_ld,
+          clist.begin() + beamid * ldseq_len + prev_ld);
+    }
+  }
+  seq.ldseq_len = ldseq_len;
+}
+
+// The GPU decoder looks ahead for skipped frames (need_add_blank in
+// device_log_prob.cuh): if the frames following the current one are
+// skipped, they are decoded as blanks, which moves the probability of the
+// beams ending in non-blank to the beams ending in blank. Here, this is done
+// when the next selected frame is decoded, so that a chunk does not need
+// the frames of the next one. It gives the same result, since the scores
+// are unchanged.
+void add_blank(InternalData* inter_data, Sequence& seq) {
+  for (int beamid = 0; beamid < inter_data->beam; ++beamid) {
+    const Float2 prev = seq.pprev[beamid];
+    seq.pprev[beamid] = Float2{_logsumexp(prev.x, prev.y), -FLT_MAX};
+  }
+}
+
+// First step: the beams are the best tokens of the first frame.
+void first_step(InternalData* inter_data, Sequence& seq, Worker& worker) {
+  const int beam = inter_data->beam;
+  const int blid = inter_data->blid;
+  const HotwordTrie& hotwords = inter_data->hotwords;
+  if (!hotwords.empty()) {
+    for (int charid = 0; charid < inter_data->lc; ++charid) {
+      worker.cur[charid] += inter_data->root_bonus[charid];
+    }
+  }
+  topk(worker.cur.data(), inter_data->lc, beam, worker.topk.data());
+  for (int idx = 0; idx < beam; ++idx) {
+    const int id = worker.topk[idx].value;
+    const float key = worker.topk[idx].key;
+    if (id != blid) {
+      seq.pprev[idx] = Float2{-FLT_MAX, key};
+      seq.clist[0][idx * seq.ldseq_len] = id;
+      seq.clen[0][idx] = 1;
+      seq.clast[idx] = id;
+      if (!hotwords.empty()) {
+        seq.hotword_state[idx] = hotwords.forward(0, id).first;
+      }
+    } else {
+      seq.pprev[idx] = Float2{key, -FLT_MAX};
+    }
+    seq.score[idx] = key;
+  }
+}
+
+void next_step(InternalData* inter_data, Sequence& seq, Worker& worker) {
+  const int lc = inter_data->lc;
+  const int beam = inter_data->beam;
+  const int blid = inter_data->blid;
+  const int spid = inter_data->spid;
+  const int ldseq_len = seq.ldseq_len;
+  const int step = seq.steps;
+  const int* src_clen = seq.clen[(step % 2) ^ 1].data();
+  const int* src_clist = seq.clist[(step % 2) ^ 1].data();
+  int* dst_clen = seq.clen[step % 2].data();
+  int* dst_clist = seq.clist[step % 2].data();
+  const float* cur = worker.cur.data();
+  float* ptable = worker.ptable.data();
+  float* ptablen = worker.ptablen.data();
+  int* clast = seq.clast.data();
+  int* hotword_state = seq.hotword_state.data();
+  const HotwordTrie& hotwords = inter_data->hotwords;
+
+  // extend every beam with every token, see prob_matrix_v2_kernel and
+  // prob_space_blank_kernel_v2. Only the blank column of ptable is finite,
+  // so it is stored as one value per beam. The hotword bonus goes to the
+  // entries which extend the prefix.
+  for (int beamid = 0; beamid < beam; ++beamid) {
+    const Float2 prev = seq.pprev[beamid];
+    const float prev_sum = _logsumexp(prev.x, prev.y);
+    float* row = ptablen + beamid * lc;
+    for (int charid = 0; charid < lc; ++charid) {
+      row[charid] = cur[charid] + prev_sum;
+    }
+    const int target_clast = clast[beamid];
+    const bool repeat = target_clast != blid && target_clast != spid;
+    if (repeat) {
+      // the repeated token only starts a new one after a blank, and
+      // otherwise keeps the prefix.
+      row[target_clast] = cur[target_clast] + prev.x;
+    }
+    if (!hotwords.empty()) {
+      hotwords.add_bonus(
+          hotword_state[beamid],
+          inter_data->root_bonus.data(),
+          lc,
+          row,
+          worker.seen);
+    }
+    row[blid] = repeat ? cur[target_clast] + prev.y : -FLT_MAX;
+    ptable[beamid] = cur[blid] + prev_sum;
+  }
+
+  // merge the beams extended into the prefix of another beam, see
+  // matrix_merge_kernel_v2.
+  for (int j = 0; j < beam; ++j) {
+    for (int i = 0; i < beam; ++i) {
+      if (src_clen[i] - 1 != src_clen[j] ||
+          !std::equal(
+              src_clist + j * ldseq_len,
+              src_clist + j * ldseq_len + src_clen[j],
+              src_clist + i * ldseq_len)) {
+        continue;
+      }
+      float* tidin = ptablen + j * lc + clast[i];
+      float* tidout = ptablen + i * lc + blid;
+      *tidout = _logsumexp(*tidout, *tidin);
+      *tidin = -FLT_MAX;
+    }
+  }
+
+  // the top-k keys are ptablen, but for the blank column which also has
+  // the ptable entry.
+  for (int beamid = 0; beamid < beam; ++beamid) {
+    float* entry = ptablen + beamid * lc + blid;
+    worker.ptablen_blank[beamid] = *entry;
+    *entry = _logsumexp(ptable[beamid], *entry);
+  }
+  Candidate* topk_out = worker.topk.data();
+  topk(ptablen, beam * lc, beam, topk_out);
+
+  int prevclast[MAX_BEAM];
+  int prevstate[MAX_BEAM];
+  std::copy(clast, clast + beam, prevclast);
+  std::copy(hotword_state, hotword_state + beam, prevstate);
+  for (int idx = 0; idx < beam; ++idx) {
+    const int id = topk_out[idx].value;
+    const float cur_score = topk_out[idx].key;
+    const int beamid = id / lc;
+    const int charid = id - beamid * lc;
+    const int prevlen = src_clen[beamid];
+    std::copy(
+        src_clist + beamid * ldseq_len,
+        src_clist + beamid * ldseq_len + prevlen,
+        dst_clist + idx * ldseq_len);
+    if (charid == blid) {
+      clast[idx] = prevclast[beamid];
+      hotword_state[idx] = prevstate[beamid];
+      dst_clen[idx] = prevlen;
+      seq.pprev[idx] = Float2{ptable[beamid], worker.ptablen_blank[beamid]};
+    } else {
+      clast[idx] = charid;
+      hotword_state[idx] = hotwords.empty()
+          ? 0
+          : hotwords.forward(prevstate[beamid], charid).first;
+      dst_clen[idx] = prevlen + 1;
+      dst_clist[idx * ldseq_len + prevlen] = charid;
+      seq.pprev[idx] = Float2{-FLT_MAX, cur_score};
+    }
+    seq.score[idx] = cur_score;
+  }
+}
+
+// Decodes the frames of the chunk whose blank log prob is below the
+// threshold.
+void decode_chunk(
+    InternalData* inter_data,
+    Worker& worker,
+    int batch_id,
+    const LogProb& log_prob) {
+  Sequence& seq = inter_data->seqs[batch_id];
+  const int lc = inter_data->lc;
+  const int blid = inter_data->blid;
+  const int seq_len = log_prob.origin_seq_lens[batch_id];
+
+  int selected = 0;
+  for (int seq_id = 0; seq_id < seq_len; ++seq_id) {
+    selected += log_prob.at(batch_id, seq_id, blid) < inter_data->threshold;
+  }
+  reserve(seq, inter_data->beam, seq.steps + selected);
+
+  for (int seq_id = 0; seq_id < seq_len; ++seq_id) {
+    if (!(log_prob.at(batch_id, seq_id, blid) < inter_data->threshold)) {
+      continue;
+    }
+    for (int charid = 0; charid < lc; ++charid) {
+      worker.cur[charid] = log_prob.at(batch_id, seq_id, charid);
+    }
+    const int frame = seq.frames + seq_id;
+    if (seq.steps == 0) {
+      first_step(inter_data, seq, worker);
+    } else {
+      if (frame - seq.last_frame > 1) {
+        add_blank(inter_data, seq);
+      }
+      next_step(inter_data, seq, worker);
+    }
+    seq.last_frame = frame;
+    ++seq.steps;
+  }
+  seq.frames += seq_len;
+}
+
+// Runs fn(worker, batch_id) for all the sequences of the batch, split across
+// the threads of the decoder.
+template <typename Fn>
+void parallel_for_batch(InternalData* inter_data, Fn fn) {
+  const int workers = inter_data->num_workers;
+  inter_data->pool.run(workers, [&](int w) {
+    for (int batch_id = w; batch_id < inter_data->bs; batch_id += workers) {
+      fn(inter_data->worker[w], batch_id);
+    }
+  });
+}
+
+} // namespace
+
+int init_internal_data_with_workspace(
+    InternalData* inter_data,
+    int batch_size,
+    int seq_len,
+    int vocab_size,
+    int beam,
+    const float* log_prob_data_ptr,
+    const int* original_lens,
+    const std::vector<int>& prob_sizes,
+    const std::vector<int>& prob_strides,
+    int blid,
+    float threshold) {
+  // the one-shot decoding runs on the sequences of the stream.
+  CHECK_ARG(
+      !inter_data->active,
+      "the one-shot decoding can not run while decoding a stream.");
+  if ((int64_t(batch_size) * beam * seq_len * vocab_size) <= 0) {
+    inter_data->log_prob = LogProb{};
+    inter_data->max_select_seq_len = 0;
+    return 0;
+  }
+
+  CHECK_ARG(
+      prob_sizes[0] == batch_size && prob_sizes[1] == seq_len &&
+          prob_sizes[2] == vocab_size,
+      "batch_size ,seq_len ,vocab_size must match with porb_size");
+  CHECK_ARG(
+      beam <= MAX_BEAM && beam <= vocab_size,
+      "beam must be at most 128 and at most vocab_size.");
+  CHECK_ARG(blid >= 0 && blid < vocab_size, "blid must be in [0, vocab_size).");
+
+  inter_data->log_prob = make_log_prob(
+      log_prob_data_ptr, original_lens, prob_sizes, prob_strides);
+  inter_data->beam = beam;
+  inter_data->threshold = threshold;
+
+  const LogProb& log_prob = inter_data->log_prob;
+  int max_select_seq_len = 0;
+  for (int batch_id = 0; batch_id < batch_size; ++batch_id) {
+    int count = 0;
+    for (int seq_id = 0; seq_id < original_lens[batch_id]; ++seq_id) {
+      count += log_prob.at(batch_id, seq_id, blid) < threshold;
+    }
+    max_select_seq_len = std::max(max_select_seq_len, count);
+  }
+  inter_data->max_select_seq_len = max_select_seq_len;
+  return max_select_seq_len;
+}
+
+std::uintptr_t prefixCTC_alloc(int num_threads) {
+  CHECK_ARG(num_threads >= 0, "num_threads must be non-negative.");
+  InternalData* Inter_data = new InternalData;
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  Inter_data->num_threads = num_threads;
+
+  return reinterpret_cast<std::uintptr_t>(Inter_data);
+}
+
+void prefixCTC_free(std::uintptr_t inter_data_ptr) {
+  InternalData* inter_data = reinterpret_cast<InternalData*>(inter_data_ptr);
+  delete inter_data;
+}
+
+void ctc_beam_search_begin(
+    InternalData* inter_data,
+    int batch_size,
+    int vocab_size,
+    int beam,
+    int blid,
+    int spid,
+    float threshold) {
+  CHECK_ARG(batch_size >= 0, "batch_size must be non-negative.");
+  CHECK_ARG(
+      beam > 0 && beam <= MAX_BEAM && beam <= vocab_size,
+      "beam must be in [1, 128] and at most vocab_size.");
+  CHECK_ARG(blid >= 0 && blid < vocab_size, "blid must be in [0, vocab_size).");
+  const HotwordTrie& hotwords = inter_data->hotwords;
+  CHECK_ARG(
+      hotwords.max_token() < vocab_size && !hotwords.has_token(blid),
+      "hotword tokens must be in [0, vocab_size) and not blank.");
+
+  WorkspaceStats& stats = inter_data->workspace_stats;
+  ++stats.calls;
+  inter_data->active = true;
+  inter_data->bs = batch_size;
+  inter_data->lc = vocab_size;
+  inter_data->beam = beam;
+  inter_data->blid = blid;
+  inter_data->spid = spid;
+  inter_data->threshold = threshold;
+
+  if (inter_data->seqs.size() < size_t(batch_size)) {
+    resize(inter_data->seqs, batch_size, stats.reallocations);
+  }
+  for (int batch_id = 0; batch_id < batch_size; ++batch_id) {
+    Sequence& seq = inter_data->seqs[batch_id];
+    int64_t& reallocations = seq.reallocations;
+    resize(seq.pprev, beam, reallocations);
+    assign(seq.clast, beam, blid, reallocations);
+    assign(seq.clen[0], beam, 0, reallocations);
+    assign(seq.clen[1], beam, 0, reallocations);
+    assign(seq.score, beam, 0.f, reallocations);
+    assign(seq.hotword_state, beam, 0, reallocations);
+    seq.ldseq_len = 0;
+    seq.steps = 0;
+    seq.last_frame = -1;
+    seq.frames = 0;
+  }
+  inter_data->root_bonus = hotwords.root_bonus(vocab_size);
+  inter_data->num_workers = std::min(inter_data->num_threads, batch_size);
+  if (inter_data->worker.size() < size_t(inter_data->num_workers)) {
+    resize(inter_data->worker, inter_data->num_workers, stats.reallocations);
+  }
+  for (int w = 0; w < inter_data->num_workers; ++w) {
+    Worker& worker = inter_data->worker[w];
+    int64_t& reallocations = stats.reallocations;
+    resize(worker.ptable, beam, reallocations);
+    resize(worker.ptablen, size_t(beam) * vocab_size, reallocations);
+    resize(worker.ptablen_blank, beam, reallocations);
+    resize(worker.cur, vocab_size, reallocations);
+    resize(worker.topk, beam, reallocations);
+    assign(worker.seen, vocab_size, char(0), reallocations);
+  }
+}
+
+void ctc_beam_search_step(
+    InternalData* inter_data,
+    const float* log_prob_data_ptr,
+    const int* original_lens,
+    const std::vector<int>& prob_sizes,
+    const std::vector<int>& prob_strides) {
+  CHECK_ARG(inter_data->active, "ctc_beam_search_begin must be called first.");
+  const LogProb log_prob = make_log_prob(
+      log_prob_data_ptr, original_lens, prob_sizes, prob_strides);
+  CHECK_ARG(
+      log_prob.batch == inter_data->bs &&
+          log_prob.vocab_size == inter_data->lc,
+      "batch_size and vocab_size must match with ctc_beam_search_begin.");
+  parallel_for_batch(inter_data, [&](Worker& worker, int batch_id) {
+    decode_chunk(inter_data, worker, batch_id, log_prob);
+  });
+}
+
+int ctc_beam_search_max_len(InternalData* inter_data) {
+  CHECK_ARG(inter_data->active, "ctc_beam_search_begin must be called first.");
+  int max_len = 0;
+  for (int batch_id = 0; batch_id < inter_data->bs; ++batch_id) {
+    const int* clen = inter_data->seqs[batch_id].beam_lens();
+    max_len =
+        std::max(max_len, *std::max_element(clen, clen + inter_data->beam));
+  }
+  return max_len;
+}
+
+void ctc_beam_search_partial(
+    InternalData* inter_data,
+    int max_len,
+    int* clist,
+    int* clen,
+    float* score) {
+  CHECK_ARG(inter_data->active, "ctc_beam_search_begin must be called first.");
+  const int beam = inter_data->beam;
+  const HotwordTrie& hotwords = inter_data->hotwords;
+  std::vector<float> beam_score(beam);
+  std::vector<int> order(beam);
+  for (int batch_id = 0; batch_id < inter_data->bs; ++batch_id) {
+    const Sequence& seq = inter_data->seqs[batch_id];
+    const int* src_clen = seq.beam_lens();
+    const int* src_clist = seq.beam_lists();
+    // the bonus of the unfinished hotword matches is taken back, which can
+    // change the order of the beams.
+    for (int beamid = 0; beamid < beam; ++beamid) {
+      beam_score[beamid] = seq.score[beamid] -
+          hotwords.node_score(seq.hotword_state[beamid]);
+      order[beamid] = beamid;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+      return beam_score[a] > beam_score[b];
+    });
+    for (int idx = 0; idx < beam; ++idx) {
+      const int beamid = order[idx];
+      const int len = src_clen[beamid];
+      CHECK_ARG(len <= max_len, "max_len is smaller than a beam list.");
+      std::copy(
+          src_clist + beamid * seq.ldseq_len,
+          src_clist + beamid * seq.ldseq_len + len,
+          clist + (batch_id * beam + idx) * max_len);
+      clen[batch_id * beam + idx] = len;
+      score[batch_id * beam + idx] = beam_score[beamid];
+    }
+  }
+}
+
+void ctc_beam_search_finalize(
+    InternalData* inter_data,
+    int max_len,
+    int* clist,
+    int* clen,
+    float* score) {
+  ctc_beam_search_partial(inter_data, max_len, clist, clen, score);
+  inter_data->active = false;
+}
+
+WorkspaceStats prefixCTC_workspace_stats(InternalData* inter_data) {
+  WorkspaceStats stats = inter_data->workspace_stats;
+  stats.capacity = inter_data->seqs.capacity() * sizeof(Sequence) +
+      inter_data->worker.capacity() * sizeof(Worker);
+  for (const Sequence& seq : inter_data->seqs) {
+    stats.capacity += seq.capacity_bytes();
+    stats.reallocations += seq.reallocations;
+  }
+  for (const Worker& worker : inter_data->worker) {
+    stats.capacity += worker.capacity_bytes();
+  }
+  return stats;
+}
+
+void ctc_beam_search_set_hotwords(
+    InternalData* inter_data,
+    const std::vector<std::vector<int>>& hotwords,
+    const std::vector<float>& scores) {
+  CHECK_ARG(
+      !inter_data->active,
+      "hotwords can not be changed while decoding a stream.");
+  inter_data->hotwords = HotwordTrie(hotwords, scores);
+}
+
+int ctc_beam_search_decoder_batch_cpu(
+    InternalData* inter_data,
+    int blid,
+    int spid,
+    int* clist,
+    int* clen,
+    float* score) {
+  const LogProb& log_prob = inter_data->log_prob;
+  if (log_prob.batch == 0) {
+    return 0;
+  }
+  ctc_beam_search_begin(
+      inter_data,
+      log_prob.batch,
+      log_prob.vocab_size,
+      inter_data->beam,
+      blid,
+      spid,
+      inter_data->threshold);
+  ctc_beam_search_step(
+      inter_data,
+      log_prob.data_ptr,
+      log_prob.origin_seq_lens,
+      {log_prob.batch, log_prob.seq_len, log_prob.vocab_size},
+      {log_prob.batch_stride, log_prob.seq_len_stride, log_prob.vocab_stride});
+  ctc_beam_search_finalize(
+      inter_data, inter_data->max_select_seq_len, clist, clen, score);
+  return 0;
+}
+
+} // namespace cpu
+} // namespace cu_ctc
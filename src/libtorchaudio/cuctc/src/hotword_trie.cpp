@@ -0,0 +1,153 @@
+#include "hotword_trie.h"
+
+#include <algorithm>
+#include <map>
+
+#include "../include/ctc_prefix_decoder_check.h"
+
+namespace cu_ctc {
+namespace cpu {
+
+HotwordTrie::HotwordTrie()
+    : child_begin_{0, 0},
+      fail_{0},
+      node_score_{0.f},
+      output_score_{0.f} {}
+
+HotwordTrie::HotwordTrie(
+    const std::vector<std::vector<int>>& hotwords,
+    const std::vector<float>& scores) {
+  CHECK_ARG(
+      hotwords.size() == scores.size(),
+      "hotwords and scores must have the same size.");
+
+  // build the trie with maps, node 0 being the root.
+  std::vector<std::map<int, int>> children(1);
+  std::vector<float> token_score(1, 0.f);
+  std::vector<bool> is_end(1, false);
+  for (size_t i = 0; i < hotwords.size(); ++i) {
+    CHECK_ARG(!hotwords[i].empty(), "hotwords must not be empty.");
+    int node = 0;
+    for (int token : hotwords[i]) {
+      CHECK_ARG(token >= 0, "hotword tokens must be non-negative.");
+      max_token_ = std::max(max_token_, token);
+      auto it = children[node].find(token);
+      if (it == children[node].end()) {
+        const int next = static_cast<int>(children.size());
+        children[node].emplace(token, next);
+        children.emplace_back();
+        token_score.push_back(scores[i]);
+        is_end.push_back(false);
+        node = next;
+      } else {
+        node = it->second;
+        token_score[node] = std::max(token_score[node], scores[i]);
+      }
+    }
+    is_end[node] = true;
+  }
+
+  const int num_nodes = static_cast<int>(children.size());
+  child_begin_.assign(num_nodes + 1, 0);
+  for (int node = 0; node < num_nodes; ++node) {
+    child_begin_[node + 1] =
+        child_begin_[node] + static_cast<int>(children[node].size());
+    for (const auto& [token, next] : children[node]) {
+      child_token_.push_back(token);
+      child_node_.push_back(next);
+    }
+  }
+
+  // the failure links and scores, in breadth-first order so that the nodes
+  // of the failure path of a node come before it.
+  fail_.assign(num_nodes, 0);
+  node_score_.assign(num_nodes, 0.f);
+  output_score_.assign(num_nodes, 0.f);
+  std::vector<int> queue{0};
+  for (size_t head = 0; head < queue.size(); ++head) {
+    const int node = queue[head];
+    for (const auto& [token, next] : children[node]) {
+      int f = node == 0 ? -1 : fail_[node];
+      while (f > 0 && child(f, token) < 0) {
+        f = fail_[f];
+      }
+      fail_[next] = f < 0 ? 0 : std::max(child(f, token), 0);
+      node_score_[next] = node_score_[node] + token_score[next];
+      output_score_[next] =
+          (is_end[next] ? node_score_[next] : 0.f) + output_score_[fail_[next]];
+      queue.push_back(next);
+    }
+  }
+}
+
+int HotwordTrie::child(int node, int token) const {
+  const auto begin = child_token_.begin() + child_begin_[node];
+  const auto end = child_token_.begin() + child_begin_[node + 1];
+  const auto it = std::lower_bound(begin, end, token);
+  if (it == end || *it != token) {
+    return -1;
+  }
+  return child_node_[it - child_token_.begin()];
+}
+
+bool HotwordTrie::has_token(int token) const {
+  return std::find(child_token_.begin(), child_token_.end(), token) !=
+      child_token_.end();
+}
+
+std::pair<int, float> HotwordTrie::forward(int node, int token) const {
+  int next = child(node, token);
+  for (int f = node; next < 0 && f != 0;) {
+    f = fail_[f];
+    next = child(f, token);
+  }
+  next = std::max(next, 0);
+  return {
+      next, node_score_[next] - node_score_[node] + output_score_[next]};
+}
+
+std::vector<float> HotwordTrie::root_bonus(int vocab_size) const {
+  std::vector<float> bonus(vocab_size, 0.f);
+  for (int i = child_begin_[0]; i < child_begin_[1]; ++i) {
+    const int next = child_node_[i];
+    if (child_token_[i] < vocab_size) {
+      bonus[child_token_[i]] = node_score_[next] + output_score_[next];
+    }
+  }
+  return bonus;
+}
+
+void HotwordTrie::add_bonus(
+    int node,
+    const float* root_bonus,
+    int vocab_size,
+    float* row,
+    std::vector<char>& seen) const {
+  // the tokens which are not children of the failure path of node go back
+  // to the root.
+  const float base = -node_score_[node];
+  for (int token = 0; token < vocab_size; ++token) {
+    row[token] += root_bonus[token] + base;
+  }
+  // the other ones continue the match at the first node of the failure path
+  // which has them as children.
+  for (int f = node; f != 0; f = fail_[f]) {
+    for (int i = child_begin_[f]; i < child_begin_[f + 1]; ++i) {
+      const int token = child_token_[i];
+      const int next = child_node_[i];
+      if (seen[token]) {
+        continue;
+      }
+      seen[token] = 1;
+      row[token] += node_score_[next] + output_score_[next] - root_bonus[token];
+    }
+  }
+  for (int f = node; f != 0; f = fail_[f]) {
+    for (int i = child_begin_[f]; i < child_begin_[f + 1]; ++i) {
+      seen[child_token_[i]] = 0;
+    }
+  }
+}
+
+} // namespace cpu
+} // namespace cu_ctc
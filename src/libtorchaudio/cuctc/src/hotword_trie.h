@@ -0,0 +1,76 @@
+// Token-level trie of hotwords, to bias the CTC prefix beam search.
+//
+// Every node has the bonus of its token, the maximum bonus of the hotwords
+// going through it. A beam keeps the node of the longest suffix of its
+// prefix that is a prefix of a hotword, and extending the beam with a token
+// moves it along the trie, with Aho-Corasick failure links when the token
+// does not continue the match:
+//   - the bonus of a matched token is added to the beam,
+//   - when a match fails, the bonus of its tokens is taken back,
+//   - when a hotword is completed, its bonus is added once more, so that
+//     it is kept when the match moves on.
+// At the end, the bonus of the unfinished match is taken back.
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace cu_ctc {
+namespace cpu {
+
+class HotwordTrie {
+ public:
+  HotwordTrie();
+  // hotwords: token sequences of the hotwords.
+  // scores: bonus of every token of each hotword.
+  HotwordTrie(
+      const std::vector<std::vector<int>>& hotwords,
+      const std::vector<float>& scores);
+
+  bool empty() const {
+    return fail_.size() <= 1;
+  }
+  int max_token() const {
+    return max_token_;
+  }
+  bool has_token(int token) const;
+  // bonus of the unfinished match at node.
+  float node_score(int node) const {
+    return node_score_[node];
+  }
+
+  // Returns the node and the bonus of extending the match at node with
+  // token.
+  std::pair<int, float> forward(int node, int token) const;
+
+  // Adds the bonus of extending the match at node to row[0, vocab_size).
+  // root_bonus: (vocab_size, ) bonus of extending the root, from
+  //   root_bonus().
+  // seen: (vocab_size, ) scratch buffer of zeros, left as is.
+  void add_bonus(
+      int node,
+      const float* root_bonus,
+      int vocab_size,
+      float* row,
+      std::vector<char>& seen) const;
+  std::vector<float> root_bonus(int vocab_size) const;
+
+ private:
+  int child(int node, int token) const;
+
+  // children of node n, sorted by token, are
+  // [child_begin_[n], child_begin_[n + 1]) of child_token_ and child_node_.
+  std::vector<int> child_begin_;
+  std::vector<int> child_token_;
+  std::vector<int> child_node_;
+  std::vector<int> fail_;
+  // sum of the token bonuses from the root.
+  std::vector<float> node_score_;
+  // bonus of the hotwords ending at the node or at a node of its failure
+  // path.
+  std::vector<float> output_score_;
+  int max_token_ = -1;
+};
+
+} // namespace cpu
+} // namespace cu_ctc
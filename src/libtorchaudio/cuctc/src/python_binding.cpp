@@ -28,49 +28,26 @@
 #include <tuple>
 #include <utility>
 #include <vector>
+#include "include/ctc_prefix_decoder_cpu.h"
+#ifdef USE_CUDA
 #include "include/ctc_prefix_decoder.h"
+#endif
 namespace py = pybind11;
 
-std::tuple<size_t, std::vector<std::vector<std::pair<float, std::vector<int>>>>>
-ctc_prefix_decoder_batch_wrapper(
-    std::uintptr_t n_inter_data,
-    std::uintptr_t buff_ptr,
-    size_t buff_size,
-    std::uintptr_t pp,
-    std::uintptr_t seq_len_ptr,
-    const std::vector<int>& pp_sizes,
-    const std::vector<int>& pp_strides,
+using SCORE_TYPE = std::vector<std::vector<std::pair<float, std::vector<int>>>>;
+
+// Converts the (batch_size, beam, max_len) beam lists, their lengths and
+// their scores written by write_fn to lists of (score, tokens).
+template <typename WriteFn>
+SCORE_TYPE get_score_hyps(
+    int batch_size,
     int beam,
-    int blid,
-    int spid,
-    float thresold) {
-  using SCORE_TYPE =
-      std::vector<std::vector<std::pair<float, std::vector<int>>>>;
-  cu_ctc::InternalData* inter_data = (cu_ctc::InternalData*)(n_inter_data);
-  auto [require_size, max_select_seq_len] =
-      cu_ctc::calculate_require_buff_and_init_internal_data(
-          inter_data,
-          pp_sizes[0],
-          pp_sizes[1],
-          pp_sizes[2],
-          beam,
-          buff_ptr,
-          buff_size,
-          (float*)pp,
-          (int*)seq_len_ptr,
-          pp_sizes,
-          pp_strides,
-          blid,
-          thresold);
-  if (require_size > 0) {
-    return std::make_tuple(require_size, SCORE_TYPE{});
-  }
-  int batch_size = pp_sizes[0];
-  std::vector<int> list_data(batch_size * beam * max_select_seq_len);
+    int max_len,
+    WriteFn write_fn) {
+  std::vector<int> list_data(batch_size * beam * max_len);
   std::vector<int> len_data(batch_size * beam);
   std::vector<float> score(batch_size * beam);
-  cu_ctc::ctc_beam_search_decoder_batch_gpu(
-      inter_data, blid, spid, list_data.data(), len_data.data(), score.data());
+  write_fn(list_data.data(), len_data.data(), score.data());
   SCORE_TYPE score_hyps{};
   score_hyps.reserve(batch_size);
   for (int b = 0; b < batch_size; b++) {
@@ -78,22 +55,302 @@ ctc_prefix_decoder_batch_wrapper(
     score_hyps.back().reserve(beam);
     for (int beam_id = 0; beam_id < beam; beam_id++) {
       int len = len_data[b * beam + beam_id];
-      int offset = b * beam * max_select_seq_len + beam_id * max_select_seq_len;
+      int offset = b * beam * max_len + beam_id * max_len;
       std::vector<int> clist(
           list_data.data() + offset, list_data.data() + offset + len);
       score_hyps.back().push_back(
           std::pair{score[b * beam + beam_id], std::move(clist)});
     }
   }
-  return std::make_tuple(require_size, std::move(score_hyps));
+  return score_hyps;
+}
+
+// Runs the CUDA decoder with the buffer protocol of
+// calculate_require_buff_and_init_internal_data.
+template <typename InternalData, typename InitFn, typename DecodeFn>
+std::tuple<size_t, SCORE_TYPE> ctc_prefix_decoder_batch(
+    InitFn init_fn,
+    DecodeFn decode_fn,
+    std::uintptr_t n_inter_data,
+    std::uintptr_t buff_ptr,
+    size_t buff_size,
+    std::uintptr_t pp,
+    std::uintptr_t seq_len_ptr,
+    const std::vector<int>& pp_sizes,
+    const std::vector<int>& pp_strides,
+    int beam,
+    int blid,
+    int spid,
+    float thresold) {
+  InternalData* inter_data = (InternalData*)(n_inter_data);
+  auto [require_size, max_select_seq_len] = init_fn(
+      inter_data,
+      pp_sizes[0],
+      pp_sizes[1],
+      pp_sizes[2],
+      beam,
+      buff_ptr,
+      buff_size,
+      (float*)pp,
+      (int*)seq_len_ptr,
+      pp_sizes,
+      pp_strides,
+      blid,
+      thresold);
+  if (require_size > 0) {
+    return std::make_tuple(require_size, SCORE_TYPE{});
+  }
+  return std::make_tuple(
+      require_size,
+      get_score_hyps(
+          pp_sizes[0],
+          beam,
+          max_select_seq_len,
+          [&](int* clist, int* clen, float* score) {
+            decode_fn(inter_data, blid, spid, clist, clen, score);
+          }));
+}
+
+// Runs one of the decoders with the workspace it keeps across batches, see
+// init_internal_data_with_workspace.
+template <typename InternalData, typename InitFn, typename DecodeFn>
+SCORE_TYPE ctc_prefix_decoder_batch_with_workspace(
+    InitFn init_fn,
+    DecodeFn decode_fn,
+    std::uintptr_t n_inter_data,
+    std::uintptr_t pp,
+    std::uintptr_t seq_len_ptr,
+    const std::vector<int>& pp_sizes,
+    const std::vector<int>& pp_strides,
+    int beam,
+    int blid,
+    int spid,
+    float thresold) {
+  InternalData* inter_data = (InternalData*)(n_inter_data);
+  const int max_select_seq_len = init_fn(
+      inter_data,
+      pp_sizes[0],
+      pp_sizes[1],
+      pp_sizes[2],
+      beam,
+      (float*)pp,
+      (int*)seq_len_ptr,
+      pp_sizes,
+      pp_strides,
+      blid,
+      thresold);
+  return get_score_hyps(
+      pp_sizes[0],
+      beam,
+      max_select_seq_len,
+      [&](int* clist, int* clen, float* score) {
+        decode_fn(inter_data, blid, spid, clist, clen, score);
+      });
+}
+
+// (capacity in bytes, reallocations, calls) of the workspace.
+std::tuple<size_t, int64_t, int64_t> workspace_stats_tuple(
+    const cu_ctc::WorkspaceStats& stats) {
+  return std::make_tuple(stats.capacity, stats.reallocations, stats.calls);
+}
+
+#ifdef USE_CUDA
+std::tuple<size_t, SCORE_TYPE> ctc_prefix_decoder_batch_wrapper(
+    std::uintptr_t n_inter_data,
+    std::uintptr_t buff_ptr,
+    size_t buff_size,
+    std::uintptr_t pp,
+    std::uintptr_t seq_len_ptr,
+    const std::vector<int>& pp_sizes,
+    const std::vector<int>& pp_strides,
+    int beam,
+    int blid,
+    int spid,
+    float thresold) {
+  return ctc_prefix_decoder_batch<cu_ctc::InternalData>(
+      &cu_ctc::calculate_require_buff_and_init_internal_data,
+      &cu_ctc::ctc_beam_search_decoder_batch_gpu,
+      n_inter_data,
+      buff_ptr,
+      buff_size,
+      pp,
+      seq_len_ptr,
+      pp_sizes,
+      pp_strides,
+      beam,
+      blid,
+      spid,
+      thresold);
+}
+
+SCORE_TYPE ctc_prefix_decoder_batch_workspace_wrapper(
+    std::uintptr_t n_inter_data,
+    std::uintptr_t pp,
+    std::uintptr_t seq_len_ptr,
+    const std::vector<int>& pp_sizes,
+    const std::vector<int>& pp_strides,
+    int beam,
+    int blid,
+    int spid,
+    float thresold) {
+  return ctc_prefix_decoder_batch_with_workspace<cu_ctc::InternalData>(
+      &cu_ctc::init_internal_data_with_workspace,
+      &cu_ctc::ctc_beam_search_decoder_batch_gpu,
+      n_inter_data,
+      pp,
+      seq_len_ptr,
+      pp_sizes,
+      pp_strides,
+      beam,
+      blid,
+      spid,
+      thresold);
+}
+
+std::tuple<size_t, int64_t, int64_t> workspace_stats_wrapper(
+    std::uintptr_t n_inter_data) {
+  return workspace_stats_tuple(cu_ctc::prefixCTC_workspace_stats(
+      (cu_ctc::InternalData*)(n_inter_data)));
+}
+#endif
+
+SCORE_TYPE ctc_prefix_decoder_batch_workspace_cpu_wrapper(
+    std::uintptr_t n_inter_data,
+    std::uintptr_t pp,
+    std::uintptr_t seq_len_ptr,
+    const std::vector<int>& pp_sizes,
+    const std::vector<int>& pp_strides,
+    int beam,
+    int blid,
+    int spid,
+    float thresold) {
+  return ctc_prefix_decoder_batch_with_workspace<cu_ctc::cpu::InternalData>(
+      &cu_ctc::cpu::init_internal_data_with_workspace,
+      &cu_ctc::cpu::ctc_beam_search_decoder_batch_cpu,
+      n_inter_data,
+      pp,
+      seq_len_ptr,
+      pp_sizes,
+      pp_strides,
+      beam,
+      blid,
+      spid,
+      thresold);
+}
+
+std::tuple<size_t, int64_t, int64_t> workspace_stats_cpu_wrapper(
+    std::uintptr_t n_inter_data) {
+  return workspace_stats_tuple(cu_ctc::cpu::prefixCTC_workspace_stats(
+      (cu_ctc::cpu::InternalData*)(n_inter_data)));
+}
+
+void ctc_prefix_decoder_begin_cpu_wrapper(
+    std::uintptr_t n_inter_data,
+    int batch_size,
+    int vocab_size,
+    int beam,
+    int blid,
+    int spid,
+    float thresold) {
+  cu_ctc::cpu::ctc_beam_search_begin(
+      (cu_ctc::cpu::InternalData*)(n_inter_data),
+      batch_size,
+      vocab_size,
+      beam,
+      blid,
+      spid,
+      thresold);
+}
+
+void ctc_prefix_decoder_step_cpu_wrapper(
+    std::uintptr_t n_inter_data,
+    std::uintptr_t pp,
+    std::uintptr_t seq_len_ptr,
+    const std::vector<int>& pp_sizes,
+    const std::vector<int>& pp_strides) {
+  cu_ctc::cpu::ctc_beam_search_step(
+      (cu_ctc::cpu::InternalData*)(n_inter_data),
+      (float*)pp,
+      (int*)seq_len_ptr,
+      pp_sizes,
+      pp_strides);
+}
+
+SCORE_TYPE ctc_prefix_decoder_beams_cpu_wrapper(
+    std::uintptr_t n_inter_data,
+    int batch_size,
+    int beam,
+    bool finalize) {
+  auto* inter_data = (cu_ctc::cpu::InternalData*)(n_inter_data);
+  const int max_len = cu_ctc::cpu::ctc_beam_search_max_len(inter_data);
+  return get_score_hyps(
+      batch_size, beam, max_len, [&](int* clist, int* clen, float* score) {
+        if (finalize) {
+          cu_ctc::cpu::ctc_beam_search_finalize(
+              inter_data, max_len, clist, clen, score);
+        } else {
+          cu_ctc::cpu::ctc_beam_search_partial(
+              inter_data, max_len, clist, clen, score);
+        }
+      });
+}
+
+void ctc_prefix_decoder_set_hotwords_cpu_wrapper(
+    std::uintptr_t n_inter_data,
+    const std::vector<std::vector<int>>& hotwords,
+    const std::vector<float>& scores) {
+  cu_ctc::cpu::ctc_beam_search_set_hotwords(
+      (cu_ctc::cpu::InternalData*)(n_inter_data), hotwords, scores);
 }
 
 PYBIND11_MODULE(pybind11_prefixctc, m) {
   m.doc() = "none";
+#ifdef USE_CUDA
   m.def(
       "ctc_beam_search_decoder_batch_gpu_v2",
       &ctc_prefix_decoder_batch_wrapper,
       "ctc prefix decoder  v2 computing on GPU");
   m.def("prefixCTC_alloc", &cu_ctc::prefixCTC_alloc, "allocate internal data");
+  m.def(
+      "ctc_beam_search_decoder_batch_gpu_workspace",
+      &ctc_prefix_decoder_batch_workspace_wrapper,
+      "ctc prefix decoder v2 computing on GPU with its own workspace");
   m.def("prefixCTC_free", &cu_ctc::prefixCTC_free, "free internal data");
+  m.def(
+      "prefixCTC_workspace_stats",
+      &workspace_stats_wrapper,
+      "capacity, reallocations and calls of the workspace");
+#endif
+  m.def(
+      "ctc_beam_search_decoder_batch_cpu_workspace",
+      &ctc_prefix_decoder_batch_workspace_cpu_wrapper,
+      "ctc prefix decoder computing on CPU with its own workspace");
+  m.def(
+      "ctc_beam_search_begin_cpu",
+      &ctc_prefix_decoder_begin_cpu_wrapper,
+      "start decoding a stream on CPU");
+  m.def(
+      "ctc_beam_search_step_cpu",
+      &ctc_prefix_decoder_step_cpu_wrapper,
+      "decode the next chunk of the stream on CPU");
+  m.def(
+      "ctc_beam_search_beams_cpu",
+      &ctc_prefix_decoder_beams_cpu_wrapper,
+      "beams of the stream so far, and end the stream if finalize");
+  m.def(
+      "ctc_beam_search_set_hotwords_cpu",
+      &ctc_prefix_decoder_set_hotwords_cpu_wrapper,
+      "bias the CPU decoder towards hotwords");
+  m.def(
+      "prefixCTC_alloc_cpu",
+      &cu_ctc::cpu::prefixCTC_alloc,
+      "allocate internal data of the CPU decoder");
+  m.def(
+      "prefixCTC_free_cpu",
+      &cu_ctc::cpu::prefixCTC_free,
+      "free internal data of the CPU decoder");
+  m.def(
+      "prefixCTC_workspace_stats_cpu",
+      &workspace_stats_cpu_wrapper,
+      "capacity, reallocations and calls of the CPU decoder memory");
 }
@@ -6,14 +6,25 @@ std::tuple<torch::Tensor, torch::Tensor> forced_align(
     const torch::Tensor& targets,
     const torch::Tensor& inputLengths,
     const torch::Tensor& targetLengths,
-    const int64_t blank) {
+    const int64_t blank,
+    const int64_t max_backpointer_bytes) {
   static auto op = torch::Dispatcher::singleton()
                        .findSchemaOrThrow("torchaudio::forced_align", "")
                        .typed<decltype(forced_align)>();
-  return op.call(logProbs, targets, inputLengths, targetLengths, blank);
+  return op.call(
+      logProbs,
+      targets,
+      inputLengths,
+      targetLengths,
+      blank,
+      max_backpointer_bytes);
 }
 
 TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
   m.def(
-      "forced_align(Tensor log_probs, Tensor targets, Tensor input_lengths, Tensor target_lengths, int blank) -> (Tensor, Tensor)");
+      "forced_align(Tensor log_probs, Tensor targets, Tensor input_lengths, Tensor target_lengths, int blank, int max_backpointer_bytes=1073741824) -> (Tensor, Tensor)");
+  m.def(
+      "forced_align_windowed(Tensor log_probs, Tensor targets, int blank, int window_size, int overlap, float anchor_log_prob, int anchor_length) -> (Tensor, Tensor, Tensor)");
+  m.def(
+      "merge_tokens(Tensor tokens, Tensor scores, int blank) -> (Tensor, Tensor, Tensor, Tensor)");
 }
@@ -7,4 +7,5 @@ std::tuple<torch::Tensor, torch::Tensor> forced_align(
     const torch::Tensor& targets,
     const torch::Tensor& inputLengths,
     const torch::Tensor& targetLengths,
-    const int64_t blank);
+    const int64_t blank,
+    const int64_t max_backpointer_bytes = 1 << 30);
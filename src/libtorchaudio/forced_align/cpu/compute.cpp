@@ -10,57 +10,105 @@ using namespace std;
 namespace torchaudio {
 namespace alignment {
 namespace cpu {
-// Inspired from
-// https://github.com/flashlight/sequence/blob/main/flashlight/lib/sequence/criterion/cpu/ConnectionistTemporalClassificationCriterion.cpp
-template <typename scalar_t, at::ScalarType target_scalar_type>
-void forced_align_impl(
-    const torch::Tensor& logProbs,
-    const torch::Tensor& targets,
-    const int64_t blank,
-    torch::Tensor& paths) {
-  const scalar_t kNegInfinity = -std::numeric_limits<scalar_t>::infinity();
-  using target_t = typename std::
-      conditional<target_scalar_type == torch::kInt, int, int64_t>::type;
-  const auto batchIndex =
-      0; // TODO: support batch version and use the real batch index
-  const auto T = logProbs.size(1);
-  const auto L = targets.size(1);
-  const auto S = 2 * L + 1;
 
-  auto alphas_a = new scalar_t[2 * S]; // scalar_t is just logProbs.dtype()
-  for (int i = 0; i < 2 * S; i++) {
-    alphas_a[i] = kNegInfinity;
+// Scratch buffers of the alignment of one utterance. A workspace is owned by
+// the thread aligning a chunk of the batch and is reused across the
+// utterances of the chunk, so it only grows when a longer utterance comes in.
+template <typename scalar_t>
+struct Workspace {
+  std::vector<scalar_t> alphas;
+  std::vector<int8_t> backPtr;
+  // checkpointed alignment only: alphas and bands of the frame preceding
+  // each segment.
+  std::vector<scalar_t> checkpoints;
+  std::vector<int64_t> bands;
+  // per state: label, penalty of the transition skipping the previous blank
+  // (0 or -inf), and emission at the current frame.
+  std::vector<int64_t> labels;
+  std::vector<scalar_t> skips;
+  std::vector<scalar_t> emissions;
+
+  // alphas of 2 frames, and back-pointers of numFrames frames.
+  void reset(int64_t numFrames, int64_t S) {
+    if (alphas.size() < size_t(2 * S)) {
+      alphas.resize(2 * S);
+    }
+    if (backPtr.size() < size_t(numFrames * S)) {
+      backPtr.resize(numFrames * S);
+    }
+    std::fill(
+        alphas.begin(),
+        alphas.begin() + 2 * S,
+        -std::numeric_limits<scalar_t>::infinity());
+    std::fill(backPtr.begin(), backPtr.begin() + numFrames * S, -1);
   }
 
-  auto backPtr_a = new int8_t[T * S];
-  for (int i = 0; i < T * S; i++) {
-    backPtr_a[i] = -1;
+  void resetStates(int64_t S) {
+    if (labels.size() < size_t(S)) {
+      labels.resize(S);
+      skips.resize(S);
+      emissions.resize(S);
+    }
   }
 
-  auto logProbs_a = logProbs.accessor<scalar_t, 3>();
-  auto targets_a = targets.accessor<target_t, 2>();
-  auto paths_a = paths.accessor<target_t, 2>();
-  auto R = 0;
-  for (auto i = 1; i < L; i++) {
-    if (targets_a[batchIndex][i] == targets_a[batchIndex][i - 1]) {
-      ++R;
+  void resetCheckpoints(int64_t numSegments, int64_t S) {
+    if (checkpoints.size() < size_t(numSegments * S)) {
+      checkpoints.resize(numSegments * S);
+    }
+    if (bands.size() < size_t(2 * numSegments)) {
+      bands.resize(2 * numSegments);
     }
   }
-  TORCH_CHECK(
-      T >= L + R,
-      "targets length is too long for CTC. Found log_probs length: ",
-      T,
-      ", targets length: ",
-      L,
-      ", and number of repeats: ",
-      R);
-  auto start = T - (L + R) > 0 ? 0 : 1;
-  auto end = (S == 1) ? 1 : 2;
-  for (auto i = start; i < end; i++) {
-    auto labelIdx = (i % 2 == 0) ? blank : targets_a[batchIndex][i / 2];
-    alphas_a[i] = logProbs_a[batchIndex][0][labelIdx]; // alphas_a[0, i]
+};
+
+// CTC trellis of one utterance, computed one frame at a time. At frame t,
+// only the band [start, end) of the states that are reachable from the
+// first frame, and from which the last frame is reachable, is computed.
+//
+// The labels of the states and whether they can skip the previous blank
+// are computed once per utterance, so that the recursion over the band is
+// a branch-free loop over contiguous arrays, which the compiler vectorizes.
+//
+// Inspired from
+// https://github.com/flashlight/sequence/blob/main/flashlight/lib/sequence/criterion/cpu/ConnectionistTemporalClassificationCriterion.cpp
+template <typename scalar_t, typename target_t>
+struct Trellis {
+  const at::TensorAccessor<scalar_t, 3>& logProbs_a;
+  const at::TensorAccessor<target_t, 2>& targets_a;
+  const int64_t batchIndex;
+  const int64_t T;
+  const int64_t L;
+  const int64_t S;
+  const int64_t R; // number of repeats in the targets.
+  const int64_t blank;
+  const int64_t* labels_a; // (S, )
+  const scalar_t* skips_a; // (S, )
+  scalar_t* emissions_a; // (S, ) scratch.
+
+  int64_t label(int64_t i) const {
+    return labels_a[i];
   }
-  for (auto t = 1; t < T; t++) {
+
+  // alphas of frame 0.
+  void init(int64_t& start, int64_t& end, scalar_t* alphas_a) const {
+    std::fill(
+        alphas_a, alphas_a + S, -std::numeric_limits<scalar_t>::infinity());
+    start = T - (L + R) > 0 ? 0 : 1;
+    end = (S == 1) ? 1 : 2;
+    for (auto i = start; i < end; i++) {
+      alphas_a[i] = logProbs_a[batchIndex][0][label(i)]; // alphas_a[0, i]
+    }
+  }
+
+  // alphas and back-pointers of frame t, from the alphas of frame t - 1.
+  // start and end are updated from the band of frame t - 1.
+  void step(
+      int64_t t,
+      int64_t& start,
+      int64_t& end,
+      const scalar_t* prevAlphas_a,
+      scalar_t* curAlphas_a,
+      int8_t* backPtr_a) const {
     if (T - t <= L + R) {
       if ((start % 2 == 1) &&
           targets_a[batchIndex][start / 2] !=
@@ -77,59 +125,273 @@ void forced_align_impl(
       }
       end = end + 1;
     }
+    const scalar_t* logProbsRow_a = logProbs_a[batchIndex][t].data();
     auto startloop = start;
-    auto curIdxOffset = t % 2;
-    auto prevIdxOffset = (t - 1) % 2;
-    for (auto j = 0; j < S; ++j) {
-      alphas_a[curIdxOffset * S + j] = -std::numeric_limits<scalar_t>::infinity(); // alphas_a[curIdxOffset][j]
-    }
+    std::fill(
+        curAlphas_a,
+        curAlphas_a + S,
+        -std::numeric_limits<scalar_t>::infinity());
     if (start == 0) {
-      alphas_a[curIdxOffset * S] =
-          alphas_a[prevIdxOffset * S] + logProbs_a[batchIndex][t][blank]; // alphas_a[curIdxOffset][0]
-      backPtr_a[S * t] = 0; // backPtr_a[t][0] = 0
+      curAlphas_a[0] = prevAlphas_a[0] + logProbsRow_a[blank];
+      backPtr_a[0] = 0;
+      startloop += 1;
+    }
+    if (startloop == 1 && end > 1) { // the first label cannot skip.
+      auto x0 = prevAlphas_a[1];
+      auto x1 = prevAlphas_a[0];
+      curAlphas_a[1] = (x1 > x0 ? x1 : x0) + logProbsRow_a[label(1)];
+      backPtr_a[1] = x1 > x0 ? 1 : 0;
       startloop += 1;
     }
 
+    // members are read once: otherwise, as the stores below may alias them,
+    // they would be reloaded at every state and the loop not vectorized.
+    const int64_t* labels = labels_a;
+    const scalar_t* skips = skips_a;
+    scalar_t* emissions = emissions_a;
     for (auto i = startloop; i < end; i++) {
-      auto x0 = alphas_a[prevIdxOffset * S + i]; // alphas_a[prevIdxOffset][i];
-      auto x1 = alphas_a[prevIdxOffset * S + i - 1]; // alphas_a[prevIdxOffset][i - 1];
-      auto x2 = -std::numeric_limits<scalar_t>::infinity();
-
-      auto labelIdx = (i % 2 == 0) ? blank : targets_a[batchIndex][i / 2];
-
+      emissions[i] = logProbsRow_a[labels[i]];
+    }
+    for (auto i = startloop; i < end; i++) {
+      auto x0 = prevAlphas_a[i];
+      auto x1 = prevAlphas_a[i - 1];
       // In CTC, the optimal path may optionally chose to skip a blank label.
-      // x2 represents skipping a letter, and can only happen if we're not
-      // currently on a blank_label, and we're not on a repeat letter
-      // (i != 1) just ensures we don't access targets[i - 2] if its i < 2
-      if (i % 2 != 0 && i != 1 &&
-          targets_a[batchIndex][i / 2] != targets_a[batchIndex][i / 2 - 1]) {
-        x2 = alphas_a[prevIdxOffset * S + i - 2]; // alphas_a[prevIdxOffset][i - 2];
-      }
-      scalar_t result = 0.0;
-      if (x2 > x1 && x2 > x0) {
-        result = x2;
-        backPtr_a[t * S + i] = 2; // backPtr_a[t][i] = 2
-      } else if (x1 > x0 && x1 > x2) {
-        result = x1;
-        backPtr_a[t * S + i] = 1; // backPtr_a[t][i] = 1
-      } else {
-        result = x0;
-        backPtr_a[t * S + i] = 0; // backPtr_a[t][i] = 0
-      }
-      alphas_a[curIdxOffset * S + i] = result + logProbs_a[batchIndex][t][labelIdx]; // alphas_a[curIdxOffset][i]
+      // x2 represents skipping a letter, and is -inf if we're currently on a
+      // blank_label, or on a repeat letter.
+      auto x2 = prevAlphas_a[i - 2] + skips[i];
+      const bool from2 = (x2 > x1) & (x2 > x0);
+      const bool from1 = !from2 & (x1 > x0) & (x1 > x2);
+      backPtr_a[i] = static_cast<int8_t>(2 * from2 + from1);
+      curAlphas_a[i] = (from2 ? x2 : (from1 ? x1 : x0)) + emissions[i];
     }
   }
-  auto idx1 = (T - 1) % 2;
-  auto ltrIdx = alphas_a[S * idx1 + S - 1] >
-    alphas_a[S * idx1 + S - 2] ? S - 1 : S - 2; // alphas_a[idx1][S - 1], alphas_a[idx1][S - 2]
-  delete[] alphas_a;
+
+  // label of state i at frame t in the path, and its log prob.
+  void record(
+      int64_t t,
+      int64_t i,
+      at::TensorAccessor<target_t, 2>& paths_a,
+      at::TensorAccessor<scalar_t, 2>& scores_a) const {
+    paths_a[batchIndex][t] = labels_a[i];
+    scores_a[batchIndex][t] = logProbs_a[batchIndex][t][labels_a[i]];
+  }
+
+  // state of the last frame the path ends in: the last blank or target.
+  int64_t last(const scalar_t* alphas_a) const {
+    return (S == 1 || alphas_a[S - 1] > alphas_a[S - 2]) ? S - 1 : S - 2;
+  }
+};
+
+// Keeps the back-pointers of every frame: T * S bytes.
+template <typename scalar_t, typename target_t>
+void align_full(
+    const Trellis<scalar_t, target_t>& trellis,
+    Workspace<scalar_t>& workspace,
+    at::TensorAccessor<target_t, 2>& paths_a,
+    at::TensorAccessor<scalar_t, 2>& scores_a) {
+  const auto T = trellis.T;
+  const auto S = trellis.S;
+  workspace.reset(T, S);
+  auto alphas_a = workspace.alphas.data(); // scalar_t is logProbs.dtype()
+  auto backPtr_a = workspace.backPtr.data();
+
+  int64_t start, end;
+  trellis.init(start, end, alphas_a);
+  for (auto t = 1; t < T; t++) {
+    trellis.step(
+        t,
+        start,
+        end,
+        alphas_a + ((t - 1) % 2) * S,
+        alphas_a + (t % 2) * S,
+        backPtr_a + t * S);
+  }
+  auto ltrIdx = trellis.last(alphas_a + ((T - 1) % 2) * S);
   // path stores the token index for each time step after force alignment.
   for (auto t = T - 1; t > -1; t--) {
-    auto lbl_idx = ltrIdx % 2 == 0 ? blank : targets_a[batchIndex][ltrIdx / 2];
-    paths_a[batchIndex][t] = lbl_idx;
+    trellis.record(t, ltrIdx, paths_a, scores_a);
     ltrIdx -= backPtr_a[t * S + ltrIdx]; // backPtr_a[t][ltrIdx]
   }
-  delete[] backPtr_a;
+}
+
+// Keeps the alphas of the frame preceding each segment of K = ceil(sqrt(T))
+// frames, and recomputes the back-pointers of one segment at a time while
+// backtracking. Takes O(sqrt(T) * S) memory for about twice the compute of
+// align_full.
+template <typename scalar_t, typename target_t>
+void align_checkpointed(
+    const Trellis<scalar_t, target_t>& trellis,
+    Workspace<scalar_t>& workspace,
+    at::TensorAccessor<target_t, 2>& paths_a,
+    at::TensorAccessor<scalar_t, 2>& scores_a) {
+  const auto T = trellis.T;
+  const auto S = trellis.S;
+  const auto K = static_cast<int64_t>(std::ceil(std::sqrt(double(T))));
+  const auto numSegments = (T + K - 1) / K;
+  workspace.reset(K, S);
+  workspace.resetCheckpoints(numSegments, S);
+  auto alphas_a = workspace.alphas.data();
+  auto backPtr_a = workspace.backPtr.data();
+  auto checkpoints_a = workspace.checkpoints.data();
+  auto bands_a = workspace.bands.data();
+
+  // forward pass: back-pointers are discarded.
+  int64_t start, end;
+  trellis.init(start, end, alphas_a);
+  for (auto t = 1; t < T; t++) {
+    const scalar_t* prevAlphas_a = alphas_a + ((t - 1) % 2) * S;
+    if (t % K == 0) {
+      std::copy(
+          prevAlphas_a, prevAlphas_a + S, checkpoints_a + (t / K) * S);
+      bands_a[2 * (t / K)] = start;
+      bands_a[2 * (t / K) + 1] = end;
+    }
+    trellis.step(
+        t, start, end, prevAlphas_a, alphas_a + (t % 2) * S, backPtr_a);
+  }
+  auto ltrIdx = trellis.last(alphas_a + ((T - 1) % 2) * S);
+
+  // backward pass, from the last segment.
+  for (auto c = numSegments - 1; c > -1; c--) {
+    const auto tBegin = c * K;
+    const auto tEnd = std::min(T, tBegin + K);
+    scalar_t* rows[2] = {alphas_a, alphas_a + S};
+    int next = 0;
+    const scalar_t* prevAlphas_a = nullptr;
+    auto t = tBegin;
+    if (c == 0) {
+      trellis.init(start, end, rows[next]);
+      prevAlphas_a = rows[next];
+      next = 1 - next;
+      t = 1;
+    } else {
+      prevAlphas_a = checkpoints_a + c * S;
+      start = bands_a[2 * c];
+      end = bands_a[2 * c + 1];
+    }
+    for (; t < tEnd; t++) {
+      trellis.step(
+          t,
+          start,
+          end,
+          prevAlphas_a,
+          rows[next],
+          backPtr_a + (t - tBegin) * S);
+      prevAlphas_a = rows[next];
+      next = 1 - next;
+    }
+    for (t = tEnd - 1; t >= tBegin; t--) {
+      trellis.record(t, ltrIdx, paths_a, scores_a);
+      ltrIdx -= backPtr_a[(t - tBegin) * S + ltrIdx];
+    }
+  }
+}
+
+template <typename scalar_t, typename target_t>
+void forced_align_one_sequence(
+    const at::TensorAccessor<scalar_t, 3>& logProbs_a,
+    const at::TensorAccessor<target_t, 2>& targets_a,
+    const int64_t batchIndex,
+    const int64_t T,
+    const int64_t L,
+    const int64_t blank,
+    const int64_t maxBackPtrBytes,
+    Workspace<scalar_t>& workspace,
+    at::TensorAccessor<target_t, 2>& paths_a,
+    at::TensorAccessor<scalar_t, 2>& scores_a) {
+  const auto S = 2 * L + 1;
+
+  auto R = 0;
+  for (auto i = 1; i < L; i++) {
+    if (targets_a[batchIndex][i] == targets_a[batchIndex][i - 1]) {
+      ++R;
+    }
+  }
+  TORCH_CHECK(
+      T >= L + R,
+      "targets length is too long for CTC. Found log_probs length: ",
+      T,
+      ", targets length: ",
+      L,
+      ", and number of repeats: ",
+      R);
+
+  workspace.resetStates(S);
+  auto labels_a = workspace.labels.data();
+  auto skips_a = workspace.skips.data();
+  for (auto i = 0; i < S; i++) {
+    labels_a[i] = (i % 2 == 0) ? blank : targets_a[batchIndex][i / 2];
+    skips_a[i] = (i % 2 != 0 && i != 1 &&
+                  targets_a[batchIndex][i / 2] !=
+                      targets_a[batchIndex][i / 2 - 1])
+        ? scalar_t(0)
+        : -std::numeric_limits<scalar_t>::infinity();
+  }
+
+  const Trellis<scalar_t, target_t> trellis{
+      logProbs_a,
+      targets_a,
+      batchIndex,
+      T,
+      L,
+      S,
+      R,
+      blank,
+      labels_a,
+      skips_a,
+      workspace.emissions.data()};
+  if (T * S <= maxBackPtrBytes) {
+    align_full(trellis, workspace, paths_a, scores_a);
+  } else {
+    align_checkpointed(trellis, workspace, paths_a, scores_a);
+  }
+}
+
+template <typename scalar_t, at::ScalarType target_scalar_type>
+void forced_align_impl(
+    const torch::Tensor& logProbs,
+    const torch::Tensor& targets,
+    const torch::Tensor& inputLengths,
+    const torch::Tensor& targetLengths,
+    const int64_t blank,
+    const int64_t maxBackPtrBytes,
+    torch::Tensor& paths,
+    torch::Tensor& scores) {
+  using target_t = typename std::
+      conditional<target_scalar_type == torch::kInt, int, int64_t>::type;
+  const auto B = logProbs.size(0);
+  const auto maxT = logProbs.size(1);
+
+  auto logProbs_a = logProbs.accessor<scalar_t, 3>();
+  auto targets_a = targets.accessor<target_t, 2>();
+  auto paths_a = paths.accessor<target_t, 2>();
+  auto scores_a = scores.accessor<scalar_t, 2>();
+  auto inputLengths_a = inputLengths.accessor<int64_t, 1>();
+  auto targetLengths_a = targetLengths.accessor<int64_t, 1>();
+
+  // utterances are independent: each thread aligns a chunk of the batch.
+  at::parallel_for(0, B, 1, [&](int64_t begin, int64_t end) {
+    Workspace<scalar_t> workspace;
+    for (auto b = begin; b < end; ++b) {
+      const auto T = inputLengths_a[b];
+      forced_align_one_sequence<scalar_t, target_t>(
+          logProbs_a,
+          targets_a,
+          b,
+          T,
+          targetLengths_a[b],
+          blank,
+          maxBackPtrBytes,
+          workspace,
+          paths_a,
+          scores_a);
+      // frames past the end of the utterance are padded with blank, and
+      // scored 0.
+      for (auto t = T; t < maxT; t++) {
+        paths_a[b][t] = blank;
+      }
+    }
+  });
 }
 
 std::tuple<torch::Tensor, torch::Tensor> compute(
@@ -137,7 +399,8 @@ std::tuple<torch::Tensor, torch::Tensor> compute(
     const torch::Tensor& targets,
     const torch::Tensor& inputLengths,
     const torch::Tensor& targetLengths,
-    const int64_t blank) {
+    const int64_t blank,
+    const int64_t maxBackPtrBytes) {
   TORCH_CHECK(logProbs.is_cpu(), "log_probs must be a CPU tensor");
   TORCH_CHECK(targets.is_cpu(), "targets must be a CPU tensor");
   TORCH_CHECK(
@@ -163,14 +426,21 @@ std::tuple<torch::Tensor, torch::Tensor> compute(
   TORCH_CHECK(
       targetLengths.dim() == 1, "target_lengths must be 1-D (batch_size,)");
   TORCH_CHECK(
-      logProbs.size(0) == 1,
-      "The batch dimension for log_probs must be 1 at the current version.")
+      targets.size(0) == logProbs.size(0),
+      "batch dimension mismatch between log_probs and targets");
+  TORCH_CHECK(
+      inputLengths.size(0) == logProbs.size(0),
+      "batch dimension mismatch between log_probs and input_lengths");
   TORCH_CHECK(
-      targets.size(0) == 1,
-      "The batch dimension for targets must be 1 at the current version.")
+      targetLengths.size(0) == logProbs.size(0),
+      "batch dimension mismatch between log_probs and target_lengths");
   TORCH_CHECK(
       blank >= 0 && blank < logProbs.size(-1),
       "blank must be within [0, num classes)");
+  // utterances whose back-pointer table, T * (2 * L + 1) bytes, is larger
+  // than this are aligned with align_checkpointed.
+  TORCH_CHECK(
+      maxBackPtrBytes >= 0, "max_backpointer_bytes must be non-negative");
 
   TORCH_CHECK(
       logProbs.size(1) == at::max(inputLengths).item().toInt(),
@@ -179,32 +449,450 @@ std::tuple<torch::Tensor, torch::Tensor> compute(
       targets.size(1) == at::max(targetLengths).item().toInt(),
       "target length mismatch");
 
+  // lengths are read on the CPU, whatever their integer type.
+  const auto inputLengths64 = inputLengths.to(torch::kInt64).contiguous();
+  const auto targetLengths64 = targetLengths.to(torch::kInt64).contiguous();
+  TORCH_CHECK(
+      at::min(inputLengths64).item().toLong() > 0,
+      "input_lengths must be positive");
+  TORCH_CHECK(
+      at::min(targetLengths64).item().toLong() >= 0,
+      "target_lengths must be non-negative");
+
   const auto B = logProbs.size(0);
   const auto T = logProbs.size(1);
   auto paths = torch::zeros(
       {B, T},
       torch::TensorOptions().device(targets.device()).dtype(targets.dtype()));
+  // log probs of the labels of the paths, gathered while backtracking.
+  auto scores = torch::zeros({B, T}, logProbs.options());
   AT_DISPATCH_FLOATING_TYPES_AND_HALF(
       logProbs.scalar_type(), "forced_align_impl", [&] {
         if (targets.scalar_type() == torch::kInt64) {
           forced_align_impl<scalar_t, torch::kInt64>(
-              logProbs, targets, blank, paths);
+              logProbs,
+              targets,
+              inputLengths64,
+              targetLengths64,
+              blank,
+              maxBackPtrBytes,
+              paths,
+              scores);
         } else {
           forced_align_impl<scalar_t, torch::kInt32>(
-              logProbs, targets, blank, paths);
+              logProbs,
+              targets,
+              inputLengths64,
+              targetLengths64,
+              blank,
+              maxBackPtrBytes,
+              paths,
+              scores);
         }
       });
-  return std::make_tuple(
-      paths,
-      logProbs
-      );
+  return std::make_tuple(paths, scores);
+}
+
+// Size of the back-pointer table above which the segments of the windowed
+// alignment are aligned with align_checkpointed, as in forced_align.
+constexpr int64_t kMaxBackPtrBytes = int64_t(1) << 30;
+
+// Anchor of the windowed alignment: target token `token` is emitted from
+// frame `frame`. Segments between consecutive anchors are aligned
+// independently.
+struct Anchor {
+  int64_t frame;
+  int64_t token;
+  int64_t window; // window whose start boundary the anchor is at.
+};
+
+// Windowed alignment of a long utterance: the plan of its segments.
+template <typename scalar_t, typename target_t>
+struct WindowedPlan {
+  const at::TensorAccessor<scalar_t, 3>& logProbs_a;
+  const at::TensorAccessor<target_t, 2>& targets_a;
+  const int64_t T;
+  const int64_t L;
+  const int64_t C;
+  const int64_t blank;
+  const double anchorLogProb;
+  const int64_t anchorLength;
+  // repeats_a[i]: number of repeats in targets [0, i).
+  std::vector<int64_t> repeats_a;
+
+  // Number of repeats in targets [begin, end).
+  int64_t repeats(int64_t begin, int64_t end) const {
+    return end > begin ? repeats_a[end] - repeats_a[begin + 1] : 0;
+  }
+
+  // Whether frames [a.frame, b.frame) can emit targets [a.token, b.token).
+  bool feasible(const Anchor& a, const Anchor& b) const {
+    return b.frame - a.frame >=
+        (b.token - a.token) + repeats(a.token, b.token);
+  }
+
+  // Finds the anchor of the boundary at frame `boundary`, after `prev`: a
+  // chain of anchorLength confident greedy emissions within `overlap` frames
+  // of the boundary, matching a unique span of the targets around the
+  // position expected from `prev`. Chains closest to the boundary are tried
+  // first. Returns false if there is none.
+  bool find_anchor(
+      int64_t boundary,
+      int64_t overlap,
+      const Anchor& prev,
+      Anchor& anchor) const {
+    const auto begin = std::max(prev.frame + 1, boundary - overlap);
+    const auto end = std::min(T, boundary + overlap);
+    if (begin >= end) {
+      return false;
+    }
+
+    // greedy emissions: runs of the same non-blank argmax.
+    struct Emission {
+      int64_t frame;
+      int64_t token;
+      bool confident;
+      bool partial; // the run starts before the first frame searched.
+    };
+    std::vector<Emission> emissions;
+    auto argmax = [&](int64_t t) {
+      const scalar_t* row_a = logProbs_a[0][t].data();
+      return std::max_element(row_a, row_a + C) - row_a;
+    };
+    int64_t prevToken = begin > 0 ? argmax(begin - 1) : blank;
+    for (auto t = begin; t < end; t++) {
+      const int64_t token = argmax(t);
+      const bool confident = logProbs_a[0][t][token] >= anchorLogProb;
+      if (token != blank && (token != prevToken || emissions.empty())) {
+        emissions.push_back({t, token, confident, token == prevToken});
+      } else if (token != blank && confident) {
+        emissions.back().confident = true;
+      }
+      prevToken = token;
+    }
+    if (emissions.size() < size_t(anchorLength)) {
+      return false;
+    }
+
+    std::vector<int64_t> chains;
+    for (size_t i = 0; i + anchorLength <= emissions.size(); i++) {
+      bool confident = true;
+      for (auto k = 0; k < anchorLength; k++) {
+        confident = confident && emissions[i + k].confident;
+      }
+      // a chain starting mid-run would split the run between segments.
+      if (confident && !emissions[i].partial) {
+        chains.push_back(i);
+      }
+    }
+    std::sort(chains.begin(), chains.end(), [&](int64_t x, int64_t y) {
+      return std::abs(emissions[x].frame - boundary) <
+          std::abs(emissions[y].frame - boundary);
+    });
+
+    // targets are searched around their expected position, within the
+    // number of targets expected in 2 * overlap frames.
+    const double rate = static_cast<double>(L - prev.token) /
+        std::max<int64_t>(1, T - prev.frame);
+    const auto radius =
+        static_cast<int64_t>(std::ceil(2 * overlap * rate)) + anchorLength;
+    for (auto i : chains) {
+      const auto frame = emissions[i].frame;
+      const auto expected = prev.token +
+          static_cast<int64_t>(std::llround((frame - prev.frame) * rate));
+      const auto lo = std::max(prev.token + 1, expected - radius);
+      const auto hi = std::min(L - anchorLength, expected + radius);
+      int64_t match = -1;
+      int64_t numMatches = 0;
+      for (auto j = lo; j <= hi && numMatches < 2; j++) {
+        bool matches = true;
+        for (auto k = 0; k < anchorLength && matches; k++) {
+          matches = targets_a[0][j + k] == emissions[i + k].token;
+        }
+        if (matches) {
+          match = j;
+          numMatches++;
+        }
+      }
+      // the previous segment must not end with the token the next one
+      // starts with: their emissions would be merged.
+      if (numMatches == 1 &&
+          targets_a[0][match - 1] != targets_a[0][match]) {
+        Anchor candidate{frame, match, -1};
+        if (feasible(prev, candidate)) {
+          anchor = candidate;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+};
+
+// Aligns a long utterance by windows of windowSize frames. Anchors are
+// searched around the window boundaries, and the segments between anchors
+// are aligned in parallel and stitched. Boundaries without anchor are
+// dropped, and their windows merged.
+template <typename scalar_t, at::ScalarType target_scalar_type>
+void forced_align_windowed_impl(
+    const torch::Tensor& logProbs,
+    const torch::Tensor& targets,
+    const int64_t blank,
+    const int64_t windowSize,
+    const int64_t overlap,
+    const double anchorLogProb,
+    const int64_t anchorLength,
+    torch::Tensor& paths,
+    torch::Tensor& scores,
+    std::vector<int64_t>& failedWindows) {
+  using target_t = typename std::
+      conditional<target_scalar_type == torch::kInt, int, int64_t>::type;
+  const auto T = logProbs.size(1);
+  const auto L = targets.size(1);
+  auto logProbs_a = logProbs.accessor<scalar_t, 3>();
+  auto targets_a = targets.accessor<target_t, 2>();
+
+  WindowedPlan<scalar_t, target_t> plan{
+      logProbs_a,
+      targets_a,
+      T,
+      L,
+      logProbs.size(2),
+      blank,
+      anchorLogProb,
+      anchorLength,
+      std::vector<int64_t>(L + 1, 0)};
+  for (auto i = 1; i <= L; i++) {
+    plan.repeats_a[i] = plan.repeats_a[i - 1] +
+        (i > 1 && targets_a[0][i - 1] == targets_a[0][i - 2]);
+  }
+
+  std::vector<Anchor> anchors{{0, 0, 0}};
+  const auto numWindows = (T + windowSize - 1) / windowSize;
+  for (auto k = 1; k < numWindows; k++) {
+    Anchor anchor{0, 0, 0};
+    if (plan.find_anchor(k * windowSize, overlap, anchors.back(), anchor)) {
+      anchor.window = k;
+      anchors.push_back(anchor);
+    } else {
+      failedWindows.push_back(k);
+    }
+  }
+  // the last segment takes the remaining frames and targets.
+  const Anchor last{T, L, numWindows};
+  while (anchors.size() > 1 && !plan.feasible(anchors.back(), last)) {
+    failedWindows.push_back(anchors.back().window);
+    anchors.pop_back();
+  }
+  std::sort(failedWindows.begin(), failedWindows.end());
+
+  // views of the segments, kept alive while their accessors are used.
+  const auto numSegments = static_cast<int64_t>(anchors.size());
+  std::vector<torch::Tensor> views;
+  for (auto s = 0; s < numSegments; s++) {
+    const auto& a = anchors[s];
+    const auto& b = s + 1 < numSegments ? anchors[s + 1] : last;
+    views.push_back(logProbs.narrow(1, a.frame, b.frame - a.frame));
+    views.push_back(targets.narrow(1, a.token, b.token - a.token));
+    views.push_back(paths.narrow(1, a.frame, b.frame - a.frame));
+    views.push_back(scores.narrow(1, a.frame, b.frame - a.frame));
+  }
+
+  at::parallel_for(0, numSegments, 1, [&](int64_t begin, int64_t end) {
+    Workspace<scalar_t> workspace;
+    for (auto s = begin; s < end; ++s) {
+      auto segmentLogProbs_a = views[4 * s].accessor<scalar_t, 3>();
+      auto segmentTargets_a = views[4 * s + 1].accessor<target_t, 2>();
+      auto segmentPaths_a = views[4 * s + 2].accessor<target_t, 2>();
+      auto segmentScores_a = views[4 * s + 3].accessor<scalar_t, 2>();
+      forced_align_one_sequence<scalar_t, target_t>(
+          segmentLogProbs_a,
+          segmentTargets_a,
+          0,
+          views[4 * s].size(1),
+          views[4 * s + 1].size(1),
+          blank,
+          kMaxBackPtrBytes,
+          workspace,
+          segmentPaths_a,
+          segmentScores_a);
+    }
+  });
+}
+
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor> compute_windowed(
+    const torch::Tensor& logProbs,
+    const torch::Tensor& targets,
+    const int64_t blank,
+    const int64_t windowSize,
+    const int64_t overlap,
+    const double anchorLogProb,
+    const int64_t anchorLength) {
+  TORCH_CHECK(logProbs.is_cpu(), "log_probs must be a CPU tensor");
+  TORCH_CHECK(targets.is_cpu(), "targets must be a CPU tensor");
+  TORCH_CHECK(
+      logProbs.dtype() == torch::kFloat64 ||
+          logProbs.dtype() == torch::kFloat32 ||
+          logProbs.dtype() == torch::kFloat16,
+      "log_probs must be float64, float32 or float16 (half) type");
+  TORCH_CHECK(
+      targets.dtype() == torch::kInt32 || targets.dtype() == torch::kInt64,
+      "targets must be int32 or int64 type");
+  TORCH_CHECK(logProbs.is_contiguous(), "log_probs must be contiguous");
+  TORCH_CHECK(targets.is_contiguous(), "targets must be contiguous");
+  TORCH_CHECK(
+      logProbs.dim() == 3 && logProbs.size(0) == 1,
+      "log_probs must be 3-D (1, input length, num classes)");
+  TORCH_CHECK(
+      targets.dim() == 2 && targets.size(0) == 1,
+      "targets must be 2-D (1, target length)");
+  TORCH_CHECK(logProbs.size(1) > 0, "log_probs must not be empty");
+  TORCH_CHECK(
+      blank >= 0 && blank < logProbs.size(-1),
+      "blank must be within [0, num classes)");
+  TORCH_CHECK(windowSize > 0, "window_size must be positive");
+  TORCH_CHECK(overlap >= 0, "overlap must be non-negative");
+  TORCH_CHECK(anchorLength > 0, "anchor_length must be positive");
+
+  const auto T = logProbs.size(1);
+  auto paths = torch::zeros(
+      {1, T}, torch::TensorOptions().dtype(targets.dtype()));
+  auto scores = torch::zeros({1, T}, logProbs.options());
+  std::vector<int64_t> failedWindows;
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+      logProbs.scalar_type(), "forced_align_windowed_impl", [&] {
+        if (targets.scalar_type() == torch::kInt64) {
+          forced_align_windowed_impl<scalar_t, torch::kInt64>(
+              logProbs,
+              targets,
+              blank,
+              windowSize,
+              overlap,
+              anchorLogProb,
+              anchorLength,
+              paths,
+              scores,
+              failedWindows);
+        } else {
+          forced_align_windowed_impl<scalar_t, torch::kInt32>(
+              logProbs,
+              targets,
+              blank,
+              windowSize,
+              overlap,
+              anchorLogProb,
+              anchorLength,
+              paths,
+              scores,
+              failedWindows);
+        }
+      });
+  auto failed =
+      torch::empty({static_cast<int64_t>(failedWindows.size())}, torch::kInt64);
+  std::copy(
+      failedWindows.begin(), failedWindows.end(), failed.data_ptr<int64_t>());
+  return std::make_tuple(paths, scores, failed);
 }
 
+template <typename scalar_t, typename token_t>
+void merge_tokens_impl(
+    const token_t* tokens_a,
+    const scalar_t* scores_a,
+    const int64_t T,
+    const int64_t blank,
+    std::vector<int64_t>& spanTokens,
+    std::vector<int64_t>& starts,
+    std::vector<int64_t>& ends,
+    std::vector<double>& means) {
+  int64_t start = 0;
+  double sum = 0;
+  for (int64_t t = 0; t < T; t++) {
+    sum += static_cast<double>(scores_a[t]);
+    if (t + 1 == T || tokens_a[t + 1] != tokens_a[start]) {
+      if (tokens_a[start] != blank) {
+        spanTokens.push_back(tokens_a[start]);
+        starts.push_back(start);
+        ends.push_back(t + 1);
+        means.push_back(sum / (t + 1 - start));
+      }
+      start = t + 1;
+      sum = 0;
+    }
+  }
+}
 
+// Spans of the non-blank tokens of an alignment, as (token, start, end, mean
+// score) tensors.
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+merge_tokens(
+    const torch::Tensor& tokens,
+    const torch::Tensor& scores,
+    const int64_t blank) {
+  TORCH_CHECK(tokens.is_cpu(), "tokens must be a CPU tensor");
+  TORCH_CHECK(scores.is_cpu(), "scores must be a CPU tensor");
+  TORCH_CHECK(
+      tokens.dtype() == torch::kInt32 || tokens.dtype() == torch::kInt64,
+      "tokens must be int32 or int64 type");
+  TORCH_CHECK(
+      scores.dtype() == torch::kFloat64 || scores.dtype() == torch::kFloat32 ||
+          scores.dtype() == torch::kFloat16,
+      "scores must be float64, float32 or float16 (half) type");
+  TORCH_CHECK(
+      tokens.dim() == 1 && scores.dim() == 1,
+      "tokens and scores must be 1-D (time,)");
+  TORCH_CHECK(
+      tokens.size(0) == scores.size(0),
+      "tokens and scores must be the same length");
 
+  const auto tokensContiguous = tokens.contiguous();
+  const auto scoresContiguous = scores.contiguous();
+  const auto T = tokens.size(0);
+  std::vector<int64_t> spanTokens, starts, ends;
+  std::vector<double> means;
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+      scores.scalar_type(), "merge_tokens_impl", [&] {
+        if (tokens.scalar_type() == torch::kInt64) {
+          merge_tokens_impl<scalar_t, int64_t>(
+              tokensContiguous.data_ptr<int64_t>(),
+              scoresContiguous.data_ptr<scalar_t>(),
+              T,
+              blank,
+              spanTokens,
+              starts,
+              ends,
+              means);
+        } else {
+          merge_tokens_impl<scalar_t, int>(
+              tokensContiguous.data_ptr<int>(),
+              scoresContiguous.data_ptr<scalar_t>(),
+              T,
+              blank,
+              spanTokens,
+              starts,
+              ends,
+              means);
+        }
+      });
+
+  const auto N = static_cast<int64_t>(spanTokens.size());
+  auto toTensor = [&](const std::vector<int64_t>& values) {
+    auto tensor = torch::empty({N}, torch::kInt64);
+    std::copy(values.begin(), values.end(), tensor.data_ptr<int64_t>());
+    return tensor;
+  };
+  auto meanScores = torch::empty({N}, torch::kFloat64);
+  std::copy(means.begin(), means.end(), meanScores.data_ptr<double>());
+  return std::make_tuple(
+      toTensor(spanTokens).to(tokens.dtype()),
+      toTensor(starts),
+      toTensor(ends),
+      meanScores.to(scores.dtype()));
+}
 
 TORCH_LIBRARY_IMPL(torchaudio, CPU, m) {
   m.impl("forced_align", &compute);
+  m.impl("forced_align_windowed", &compute_windowed);
+  m.impl("merge_tokens", &merge_tokens);
 }
 
 } // namespace cpu
@@ -247,7 +247,8 @@ std::tuple<torch::Tensor, torch::Tensor> compute(
     const torch::Tensor& targets,
     const torch::Tensor& inputLengths,
     const torch::Tensor& targetLengths,
-    const int64_t blank) {
+    const int64_t blank,
+    const int64_t /*max_backpointer_bytes*/) {
   TORCH_CHECK(logProbs.is_cuda(), "log_probs must be a CUDA tensor");
   TORCH_CHECK(targets.is_cuda(), "targets must be a CUDA tensor");
   TORCH_CHECK(
@@ -304,9 +305,10 @@ std::tuple<torch::Tensor, torch::Tensor> compute(
               logProbs, targets, blank, paths);
         }
       });
-  return std::make_tuple(
-      paths.to(logProbs.device()),
-      logProbs);
+  paths = paths.to(logProbs.device());
+  auto scores =
+      logProbs.gather(2, paths.to(torch::kInt64).unsqueeze(2)).squeeze(2);
+  return std::make_tuple(paths, scores);
 }
 
 TORCH_LIBRARY_IMPL(torchaudio, CUDA, m) {
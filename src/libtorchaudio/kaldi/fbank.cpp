@@ -0,0 +1,276 @@
+#include <libtorchaudio/kaldi/fbank.h>
+#include <torch/torch.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace torchaudio {
+namespace kaldi {
+
+namespace {
+
+// number of frames a thread processes at least.
+constexpr int64_t FRAME_GRAIN_SIZE = 16;
+
+// Index of the sample s of a waveform of num_samples samples, reflected at the
+// edges, see ExtractWindow in Kaldi's feature-window.cc.
+inline int64_t reflect(int64_t s, int64_t num_samples) {
+  while (s < 0 || s >= num_samples) {
+    s = s < 0 ? -s - 1 : 2 * num_samples - 1 - s;
+  }
+  return s;
+}
+
+template <typename scalar_t>
+scalar_t log_energy_of(
+    const scalar_t* frame,
+    int64_t size,
+    scalar_t log_energy_floor,
+    bool has_energy_floor) {
+  double sum = 0;
+  for (int64_t i = 0; i < size; ++i) {
+    sum += double(frame[i]) * frame[i];
+  }
+  const scalar_t epsilon = std::numeric_limits<float>::epsilon();
+  const scalar_t log_energy =
+      std::log(std::max(static_cast<scalar_t>(sum), epsilon));
+  return has_energy_floor ? std::max(log_energy, log_energy_floor)
+                          : log_energy;
+}
+
+// Extracts the frames of the waveform, with the dither, the DC offset
+// removal, the pre-emphasis, the window function and the padding of
+// _get_window in compliance/kaldi.py, in a single pass over every frame.
+//
+// frames: (num_frames, padded_window_size) output frames.
+// log_energy: (num_frames, ) output log energies.
+template <typename scalar_t>
+void extract_frames(
+    const scalar_t* samples,
+    int64_t num_samples,
+    const scalar_t* noise,
+    const scalar_t* window,
+    int64_t window_size,
+    const FbankOptions& options,
+    int64_t num_frames,
+    scalar_t* frames,
+    scalar_t* log_energy) {
+  const int64_t padded_window_size = options.padded_window_size;
+  const scalar_t dither = options.dither;
+  const scalar_t preemphasis = options.preemphasis_coefficient;
+  const bool has_energy_floor = options.energy_floor != 0.0;
+  const scalar_t log_energy_floor =
+      has_energy_floor ? std::log(options.energy_floor) : 0.0;
+
+  at::parallel_for(
+      0, num_frames, FRAME_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t f = begin; f < end; ++f) {
+          scalar_t* frame = frames + f * padded_window_size;
+          const int64_t start = options.snip_edges
+              ? f * options.window_shift
+              : f * options.window_shift + options.window_shift / 2 -
+                  window_size / 2;
+          if (start >= 0 && start + window_size <= num_samples) {
+            std::copy(samples + start, samples + start + window_size, frame);
+          } else {
+            for (int64_t i = 0; i < window_size; ++i) {
+              frame[i] = samples[reflect(start + i, num_samples)];
+            }
+          }
+
+          if (noise != nullptr) {
+            const scalar_t* frame_noise = noise + f * window_size;
+            for (int64_t i = 0; i < window_size; ++i) {
+              frame[i] = frame[i] + frame_noise[i] * dither;
+            }
+          }
+          if (options.remove_dc_offset) {
+            double sum = 0;
+            for (int64_t i = 0; i < window_size; ++i) {
+              sum += frame[i];
+            }
+            const scalar_t mean = sum / window_size;
+            for (int64_t i = 0; i < window_size; ++i) {
+              frame[i] = frame[i] - mean;
+            }
+          }
+          if (options.raw_energy) {
+            log_energy[f] = log_energy_of(
+                frame, window_size, log_energy_floor, has_energy_floor);
+          }
+          if (preemphasis != 0) {
+            // from the end, so that frame[i - 1] is not pre-emphasized yet.
+            for (int64_t i = window_size - 1; i > 0; --i) {
+              frame[i] = frame[i] - preemphasis * frame[i - 1];
+            }
+            frame[0] = frame[0] - preemphasis * frame[0];
+          }
+          for (int64_t i = 0; i < window_size; ++i) {
+            frame[i] = frame[i] * window[i];
+          }
+          std::fill(frame + window_size, frame + padded_window_size, 0);
+          if (!options.raw_energy) {
+            log_energy[f] = log_energy_of(
+                frame, padded_window_size, log_energy_floor, has_energy_floor);
+          }
+        }
+      });
+}
+
+// Writes the power, or the magnitude, of the (num_frames, num_bins) spectrum.
+template <typename scalar_t>
+void power_spectrum(
+    const c10::complex<scalar_t>* fft,
+    int64_t num_frames,
+    int64_t num_bins,
+    bool use_power,
+    scalar_t* spectrum) {
+  at::parallel_for(
+      0, num_frames, FRAME_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin * num_bins; i < end * num_bins; ++i) {
+          const scalar_t re = fft[i].real();
+          const scalar_t im = fft[i].imag();
+          const scalar_t power = re * re + im * im;
+          spectrum[i] = use_power ? power : std::sqrt(power);
+        }
+      });
+}
+
+std::tuple<torch::Tensor, torch::Tensor> kaldi_fbank(
+    const torch::Tensor& waveform,
+    const torch::Tensor& window,
+    const torch::Tensor& mel_banks,
+    int64_t window_shift,
+    int64_t padded_window_size,
+    bool snip_edges,
+    double dither,
+    bool remove_dc_offset,
+    double preemphasis_coefficient,
+    bool raw_energy,
+    double energy_floor,
+    bool use_power,
+    bool use_log_fbank) {
+  TORCH_CHECK(waveform.dim() == 1, "waveform must be a 1D tensor.");
+  TORCH_CHECK(window.dim() == 1, "window must be a 1D tensor.");
+  torch::Tensor noise;
+  if (dither != 0.0) {
+    // the noise is drawn like in compliance/kaldi.py, so that both give the
+    // same result with the same seed.
+    noise = torch::randn(
+        {num_frames(waveform.size(0), window.size(0), window_shift, snip_edges),
+         window.size(0)},
+        waveform.options());
+  }
+  return compute_fbank(
+      waveform.contiguous(),
+      noise,
+      window.contiguous(),
+      mel_banks.contiguous(),
+      FbankOptions{
+          window_shift,
+          padded_window_size,
+          snip_edges,
+          dither,
+          remove_dc_offset,
+          preemphasis_coefficient,
+          raw_energy,
+          energy_floor,
+          use_power,
+          use_log_fbank});
+}
+
+} // namespace
+
+int64_t num_frames(
+    int64_t num_samples,
+    int64_t window_size,
+    int64_t window_shift,
+    bool snip_edges) {
+  if (snip_edges) {
+    return num_samples < window_size
+        ? 0
+        : 1 + (num_samples - window_size) / window_shift;
+  }
+  return (num_samples + window_shift / 2) / window_shift;
+}
+
+std::tuple<torch::Tensor, torch::Tensor> compute_fbank(
+    const torch::Tensor& waveform,
+    const torch::Tensor& noise,
+    const torch::Tensor& window,
+    const torch::Tensor& mel_banks,
+    const FbankOptions& options) {
+  const int64_t window_size = window.size(0);
+  const int64_t num_fft_bins = options.padded_window_size / 2 + 1;
+  TORCH_CHECK(
+      waveform.is_contiguous() && window.is_contiguous(),
+      "waveform and window must be contiguous.");
+  TORCH_CHECK(
+      waveform.scalar_type() == window.scalar_type() &&
+          waveform.scalar_type() == mel_banks.scalar_type(),
+      "waveform, window and mel_banks must have the same dtype.");
+  TORCH_CHECK(
+      window_size >= 2 && window_size <= options.padded_window_size,
+      "window size must be in [2, padded_window_size].");
+  TORCH_CHECK(options.window_shift > 0, "window_shift must be positive.");
+  TORCH_CHECK(
+      mel_banks.dim() == 2 && mel_banks.size(1) == num_fft_bins,
+      "mel_banks must be of shape (num_mel_bins, padded_window_size / 2 + 1).");
+
+  const int64_t num_samples = waveform.size(0);
+  const int64_t m = num_frames(
+      num_samples, window_size, options.window_shift, options.snip_edges);
+  TORCH_CHECK(
+      m == 0 || num_samples > 0, "waveform must not be empty to have frames.");
+  TORCH_CHECK(
+      !noise.defined() ||
+          (noise.is_contiguous() && noise.size(0) == m &&
+           noise.size(1) == window_size),
+      "noise must be a contiguous tensor of shape (num_frames, window_size).");
+
+  auto frames =
+      torch::empty({m, options.padded_window_size}, waveform.options());
+  auto log_energy = torch::empty({m}, waveform.options());
+  auto spectrum = torch::empty({m, num_fft_bins}, waveform.options());
+  AT_DISPATCH_FLOATING_TYPES(waveform.scalar_type(), "kaldi_fbank", [&] {
+    extract_frames<scalar_t>(
+        waveform.data_ptr<scalar_t>(),
+        num_samples,
+        noise.defined() ? noise.data_ptr<scalar_t>() : nullptr,
+        window.data_ptr<scalar_t>(),
+        window_size,
+        options,
+        m,
+        frames.data_ptr<scalar_t>(),
+        log_energy.data_ptr<scalar_t>());
+    if (m > 0) {
+      // the FFT plans are cached by ATen.
+      auto fft = torch::fft::rfft(frames).contiguous();
+      power_spectrum<scalar_t>(
+          fft.data_ptr<c10::complex<scalar_t>>(),
+          m,
+          num_fft_bins,
+          options.use_power,
+          spectrum.data_ptr<scalar_t>());
+    }
+  });
+
+  auto mel_energies = torch::mm(spectrum, mel_banks.t());
+  if (options.use_log_fbank) {
+    // avoid log of zero.
+    mel_energies.clamp_min_(std::numeric_limits<float>::epsilon()).log_();
+  }
+  return {mel_energies, log_energy};
+}
+
+TORCH_LIBRARY_IMPL(torchaudio, CPU, m) {
+  m.impl("torchaudio::kaldi_fbank", &kaldi_fbank);
+}
+
+TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
+  m.def(
+      "torchaudio::kaldi_fbank(Tensor waveform, Tensor window, Tensor mel_banks, int window_shift, int padded_window_size, bool snip_edges, float dither, bool remove_dc_offset, float preemphasis_coefficient, bool raw_energy, float energy_floor, bool use_power, bool use_log_fbank) -> (Tensor, Tensor)");
+}
+
+} // namespace kaldi
+} // namespace torchaudio
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <torch/script.h>
+
+namespace torchaudio {
+namespace kaldi {
+
+// Options of the frames and of the filter bank, see compliance/kaldi.py.
+struct FbankOptions {
+  int64_t window_shift;
+  int64_t padded_window_size;
+  bool snip_edges;
+  double dither;
+  bool remove_dc_offset;
+  double preemphasis_coefficient;
+  bool raw_energy;
+  double energy_floor;
+  bool use_power;
+  bool use_log_fbank;
+};
+
+// Number of frames of num_samples samples, see NumFrames in Kaldi's
+// feature-window.cc.
+int64_t num_frames(
+    int64_t num_samples,
+    int64_t window_size,
+    int64_t window_shift,
+    bool snip_edges);
+
+// Computes the filter bank of the frames of a waveform.
+//
+// waveform: (num_samples, ) contiguous samples.
+// noise: (num_frames, window_size) gaussian noise of the dither, or an
+//   undefined tensor if options.dither is 0.
+// window: (window_size, ) window function.
+// mel_banks: (num_mel_bins, padded_window_size / 2 + 1) mel filter bank.
+//
+// Returns the (num_frames, num_mel_bins) mel energies and the (num_frames, )
+// log energies of the frames.
+std::tuple<torch::Tensor, torch::Tensor> compute_fbank(
+    const torch::Tensor& waveform,
+    const torch::Tensor& noise,
+    const torch::Tensor& window,
+    const torch::Tensor& mel_banks,
+    const FbankOptions& options);
+
+} // namespace kaldi
+} // namespace torchaudio
@@ -0,0 +1,117 @@
+#include <libtorchaudio/kaldi/fbank.h>
+#include <torch/torch.h>
+#include <algorithm>
+
+namespace torchaudio {
+namespace kaldi {
+
+// Filter bank of compliance/kaldi.py with snip_edges, computed on a stream
+// of chunks. The samples of the frames which are not complete yet are kept
+// until the next chunk, so the frames of a stream cut into chunks of any size
+// are the frames of the whole stream, and each frame is computed once.
+//
+// The dither noise is drawn for the frames of every chunk, so the frames are
+// the same as the ones of the whole stream only without dither.
+class KaldiOnlineFbank : public torch::CustomClassHolder {
+ public:
+  KaldiOnlineFbank(
+      torch::Tensor window,
+      torch::Tensor mel_banks,
+      int64_t window_shift,
+      int64_t padded_window_size,
+      double dither,
+      bool remove_dc_offset,
+      double preemphasis_coefficient,
+      bool raw_energy,
+      double energy_floor,
+      bool use_power,
+      bool use_log_fbank)
+      : window_(window.contiguous()),
+        mel_banks_(mel_banks.contiguous()),
+        options_{
+            window_shift,
+            padded_window_size,
+            /*snip_edges=*/true,
+            dither,
+            remove_dc_offset,
+            preemphasis_coefficient,
+            raw_energy,
+            energy_floor,
+            use_power,
+            use_log_fbank} {
+    TORCH_CHECK(window_.dim() == 1, "window must be a 1D tensor.");
+    TORCH_CHECK(window_shift > 0, "window_shift must be positive.");
+    remainder_ = torch::empty({0}, window_.options());
+  }
+
+  // Returns the (num_frames, num_mel_bins) mel energies and the (num_frames, )
+  // log energies of the frames completed by the (num_samples, ) chunk.
+  std::tuple<torch::Tensor, torch::Tensor> accept_waveform(
+      const torch::Tensor& chunk) {
+    TORCH_CHECK(chunk.dim() == 1, "chunk must be a 1D tensor.");
+    TORCH_CHECK(
+        chunk.scalar_type() == window_.scalar_type(),
+        "chunk must have the dtype of the window.");
+    TORCH_CHECK(chunk.device().is_cpu(), "chunk must be on CPU.");
+
+    // the samples between the end of a frame and the start of the next one,
+    // when window_shift is larger than the window.
+    const int64_t skipped = std::min(to_skip_, chunk.size(0));
+    to_skip_ -= skipped;
+    torch::Tensor samples = remainder_.size(0) == 0
+        ? chunk.slice(0, skipped).contiguous()
+        : torch::cat({remainder_, chunk.slice(0, skipped)});
+
+    const int64_t window_size = window_.size(0);
+    const int64_t num_samples = samples.size(0);
+    const int64_t m = num_frames(
+        num_samples, window_size, options_.window_shift, /*snip_edges=*/true);
+    torch::Tensor noise;
+    if (options_.dither != 0.0 && m > 0) {
+      noise = torch::randn({m, window_size}, samples.options());
+    }
+    auto features =
+        compute_fbank(samples, noise, window_, mel_banks_, options_);
+
+    // the next frame starts at sample m * window_shift. The remainder is
+    // shorter than the window, and copied so that the chunk is not kept.
+    const int64_t next = m * options_.window_shift;
+    remainder_ = samples.slice(0, std::min(next, num_samples)).clone();
+    to_skip_ += std::max<int64_t>(next - num_samples, 0);
+    return features;
+  }
+
+  // Starts a new stream.
+  void reset() {
+    remainder_ = torch::empty({0}, window_.options());
+    to_skip_ = 0;
+  }
+
+ private:
+  const torch::Tensor window_;
+  const torch::Tensor mel_banks_;
+  const FbankOptions options_;
+  torch::Tensor remainder_; // samples of the next frames.
+  int64_t to_skip_ = 0; // samples before the next frame.
+};
+
+TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
+  m.class_<KaldiOnlineFbank>("KaldiOnlineFbank")
+      .def(torch::init<
+           torch::Tensor,
+           torch::Tensor,
+           int64_t,
+           int64_t,
+           double,
+           bool,
+           double,
+           bool,
+           double,
+           bool,
+           bool>())
+      .def("accept_waveform", &KaldiOnlineFbank::accept_waveform)
+      .def("reset", &KaldiOnlineFbank::reset);
+}
+
+} // namespace kaldi
+} // namespace torchaudio
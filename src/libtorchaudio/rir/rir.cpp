@@ -24,6 +24,7 @@ SOFTWARE.
 #include <torch/script.h>
 #include <torch/torch.h>
 #include <cmath>
+#include <random>
 using namespace torch::indexing;
 
 namespace torchaudio {
@@ -190,9 +191,211 @@ torch::Tensor make_rir_filter(
   return filters;
 }
 
+/**
+ * @brief Generate the random Dirac sequence used to synthesize the late
+ * reverberation from the energy histogram. The arrival times of reflections
+ * follow a Poisson process whose rate grows quadratically with time, and each
+ * Dirac is given a random sign. The implementation is based on the one in
+ * pyroomacoustics:
+ * https://github.com/LCAV/pyroomacoustics/blob/master/pyroomacoustics/simulation/ism.py
+ *
+ * @param volume The volume of the room.
+ * @param sound_speed The speed of sound.
+ * @param sample_rate The sample rate of the output sequence.
+ * @param gen The random number generator.
+ * @param seq The output sequence. Each element is -1, 0 or 1. Its size
+ * determines the duration of the sequence.
+ */
+void make_dirac_sequence(
+    double volume,
+    double sound_speed,
+    double sample_rate,
+    std::mt19937_64& gen,
+    std::vector<int8_t>& seq) {
+  // The maximum density of reflections [1/second].
+  const double max_rate = 10000.;
+  const double fpcv = 4. * M_PI * std::pow(sound_speed, 3) / volume;
+  const double t0 = std::cbrt(2. * std::log(2.) / fpcv);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::bernoulli_distribution sign(0.5);
+  const int64_t length = seq.size();
+  double time = t0;
+  while (true) {
+    int64_t idx = std::llround((time - t0) * sample_rate);
+    if (idx >= length) {
+      break;
+    }
+    seq[idx] = sign(gen) ? 1 : -1;
+    double mu = std::min(fpcv * time * time, max_rate);
+    // 1 - uniform is in (0, 1], so the logarithm is finite.
+    time += -std::log(1. - uniform(gen)) / mu;
+  }
+}
+
+/**
+ * @brief Convert the energy histograms into room impulse responses.
+ *
+ * For each microphone, a Dirac sequence is weighted per band so that the
+ * energy of each histogram bin is preserved, then band-pass filtered with the
+ * octave band filters and summed over the bands. As the Dirac sequence is
+ * sparse, the filtering is performed by accumulating the per-bin combined
+ * filter response at the position of each Dirac, which is equivalent to a
+ * `"same"` mode convolution.
+ *
+ * @tparam scalar_t The type of histograms, filters and rirs Tensors.
+ * @param histograms The energy histograms. Tensor with dimensions
+ * `(num_mic, num_band, num_bin)`.
+ * @param filters The band-pass filters. Tensor with dimensions
+ * `(num_band, filter_length)`.
+ * @param volume The volume of the room.
+ * @param sample_rate The sample_rate of simulated room impulse response signal.
+ * @param bin_length The number of samples in one histogram bin.
+ * @param sound_speed The speed of sound.
+ * @param seed The seed of the random number generator. Microphone `m` uses
+ * `seed + m`, so the result does not depend on the number of threads.
+ * @param rirs The output room impulse response signal. Tensor with dimensions
+ * `(num_mic, num_bin * bin_length)`.
+ */
+template <typename scalar_t>
+void histogram_to_rir_impl(
+    const torch::Tensor& histograms,
+    const torch::Tensor& filters,
+    double volume,
+    double sample_rate,
+    int64_t bin_length,
+    double sound_speed,
+    int64_t seed,
+    torch::Tensor& rirs) {
+  const int64_t num_mic = histograms.size(0);
+  const int64_t num_band = histograms.size(1);
+  const int64_t num_bin = histograms.size(2);
+  const int64_t filter_length = filters.size(1);
+  const int64_t rir_length = num_bin * bin_length;
+  const int64_t center = (filter_length - 1) / 2;
+  const scalar_t* hist_data = histograms.data_ptr<scalar_t>();
+  const scalar_t* filter_data = filters.data_ptr<scalar_t>();
+  scalar_t* output_data = rirs.data_ptr<scalar_t>();
+
+  at::parallel_for(0, num_mic, 1, [&](int64_t begin, int64_t end) {
+    std::vector<int8_t> seq(rir_length);
+    std::vector<scalar_t> weights(num_band);
+    std::vector<scalar_t> response(filter_length);
+    for (auto mic = begin; mic < end; mic++) {
+      std::fill(seq.begin(), seq.end(), 0);
+      std::mt19937_64 gen(seed + mic);
+      make_dirac_sequence(volume, sound_speed, sample_rate, gen, seq);
+
+      const scalar_t* hist = hist_data + mic * num_band * num_bin;
+      scalar_t* output = output_data + mic * rir_length;
+      for (int64_t bin = 0; bin < num_bin; bin++) {
+        const int8_t* bin_seq = seq.data() + bin * bin_length;
+        int64_t count = 0;
+        for (int64_t j = 0; j < bin_length; j++) {
+          count += bin_seq[j] != 0;
+        }
+        if (count == 0) {
+          continue;
+        }
+        // The energy of the Dirac sequence in this bin is `count`, so scaling
+        // the amplitude of each band by sqrt(energy / count) gives the
+        // histogram energy back.
+        for (int64_t band = 0; band < num_band; band++) {
+          weights[band] = std::sqrt(hist[band * num_bin + bin] / count);
+        }
+        for (int64_t j = 0; j < filter_length; j++) {
+          scalar_t val = 0;
+          for (int64_t band = 0; band < num_band; band++) {
+            val += weights[band] * filter_data[band * filter_length + j];
+          }
+          response[j] = val;
+        }
+        for (int64_t j = 0; j < bin_length; j++) {
+          if (bin_seq[j] == 0) {
+            continue;
+          }
+          const int64_t pos = bin * bin_length + j - center;
+          const int64_t k_begin = std::max<int64_t>(0, -pos);
+          const int64_t k_end = std::min(filter_length, rir_length - pos);
+          const scalar_t sign = bin_seq[j];
+          for (int64_t k = k_begin; k < k_end; k++) {
+            output[pos + k] += sign * response[k];
+          }
+        }
+      }
+    }
+  });
+}
+
+/**
+ * @brief Convert the energy histograms computed by ray tracing into room
+ * impulse responses.
+ *
+ * @param histograms The energy histograms, non-negative. Tensor with
+ * dimensions `(num_mic, num_band, num_bin)`.
+ * @param filters The band-pass filters created by `make_rir_filter`. Tensor
+ * with dimensions `(num_band, filter_length)`.
+ * @param volume The volume of the room.
+ * @param sample_rate The sample_rate of simulated room impulse response signal.
+ * @param hist_bin_size The width of a histogram bin in seconds.
+ * @param sound_speed The speed of sound.
+ * @param seed The seed of the random number generator.
+ * @return torch::Tensor The output room impulse response signal. Tensor with
+ * dimensions `(num_mic, num_bin * floor(hist_bin_size * sample_rate))`.
+ */
+torch::Tensor histogram_to_rir(
+    const torch::Tensor& histograms,
+    const torch::Tensor& filters,
+    double volume,
+    double sample_rate,
+    double hist_bin_size,
+    double sound_speed,
+    int64_t seed) {
+  TORCH_CHECK(
+      histograms.dim() == 3,
+      "histograms must be 3-D (num_mics, num_bands, num_bins)");
+  TORCH_CHECK(filters.dim() == 2, "filters must be 2-D (num_bands, length)");
+  TORCH_CHECK(
+      histograms.size(1) == filters.size(0),
+      "The number of bands in histograms and filters must match. Found ",
+      histograms.size(1),
+      " and ",
+      filters.size(0));
+  TORCH_CHECK(
+      histograms.scalar_type() == filters.scalar_type(),
+      "histograms and filters must have the same dtype");
+  // the amplitudes are the square roots of the energies.
+  TORCH_CHECK(
+      (histograms >= 0).all().item<bool>(),
+      "histograms must be non-negative");
+  TORCH_CHECK(volume > 0, "volume must be positive");
+  const int64_t bin_length = (int64_t)(hist_bin_size * sample_rate);
+  TORCH_CHECK(
+      bin_length > 0,
+      "hist_bin_size must be at least one sample long. Found: ",
+      hist_bin_size);
+
+  auto hist = histograms.contiguous();
+  auto filt = filters.contiguous();
+  torch::Tensor rirs = torch::zeros(
+      {hist.size(0), hist.size(2) * bin_length}, hist.options());
+  AT_DISPATCH_FLOATING_TYPES(hist.scalar_type(), "histogram_to_rir", [&] {
+    histogram_to_rir_impl<scalar_t>(
+        hist,
+        filt,
+        volume,
+        sample_rate,
+        bin_length,
+        sound_speed,
+        seed,
+        rirs);
+  });
+  return rirs;
+}
+
 TORCH_LIBRARY_IMPL(torchaudio, CPU, m) {
   m.impl("torchaudio::_simulate_rir", torchaudio::rir::simulate_rir);
   m.impl("torchaudio::_make_rir_filter", torchaudio::rir::make_rir_filter);
+  m.impl("torchaudio::_histogram_to_rir", torchaudio::rir::histogram_to_rir);
 }
 
 TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
@@ -200,6 +403,8 @@ TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
       "torchaudio::_simulate_rir(Tensor irs, Tensor delay_i, int rir_length) -> Tensor");
   m.def(
       "torchaudio::_make_rir_filter(Tensor centers, float sample_rate, int n_fft) -> Tensor");
+  m.def(
+      "torchaudio::_histogram_to_rir(Tensor histograms, Tensor filters, float volume, float sample_rate, float hist_bin_size, float sound_speed, int seed) -> Tensor");
 }
 
 } // Anonymous namespace
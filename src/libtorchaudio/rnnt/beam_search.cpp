@@ -0,0 +1,426 @@
+#include <torch/script.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace torchaudio {
+namespace rnnt {
+
+namespace {
+
+// Tokens of the hypotheses are stored in an arena shared by all of them: the
+// tokens of a hypothesis are the chain of nodes ending at its last token, so
+// extending a hypothesis does not copy its prefix. The nodes of the pruned
+// hypotheses are dropped at the end of every frame.
+struct TokenNode {
+  int parent; // -1 for the first token.
+  int64_t token;
+};
+
+struct Hypothesis {
+  int node; // last token in the arena.
+  int length; // number of tokens.
+  uint64_t key; // hash of the tokens.
+  double score;
+  // the predictor output and state of the hypothesis are row `row` of the
+  // predictor batch `batch`.
+  int batch;
+  int row;
+};
+
+struct PredictorBatch {
+  torch::Tensor out; // (N, 1, D).
+  std::vector<torch::Tensor> state; // (N, ...) components.
+};
+
+// Expansion of a hypothesis with a non-blank token, waiting for the
+// predictor output.
+struct Expansion {
+  Hypothesis base;
+  int64_t token;
+  double score;
+};
+
+uint64_t ExtendKey(uint64_t key, int64_t token) {
+  // splitmix64 finalizer of the previous key combined with the token.
+  uint64_t z = key ^
+      (uint64_t(token) + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2));
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+double LogAddExp(double a, double b) {
+  if (std::isinf(a) && a == b) {
+    return a;
+  }
+  return std::max(a, b) + std::log1p(std::exp(-std::abs(a - b)));
+}
+
+} // namespace
+
+// Bookkeeping of the RNN-T beam search of torchaudio.models.RNNTBeamSearch:
+// hypotheses, prefix merging and pruning run here, while the predictor and
+// joiner are evaluated by the caller on the batches this class prepares.
+//
+// For every frame:
+//   begin_frame()
+//   while has_active():
+//     log_probs = log_softmax(join(frame, active_predictor_out()))
+//     tokens, state = expand(log_probs)
+//     if tokens is not empty:
+//       add_predictions(predict(tokens, state))
+//   end_frame()
+class RNNTBeamSearchEngine : public torch::CustomClassHolder {
+ public:
+  RNNTBeamSearchEngine(int64_t beam_width, int64_t step_max_tokens)
+      : beamWidth_(beam_width), stepMaxTokens_(step_max_tokens) {
+    TORCH_CHECK(beam_width > 0, "beam_width must be positive");
+  }
+
+  // Seeds the search with hypotheses, whose predictor outputs and states are
+  // batched along the first dimension.
+  void reset(
+      const std::vector<std::vector<int64_t>>& tokens,
+      const std::vector<double>& scores,
+      const torch::Tensor& predictor_out,
+      const std::vector<torch::Tensor>& state) {
+    TORCH_CHECK(!tokens.empty(), "at least one hypothesis is required");
+    TORCH_CHECK(
+        tokens.size() == scores.size() &&
+            predictor_out.size(0) == int64_t(tokens.size()),
+        "tokens, scores and predictor_out must have the same length");
+
+    arena_.clear();
+    batches_.clear();
+    active_.clear();
+    beam_.clear();
+    expansions_.clear();
+    batches_.push_back({predictor_out, state});
+    for (size_t i = 0; i < tokens.size(); ++i) {
+      TORCH_CHECK(!tokens[i].empty(), "hypotheses must have tokens");
+      Hypothesis hypo{-1, 0, 0, scores[i], 0, int(i)};
+      for (int64_t token : tokens[i]) {
+        hypo = Extend(hypo, token);
+      }
+      beam_.push_back(hypo);
+    }
+  }
+
+  void begin_frame() {
+    active_ = std::move(beam_);
+    beam_.clear();
+    beamIndex_.clear();
+    symbols_ = 0;
+  }
+
+  bool has_active() const {
+    return !active_.empty();
+  }
+
+  // (N, 1, D) predictor outputs of the hypotheses to expand.
+  torch::Tensor active_predictor_out() const {
+    return Gather(active_, /*withState=*/false).out;
+  }
+
+  // Given the (N, num_tokens) log probs of the active hypotheses, whose last
+  // token is blank, merges their blank extensions into the beam, and selects
+  // their non-blank extensions. Returns the (M, 1) selected tokens and the
+  // predictor states to extend, to be passed to add_predictions.
+  std::tuple<torch::Tensor, std::vector<torch::Tensor>> expand(
+      const torch::Tensor& log_probs) {
+    TORCH_CHECK(
+        log_probs.dim() == 2 && log_probs.size(0) == int64_t(active_.size()),
+        "log_probs must be 2-D (num active hypotheses, num tokens)");
+    torch::Tensor probs =
+        log_probs.to(torch::kCPU, torch::kFloat64).contiguous();
+    const int N = probs.size(0);
+    const int V = probs.size(1);
+    const double* data = probs.data_ptr<double>();
+
+    for (int i = 0; i < N; ++i) {
+      MergeIntoBeam(active_[i], active_[i].score + data[i * V + V - 1]);
+    }
+
+    expansions_.clear();
+    if (symbols_ == stepMaxTokens_) {
+      active_.clear();
+      return std::make_tuple(
+          torch::empty({0, 1}, torch::kInt64), std::vector<torch::Tensor>());
+    }
+
+    // top beam_width non-blank extensions, by partial selection.
+    std::vector<std::pair<double, int>> candidates;
+    candidates.reserve(int64_t(N) * (V - 1));
+    for (int i = 0; i < N; ++i) {
+      for (int v = 0; v < V - 1; ++v) {
+        candidates.emplace_back(active_[i].score + data[i * V + v], i * V + v);
+      }
+    }
+    const int k = std::min<int64_t>(beamWidth_, candidates.size());
+    auto byScore = [](const std::pair<double, int>& x,
+                      const std::pair<double, int>& y) {
+      return x.first > y.first;
+    };
+    std::partial_sort(
+        candidates.begin(), candidates.begin() + k, candidates.end(), byScore);
+
+    // an extension is kept if it beats the beam_width-th best hypothesis
+    // that ended the frame.
+    double threshold = -std::numeric_limits<double>::infinity();
+    if (int64_t(beam_.size()) >= beamWidth_) {
+      std::vector<double> scores(beam_.size());
+      for (size_t i = 0; i < beam_.size(); ++i) {
+        scores[i] = beam_[i].score;
+      }
+      std::nth_element(
+          scores.begin(),
+          scores.begin() + beamWidth_ - 1,
+          scores.end(),
+          std::greater<double>());
+      threshold = scores[beamWidth_ - 1];
+    }
+    for (int i = 0; i < k; ++i) {
+      if (candidates[i].first > threshold) {
+        const int hypo = candidates[i].second / V;
+        const int token = candidates[i].second % V;
+        expansions_.push_back({active_[hypo], token, candidates[i].first});
+      }
+    }
+    active_.clear();
+
+    torch::Tensor tokens =
+        torch::empty({int64_t(expansions_.size()), 1}, torch::kInt64);
+    int64_t* tokensData = tokens.data_ptr<int64_t>();
+    std::vector<Hypothesis> bases;
+    for (size_t i = 0; i < expansions_.size(); ++i) {
+      tokensData[i] = expansions_[i].token;
+      bases.push_back(expansions_[i].base);
+    }
+    if (bases.empty()) {
+      return std::make_tuple(tokens, std::vector<torch::Tensor>());
+    }
+    return std::make_tuple(tokens, Gather(bases, /*withState=*/true).state);
+  }
+
+  // Completes the extensions selected by expand with their (M, 1, D)
+  // predictor outputs and states. They are the hypotheses to expand next.
+  void add_predictions(
+      const torch::Tensor& predictor_out,
+      const std::vector<torch::Tensor>& state) {
+    TORCH_CHECK(
+        predictor_out.size(0) == int64_t(expansions_.size()),
+        "predictor_out must have one row per selected token");
+    const int batch = batches_.size();
+    batches_.push_back({predictor_out, state});
+    for (size_t i = 0; i < expansions_.size(); ++i) {
+      Hypothesis hypo = Extend(expansions_[i].base, expansions_[i].token);
+      hypo.score = expansions_[i].score;
+      hypo.batch = batch;
+      hypo.row = i;
+      active_.push_back(hypo);
+    }
+    expansions_.clear();
+    if (!active_.empty()) {
+      ++symbols_;
+    }
+  }
+
+  // Keeps the beam_width best hypotheses, by score normalized by length.
+  void end_frame() {
+    const int64_t k = std::min<int64_t>(beamWidth_, beam_.size());
+    std::partial_sort(
+        beam_.begin(),
+        beam_.begin() + k,
+        beam_.end(),
+        [](const Hypothesis& x, const Hypothesis& y) {
+          return x.score / (x.length + 1) > y.score / (y.length + 1);
+        });
+    beam_.resize(k);
+    CompactArena();
+
+    // drop the predictor batches that are no longer referenced.
+    PredictorBatch compact = Gather(beam_, /*withState=*/true);
+    batches_.clear();
+    batches_.push_back(std::move(compact));
+    for (size_t i = 0; i < beam_.size(); ++i) {
+      beam_[i].batch = 0;
+      beam_[i].row = i;
+    }
+  }
+
+  // Tokens, scores, and batched predictor outputs and states of the beam,
+  // best first.
+  std::tuple<
+      std::vector<std::vector<int64_t>>,
+      std::vector<double>,
+      torch::Tensor,
+      std::vector<torch::Tensor>>
+  hypotheses() const {
+    std::vector<std::vector<int64_t>> tokens;
+    std::vector<double> scores;
+    for (const Hypothesis& hypo : beam_) {
+      tokens.push_back(Tokens(hypo));
+      scores.push_back(hypo.score);
+    }
+    PredictorBatch batch = Gather(beam_, /*withState=*/true);
+    return std::make_tuple(tokens, scores, batch.out, batch.state);
+  }
+
+ private:
+  Hypothesis Extend(const Hypothesis& hypo, int64_t token) {
+    arena_.push_back({hypo.node, token});
+    Hypothesis extended = hypo;
+    extended.node = arena_.size() - 1;
+    extended.length = hypo.length + 1;
+    extended.key = ExtendKey(hypo.key, token);
+    return extended;
+  }
+
+  // Drops the nodes of the arena that are not tokens of the beam, which holds
+  // the only hypotheses left at the end of a frame, so that the arena only
+  // grows with the tokens of the beam.
+  void CompactArena() {
+    std::vector<int> index(arena_.size(), -1);
+    for (const Hypothesis& hypo : beam_) {
+      for (int node = hypo.node; node >= 0 && index[node] < 0;
+           node = arena_[node].parent) {
+        index[node] = 0;
+      }
+    }
+    // parents are before their children, so they are moved first.
+    int size = 0;
+    for (size_t node = 0; node < arena_.size(); ++node) {
+      if (index[node] >= 0) {
+        const int parent = arena_[node].parent;
+        arena_[size] = {parent < 0 ? -1 : index[parent], arena_[node].token};
+        index[node] = size++;
+      }
+    }
+    arena_.resize(size);
+    for (Hypothesis& hypo : beam_) {
+      if (hypo.node >= 0) {
+        hypo.node = index[hypo.node];
+      }
+    }
+  }
+
+  std::vector<int64_t> Tokens(const Hypothesis& hypo) const {
+    std::vector<int64_t> tokens(hypo.length);
+    for (int node = hypo.node, i = hypo.length - 1; node >= 0;
+         node = arena_[node].parent, --i) {
+      tokens[i] = arena_[node].token;
+    }
+    return tokens;
+  }
+
+  bool SameTokens(const Hypothesis& x, const Hypothesis& y) const {
+    if (x.key != y.key || x.length != y.length) {
+      return false;
+    }
+    for (int i = x.node, j = y.node; i != j;
+         i = arena_[i].parent, j = arena_[j].parent) {
+      if (arena_[i].token != arena_[j].token) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Adds the blank extension of hypo to the beam, or merges it with the
+  // hypothesis of the beam that has the same tokens.
+  void MergeIntoBeam(const Hypothesis& hypo, double score) {
+    std::vector<int>& sameKey = beamIndex_[hypo.key];
+    for (int i : sameKey) {
+      if (SameTokens(beam_[i], hypo)) {
+        double merged = LogAddExp(beam_[i].score, score);
+        beam_[i] = hypo;
+        beam_[i].score = merged;
+        return;
+      }
+    }
+    sameKey.push_back(beam_.size());
+    beam_.push_back(hypo);
+    beam_.back().score = score;
+  }
+
+  // Gathers the predictor outputs (and states) of the hypotheses, in order,
+  // with one index_select per run of hypotheses of the same batch.
+  PredictorBatch Gather(const std::vector<Hypothesis>& hypos, bool withState)
+      const {
+    std::vector<torch::Tensor> outs;
+    std::vector<std::vector<torch::Tensor>> states;
+    for (size_t begin = 0, end = 0; begin < hypos.size(); begin = end) {
+      const PredictorBatch& batch = batches_[hypos[begin].batch];
+      std::vector<int64_t> rows;
+      for (end = begin;
+           end < hypos.size() && hypos[end].batch == hypos[begin].batch;
+           ++end) {
+        rows.push_back(hypos[end].row);
+      }
+      bool whole = int64_t(rows.size()) == batch.out.size(0);
+      for (size_t i = 0; whole && i < rows.size(); ++i) {
+        whole = rows[i] == int64_t(i);
+      }
+      torch::Tensor index;
+      if (!whole) {
+        index = torch::tensor(rows, torch::kInt64).to(batch.out.device());
+      }
+      outs.push_back(whole ? batch.out : batch.out.index_select(0, index));
+      if (withState) {
+        std::vector<torch::Tensor> state;
+        for (const torch::Tensor& component : batch.state) {
+          state.push_back(
+              whole ? component
+                    : component.index_select(0, index.to(component.device())));
+        }
+        states.push_back(std::move(state));
+      }
+    }
+
+    PredictorBatch gathered;
+    gathered.out = outs.size() == 1 ? outs[0] : torch::cat(outs);
+    if (withState && !states.empty()) {
+      for (size_t c = 0; c < states[0].size(); ++c) {
+        std::vector<torch::Tensor> parts;
+        for (const auto& state : states) {
+          parts.push_back(state[c]);
+        }
+        gathered.state.push_back(
+            parts.size() == 1 ? parts[0] : torch::cat(parts));
+      }
+    }
+    return gathered;
+  }
+
+  const int64_t beamWidth_;
+  const int64_t stepMaxTokens_;
+  int64_t symbols_ = 0; // non-blank tokens emitted in the current frame.
+
+  std::vector<TokenNode> arena_;
+  std::vector<PredictorBatch> batches_;
+  std::vector<Hypothesis> active_; // hypotheses to expand.
+  std::vector<Hypothesis> beam_; // hypotheses that ended the frame.
+  std::unordered_map<uint64_t, std::vector<int>> beamIndex_;
+  std::vector<Expansion> expansions_;
+};
+
+TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
+  m.class_<RNNTBeamSearchEngine>("RNNTBeamSearchEngine")
+      .def(torch::init<int64_t, int64_t>())
+      .def("reset", &RNNTBeamSearchEngine::reset)
+      .def("begin_frame", &RNNTBeamSearchEngine::begin_frame)
+      .def("has_active", &RNNTBeamSearchEngine::has_active)
+      .def("active_predictor_out", &RNNTBeamSearchEngine::active_predictor_out)
+      .def("expand", &RNNTBeamSearchEngine::expand)
+      .def("add_predictions", &RNNTBeamSearchEngine::add_predictions)
+      .def("end_frame", &RNNTBeamSearchEngine::end_frame)
+      .def("hypotheses", &RNNTBeamSearchEngine::hypotheses);
+}
+
+} // namespace rnnt
+} // namespace torchaudio
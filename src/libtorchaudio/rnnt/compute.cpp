@@ -7,7 +7,8 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> rnnt_loss(
     const torch::Tensor& target_lengths,
     int64_t blank,
     double clamp,
-    bool fused_log_softmax = true) {
+    bool fused_log_softmax = true,
+    int64_t num_threads = 0) {
   static auto op = torch::Dispatcher::singleton()
                        .findSchemaOrThrow("torchaudio::rnnt_loss", "")
                        .typed<decltype(rnnt_loss)>();
@@ -18,7 +19,8 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> rnnt_loss(
       target_lengths,
       blank,
       clamp,
-      fused_log_softmax);
+      fused_log_softmax,
+      num_threads);
 }
 
 TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
@@ -29,6 +31,46 @@ TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
       "Tensor target_lengths,"
       "int blank,"
       "float clamp,"
-      "bool fused_log_softmax) -> (Tensor, Tensor?)");
+      "bool fused_log_softmax,"
+      "int num_threads=0) -> (Tensor, Tensor?)");
+  // Same as rnnt_loss, with the gradients written into logits.
+  m.def(
+      "rnnt_loss_reuse_logits(Tensor(a!) logits,"
+      "Tensor targets,"
+      "Tensor logit_lengths,"
+      "Tensor target_lengths,"
+      "int blank,"
+      "float clamp,"
+      "bool fused_log_softmax,"
+      "int num_threads=0) -> (Tensor, Tensor(a!)?)");
+  m.def(
+      "rnnt_loss_deferred(Tensor logits,"
+      "Tensor targets,"
+      "Tensor logit_lengths,"
+      "Tensor target_lengths,"
+      "int blank,"
+      "bool fused_log_softmax,"
+      "int num_threads=0) -> (Tensor, Tensor, Tensor, Tensor)");
+  m.def(
+      "rnnt_loss_deferred_backward(Tensor grad_costs,"
+      "Tensor logits,"
+      "Tensor targets,"
+      "Tensor logit_lengths,"
+      "Tensor target_lengths,"
+      "Tensor denominators,"
+      "Tensor alphas,"
+      "Tensor betas,"
+      "int blank,"
+      "float clamp,"
+      "bool fused_log_softmax,"
+      "int num_threads=0) -> Tensor");
+  m.def(
+      "rnnt_best_path(Tensor logits,"
+      "Tensor targets,"
+      "Tensor logit_lengths,"
+      "Tensor target_lengths,"
+      "int blank,"
+      "bool fused_log_softmax,"
+      "int num_threads=0) -> (Tensor, Tensor, Tensor)");
   m.def("torchaudio::rnnt_loss_forward", &rnnt_loss);
 }
@@ -9,4 +9,5 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> rnnt_loss(
     const torch::Tensor& target_lengths,
     int64_t blank,
     double clamp,
-    bool fused_log_softmax);
+    bool fused_log_softmax,
+    int64_t num_threads);
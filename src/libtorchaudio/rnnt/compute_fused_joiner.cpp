@@ -0,0 +1,30 @@
+#include <torch/script.h>
+
+TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
+  m.def(
+      "rnnt_loss_fused_joiner(Tensor source_encodings,"
+      "Tensor target_encodings,"
+      "Tensor weight,"
+      "Tensor bias,"
+      "Tensor targets,"
+      "Tensor logit_lengths,"
+      "Tensor target_lengths,"
+      "int blank,"
+      "str activation,"
+      "int num_threads=0) -> (Tensor, Tensor, Tensor)");
+  m.def(
+      "rnnt_loss_fused_joiner_backward(Tensor grad_costs,"
+      "Tensor source_encodings,"
+      "Tensor target_encodings,"
+      "Tensor weight,"
+      "Tensor bias,"
+      "Tensor targets,"
+      "Tensor logit_lengths,"
+      "Tensor target_lengths,"
+      "Tensor alphas,"
+      "Tensor betas,"
+      "int blank,"
+      "str activation,"
+      "float clamp,"
+      "int num_threads=0) -> (Tensor, Tensor, Tensor, Tensor)");
+}
@@ -0,0 +1,13 @@
+#include <torch/script.h>
+
+TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
+  m.def(
+      "rnnt_loss_packed(Tensor logits,"
+      "Tensor targets,"
+      "Tensor logit_lengths,"
+      "Tensor target_lengths,"
+      "int blank,"
+      "float clamp,"
+      "bool fused_log_softmax,"
+      "int num_threads=0) -> (Tensor, Tensor?)");
+}
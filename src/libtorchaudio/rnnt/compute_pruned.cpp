@@ -0,0 +1,23 @@
+#include <torch/script.h>
+
+TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
+  m.def(
+      "rnnt_loss_simple(Tensor am,"
+      "Tensor lm,"
+      "Tensor targets,"
+      "Tensor logit_lengths,"
+      "Tensor target_lengths,"
+      "int blank,"
+      "int s_range,"
+      "int num_threads=0) -> (Tensor, Tensor, Tensor, Tensor)");
+  m.def(
+      "rnnt_loss_pruned(Tensor logits,"
+      "Tensor targets,"
+      "Tensor ranges,"
+      "Tensor logit_lengths,"
+      "Tensor target_lengths,"
+      "int blank,"
+      "float clamp,"
+      "bool fused_log_softmax,"
+      "int num_threads=0) -> (Tensor, Tensor?)");
+}
@@ -1,19 +1,21 @@
+#include <libtorchaudio/rnnt/cpu/cpu_best_path_kernels.h>
 #include <libtorchaudio/rnnt/cpu/cpu_transducer.h>
+#include <libtorchaudio/rnnt/cpu/workspace_pool.h>
 #include <torch/script.h>
 
 namespace torchaudio {
 namespace rnnt {
 namespace cpu {
 
-// Entry point into RNNT Loss
-std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
-    torch::Tensor& logits,
+namespace {
+
+void check_inputs(
+    const torch::Tensor& logits,
     const torch::Tensor& targets,
     const torch::Tensor& logit_lengths,
     const torch::Tensor& target_lengths,
     int64_t blank,
-    double clamp,
-    bool fused_log_softmax = true) {
+    int64_t num_threads) {
   TORCH_CHECK(
       logits.device().type() == targets.device().type(),
       "logits and targets must be on the same device");
@@ -25,8 +27,9 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
       "logits and target_lengths must be on the same device");
 
   TORCH_CHECK(
-      logits.dtype() == torch::kFloat32 || logits.dtype() == torch::kFloat16,
-      "logits must be float32 or float16 (half) type");
+      logits.dtype() == torch::kFloat32 || logits.dtype() == torch::kFloat16 ||
+          logits.dtype() == torch::kBFloat16,
+      "logits must be float32, float16 (half) or bfloat16 type");
   TORCH_CHECK(targets.dtype() == torch::kInt32, "targets must be int32 type");
   TORCH_CHECK(
       logit_lengths.dtype() == torch::kInt32,
@@ -62,6 +65,7 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
   TORCH_CHECK(
       blank >= 0 && blank < logits.size(-1),
       "blank must be within [0, logits.shape[-1])");
+  TORCH_CHECK(num_threads >= 0, "num_threads must be non-negative");
 
   TORCH_CHECK(
       logits.size(1) == at::max(logit_lengths).item().toInt(),
@@ -72,7 +76,16 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
   TORCH_CHECK(
       targets.size(1) == at::max(target_lengths).item().toInt(),
       "target length mismatch");
+}
 
+Options make_options(
+    const torch::Tensor& logits,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    double clamp,
+    bool fused_log_softmax,
+    int64_t num_threads) {
   Options options;
   options.batchSize_ = logit_lengths.size(0);
   options.nHypos_ = target_lengths.size(0) / logit_lengths.size(0);
@@ -82,33 +95,42 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
   options.blank_ = blank;
   options.clamp_ = clamp;
   options.fusedLogSmax_ = fused_log_softmax;
+  options.numThreads_ = num_threads;
 
   TORCH_CHECK_EQ(logits.device().type(), torch::DeviceType::CPU);
   options.device_ = CPU;
 
+  return options;
+}
+
+// Computes the costs, and writes the gradients into gradients, which may be
+// logits itself.
+torch::Tensor compute_costs_and_gradients(
+    const torch::Tensor& logits,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    double clamp,
+    bool fused_log_softmax,
+    int64_t num_threads,
+    torch::Tensor& gradients) {
+  check_inputs(
+      logits, targets, logit_lengths, target_lengths, blank, num_threads);
+  Options options = make_options(
+      logits,
+      logit_lengths,
+      target_lengths,
+      blank,
+      clamp,
+      fused_log_softmax,
+      num_threads);
+
   torch::Tensor costs = torch::empty(
       options.batchSize_ * options.nHypos_,
       torch::TensorOptions().device(logits.device()).dtype(logits.dtype()));
-  std::optional<torch::Tensor> gradients = torch::zeros_like(logits);
-
-  torch::Tensor int_workspace = torch::empty(
-      IntWorkspace::ComputeSizeFromOptions(options),
-      torch::TensorOptions()
-          .device(logits.device())
-          .dtype(torch::ScalarType::Int));
-
-  torch::Tensor float_workspace = torch::empty(
-      DtypeWorkspace<float>::ComputeSizeFromOptions(options),
-      torch::TensorOptions()
-          .device(logits.device())
-          .dtype(torch::ScalarType::Float));
-
-  Workspace<float> workspace(
-      /*options=*/options,
-      /*dtype_data=*/float_workspace.data_ptr<float>(),
-      /*dtype_size=*/float_workspace.numel(),
-      /*int_data=*/int_workspace.data_ptr<int>(),
-      /*int_size=*/int_workspace.numel());
+  PooledWorkspace pooled_workspace(options);
+  Workspace<float>& workspace = pooled_workspace.Get();
 
   switch (logits.scalar_type()) {
     case torch::ScalarType::Float: {
@@ -119,7 +141,7 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
           /*srcLengths=*/logit_lengths.data_ptr<int>(),
           /*tgtLengths=*/target_lengths.data_ptr<int>(),
           /*costs=*/costs.data_ptr<float>(),
-          /*gradients=*/gradients->data_ptr<float>());
+          /*gradients=*/gradients.data_ptr<float>());
       break;
     }
     case torch::ScalarType::Half: {
@@ -130,7 +152,18 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
           /*srcLengths=*/logit_lengths.data_ptr<int>(),
           /*tgtLengths=*/target_lengths.data_ptr<int>(),
           /*costs=*/costs.data_ptr<c10::Half>(),
-          /*gradients=*/gradients->data_ptr<c10::Half>());
+          /*gradients=*/gradients.data_ptr<c10::Half>());
+      break;
+    }
+    case torch::ScalarType::BFloat16: {
+      Compute</*DTYPE=*/c10::BFloat16, /*CAST_DTYPE=*/float>(
+          /*workspace=*/workspace,
+          /*logits=*/logits.data_ptr<c10::BFloat16>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*srcLengths=*/logit_lengths.data_ptr<int>(),
+          /*tgtLengths=*/target_lengths.data_ptr<int>(),
+          /*costs=*/costs.data_ptr<c10::BFloat16>(),
+          /*gradients=*/gradients.data_ptr<c10::BFloat16>());
       break;
     }
     default: {
@@ -138,11 +171,364 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
     }
   };
 
+  return costs;
+}
+
+} // namespace
+
+// Entry point into RNNT Loss
+std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
+    torch::Tensor& logits,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    double clamp,
+    bool fused_log_softmax = true,
+    int64_t num_threads = 0) {
+  // every element is written by ComputeGradients, including the padding.
+  torch::Tensor gradients = torch::empty_like(logits);
+  torch::Tensor costs = compute_costs_and_gradients(
+      logits,
+      targets,
+      logit_lengths,
+      target_lengths,
+      blank,
+      clamp,
+      fused_log_softmax,
+      num_threads,
+      gradients);
   return std::make_tuple(costs, gradients);
 }
 
+// Same as compute, with the gradients written into the storage of the logits.
+// Each element of the logits is read before the gradient is written to the
+// same location, so the gradients can overwrite the logits.
+std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute_reuse_logits(
+    torch::Tensor& logits,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    double clamp,
+    bool fused_log_softmax = true,
+    int64_t num_threads = 0) {
+  torch::Tensor costs = compute_costs_and_gradients(
+      logits,
+      targets,
+      logit_lengths,
+      target_lengths,
+      blank,
+      clamp,
+      fused_log_softmax,
+      num_threads,
+      logits);
+  return std::make_tuple(costs, logits);
+}
+
+// Forward pass of RNNT Loss without gradients. Returns the costs, and the
+// denominators, alphas and betas that compute_deferred_backward needs.
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+compute_deferred(
+    const torch::Tensor& logits,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    bool fused_log_softmax = true,
+    int64_t num_threads = 0) {
+  check_inputs(
+      logits, targets, logit_lengths, target_lengths, blank, num_threads);
+  Options options = make_options(
+      logits,
+      logit_lengths,
+      target_lengths,
+      blank,
+      /*clamp=*/-1,
+      fused_log_softmax,
+      num_threads);
+
+  torch::Tensor costs = torch::empty(
+      options.batchSize_ * options.nHypos_,
+      torch::TensorOptions().device(logits.device()).dtype(logits.dtype()));
+  torch::TensorOptions floatOptions =
+      torch::TensorOptions().device(logits.device()).dtype(torch::kFloat32);
+  // the buffers saved for the backward pass are allocated, the log probs are
+  // scratch from the workspace pool.
+  torch::Tensor denominators = torch::empty(
+      {logits.size(0), logits.size(1), logits.size(2)}, floatOptions);
+  torch::Tensor alphas = torch::empty_like(denominators);
+  torch::Tensor betas = torch::empty_like(denominators);
+  PooledWorkspace pooled_workspace(options);
+  float* logProbs = pooled_workspace.Get().GetPointerToLogProbs();
+
+  switch (logits.scalar_type()) {
+    case torch::ScalarType::Float: {
+      ComputeDeferred</*DTYPE=*/float, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*logits=*/logits.data_ptr<float>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*srcLengths=*/logit_lengths.data_ptr<int>(),
+          /*tgtLengths=*/target_lengths.data_ptr<int>(),
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*logProbs=*/logProbs,
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*costs=*/costs.data_ptr<float>());
+      break;
+    }
+    case torch::ScalarType::Half: {
+      ComputeDeferred</*DTYPE=*/c10::Half, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*logits=*/logits.data_ptr<c10::Half>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*srcLengths=*/logit_lengths.data_ptr<int>(),
+          /*tgtLengths=*/target_lengths.data_ptr<int>(),
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*logProbs=*/logProbs,
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*costs=*/costs.data_ptr<c10::Half>());
+      break;
+    }
+    case torch::ScalarType::BFloat16: {
+      ComputeDeferred</*DTYPE=*/c10::BFloat16, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*logits=*/logits.data_ptr<c10::BFloat16>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*srcLengths=*/logit_lengths.data_ptr<int>(),
+          /*tgtLengths=*/target_lengths.data_ptr<int>(),
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*logProbs=*/logProbs,
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*costs=*/costs.data_ptr<c10::BFloat16>());
+      break;
+    }
+    default: {
+      break;
+    }
+  };
+
+  return std::make_tuple(costs, denominators, alphas, betas);
+}
+
+// Backward pass of RNNT Loss: gradients of the logits, scaled by grad_costs,
+// from the buffers saved by compute_deferred.
+torch::Tensor compute_deferred_backward(
+    const torch::Tensor& grad_costs,
+    const torch::Tensor& logits,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    const torch::Tensor& denominators,
+    const torch::Tensor& alphas,
+    const torch::Tensor& betas,
+    int64_t blank,
+    double clamp,
+    bool fused_log_softmax = true,
+    int64_t num_threads = 0) {
+  check_inputs(
+      logits, targets, logit_lengths, target_lengths, blank, num_threads);
+  Options options = make_options(
+      logits,
+      logit_lengths,
+      target_lengths,
+      blank,
+      clamp,
+      fused_log_softmax,
+      num_threads);
+
+  for (const torch::Tensor* saved : {&denominators, &alphas, &betas}) {
+    TORCH_CHECK(
+        saved->dtype() == torch::kFloat32 && saved->is_contiguous() &&
+            saved->dim() == 3 && saved->size(0) == logits.size(0) &&
+            saved->size(1) == logits.size(1) &&
+            saved->size(2) == logits.size(2),
+        "denominators, alphas and betas must be contiguous float32 tensors ",
+        "of dimension (batch, time, target)");
+  }
+  TORCH_CHECK(
+      grad_costs.dim() == 1 && grad_costs.size(0) == logits.size(0),
+      "grad_costs must be 1-D (batch)");
+
+  // every element is written by ComputeGradients, including the padding.
+  torch::Tensor gradients = torch::empty_like(logits);
+
+  switch (logits.scalar_type()) {
+    case torch::ScalarType::Float: {
+      ComputeGradients</*DTYPE=*/float, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*logits=*/logits.data_ptr<float>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*srcLengths=*/logit_lengths.data_ptr<int>(),
+          /*tgtLengths=*/target_lengths.data_ptr<int>(),
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*gradients=*/gradients.data_ptr<float>());
+      break;
+    }
+    case torch::ScalarType::Half: {
+      ComputeGradients</*DTYPE=*/c10::Half, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*logits=*/logits.data_ptr<c10::Half>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*srcLengths=*/logit_lengths.data_ptr<int>(),
+          /*tgtLengths=*/target_lengths.data_ptr<int>(),
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*gradients=*/gradients.data_ptr<c10::Half>());
+      break;
+    }
+    case torch::ScalarType::BFloat16: {
+      ComputeGradients</*DTYPE=*/c10::BFloat16, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*logits=*/logits.data_ptr<c10::BFloat16>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*srcLengths=*/logit_lengths.data_ptr<int>(),
+          /*tgtLengths=*/target_lengths.data_ptr<int>(),
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*gradients=*/gradients.data_ptr<c10::BFloat16>());
+      break;
+    }
+    default: {
+      break;
+    }
+  };
+
+  return gradients.mul_(grad_costs.to(gradients.dtype()).view({-1, 1, 1, 1}));
+}
+
+namespace {
+
+template <typename DTYPE>
+void compute_best_paths(
+    const Options& options,
+    const torch::Tensor& logits,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    torch::Tensor& paths,
+    torch::Tensor& labels,
+    torch::Tensor& step_scores) {
+  PooledWorkspace pooled_workspace(options);
+  Workspace<float>& workspace = pooled_workspace.Get();
+
+  LogSumExp2D<DTYPE, float>(
+      /*options=*/options,
+      /*N=*/options.BTU(),
+      /*D=*/options.numTargets_,
+      /*logits=*/logits.data_ptr<DTYPE>(),
+      /*denominators=*/workspace.GetPointerToDenominators());
+  ComputeLogProbs<DTYPE, float>(
+      /*options=*/options,
+      /*logits=*/logits.data_ptr<DTYPE>(),
+      /*targets=*/targets.data_ptr<int>(),
+      /*srcLengths=*/logit_lengths.data_ptr<int>(),
+      /*tgtLengths=*/target_lengths.data_ptr<int>(),
+      /*denominators=*/workspace.GetPointerToDenominators(),
+      /*log_probs=*/workspace.GetPointerToLogProbs());
+  ComputeBestPaths<DTYPE, float>(
+      /*options=*/options,
+      /*logProbs=*/workspace.GetPointerToLogProbs(),
+      /*targets=*/targets.data_ptr<int>(),
+      /*srcLengths=*/logit_lengths.data_ptr<int>(),
+      /*tgtLengths=*/target_lengths.data_ptr<int>(),
+      /*paths=*/paths.data_ptr<int>(),
+      /*labels=*/labels.data_ptr<int>(),
+      /*stepScores=*/step_scores.data_ptr<float>());
+}
+
+} // namespace
+
+// Best path (Viterbi) alignment of the RNNT lattice. Returns the (t, u) node,
+// the emitted label and the log prob of each of the
+// logit_lengths[b] + target_lengths[b] steps of the best path.
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor> compute_best_path(
+    const torch::Tensor& logits,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    bool fused_log_softmax = true,
+    int64_t num_threads = 0) {
+  check_inputs(
+      logits, targets, logit_lengths, target_lengths, blank, num_threads);
+  Options options = make_options(
+      logits,
+      logit_lengths,
+      target_lengths,
+      blank,
+      /*clamp=*/-1,
+      fused_log_softmax,
+      num_threads);
+  options.backtrack_ = true;
+
+  const int64_t B = logits.size(0);
+  const int64_t maxSteps = logits.size(1) + logits.size(2) - 1;
+  torch::TensorOptions intOptions =
+      torch::TensorOptions().device(logits.device()).dtype(torch::kInt32);
+  torch::TensorOptions floatOptions =
+      torch::TensorOptions().device(logits.device()).dtype(torch::kFloat32);
+  torch::Tensor paths = torch::empty({B, maxSteps, 2}, intOptions);
+  torch::Tensor labels = torch::empty({B, maxSteps}, intOptions);
+  torch::Tensor step_scores = torch::empty({B, maxSteps}, floatOptions);
+
+  switch (logits.scalar_type()) {
+    case torch::ScalarType::Float: {
+      compute_best_paths<float>(
+          options,
+          logits,
+          targets,
+          logit_lengths,
+          target_lengths,
+          paths,
+          labels,
+          step_scores);
+      break;
+    }
+    case torch::ScalarType::Half: {
+      compute_best_paths<c10::Half>(
+          options,
+          logits,
+          targets,
+          logit_lengths,
+          target_lengths,
+          paths,
+          labels,
+          step_scores);
+      break;
+    }
+    case torch::ScalarType::BFloat16: {
+      compute_best_paths<c10::BFloat16>(
+          options,
+          logits,
+          targets,
+          logit_lengths,
+          target_lengths,
+          paths,
+          labels,
+          step_scores);
+      break;
+    }
+    default: {
+      TORCH_CHECK(false, "unsupported dtype ", logits.scalar_type());
+    }
+  };
+
+  return std::make_tuple(paths, labels, step_scores);
+}
+
 TORCH_LIBRARY_IMPL(torchaudio, CPU, m) {
   m.impl("rnnt_loss", &compute);
+  m.impl("rnnt_loss_reuse_logits", &compute_reuse_logits);
+  m.impl("rnnt_loss_deferred", &compute_deferred);
+  m.impl("rnnt_loss_deferred_backward", &compute_deferred_backward);
+  m.impl("rnnt_best_path", &compute_best_path);
 }
 
 } // namespace cpu
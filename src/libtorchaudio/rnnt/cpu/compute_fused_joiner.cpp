@@ -0,0 +1,385 @@
+#include <libtorchaudio/rnnt/cpu/cpu_kernels.h>
+#include <torch/script.h>
+
+namespace torchaudio {
+namespace rnnt {
+namespace cpu {
+
+namespace {
+
+// Number of (t, u) cells whose logits are materialized at once.
+constexpr int kTileCells = 256;
+
+enum class Activation { kReLU, kTanh };
+
+Activation parse_activation(const std::string& activation) {
+  if (activation == "relu") {
+    return Activation::kReLU;
+  }
+  TORCH_CHECK(
+      activation == "tanh",
+      "activation must be one of (\"relu\", \"tanh\"). Found: ",
+      activation);
+  return Activation::kTanh;
+}
+
+void check_inputs(
+    const torch::Tensor& source_encodings,
+    const torch::Tensor& target_encodings,
+    const torch::Tensor& weight,
+    const torch::Tensor& bias,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    int64_t num_threads) {
+  TORCH_CHECK_EQ(source_encodings.device().type(), torch::DeviceType::CPU);
+  TORCH_CHECK(
+      source_encodings.dtype() == torch::kFloat32 ||
+          source_encodings.dtype() == torch::kFloat16 ||
+          source_encodings.dtype() == torch::kBFloat16,
+      "source_encodings must be float32, float16 (half) or bfloat16 type");
+  TORCH_CHECK(
+      target_encodings.dtype() == source_encodings.dtype() &&
+          weight.dtype() == source_encodings.dtype() &&
+          bias.dtype() == source_encodings.dtype(),
+      "source_encodings, target_encodings, weight and bias must have the "
+      "same type");
+  TORCH_CHECK(targets.dtype() == torch::kInt32, "targets must be int32 type");
+  TORCH_CHECK(
+      logit_lengths.dtype() == torch::kInt32,
+      "logit_lengths must be int32 type");
+  TORCH_CHECK(
+      target_lengths.dtype() == torch::kInt32,
+      "target_lengths must be int32 type");
+  TORCH_CHECK(targets.is_contiguous(), "targets must be contiguous");
+
+  TORCH_CHECK(
+      source_encodings.dim() == 3,
+      "source_encodings must be 3-D (batch, time, hidden)");
+  TORCH_CHECK(
+      target_encodings.dim() == 3,
+      "target_encodings must be 3-D (batch, target, hidden)");
+  TORCH_CHECK(weight.dim() == 2, "weight must be 2-D (class, hidden)");
+  TORCH_CHECK(bias.dim() == 1, "bias must be 1-D (class)");
+  TORCH_CHECK(
+      targets.dim() == 2, "targets must be 2-D (batch, max target length)");
+  TORCH_CHECK(logit_lengths.dim() == 1, "logit_lengths must be 1-D");
+  TORCH_CHECK(target_lengths.dim() == 1, "target_lengths must be 1-D");
+
+  const int64_t B = source_encodings.size(0);
+  TORCH_CHECK(
+      target_encodings.size(0) == B && targets.size(0) == B &&
+          logit_lengths.size(0) == B && target_lengths.size(0) == B,
+      "batch dimension mismatch");
+  TORCH_CHECK(
+      target_encodings.size(2) == source_encodings.size(2) &&
+          weight.size(1) == source_encodings.size(2),
+      "hidden dimension mismatch");
+  TORCH_CHECK(bias.size(0) == weight.size(0), "class dimension mismatch");
+  TORCH_CHECK(
+      blank >= 0 && blank < weight.size(0),
+      "blank must be within [0, weight.shape[0])");
+  TORCH_CHECK(num_threads >= 0, "num_threads must be non-negative");
+
+  TORCH_CHECK(
+      source_encodings.size(1) == at::max(logit_lengths).item().toInt(),
+      "input length mismatch");
+  TORCH_CHECK(
+      target_encodings.size(1) == at::max(target_lengths).item().toInt() + 1,
+      "output length mismatch");
+  TORCH_CHECK(
+      targets.size(1) == at::max(target_lengths).item().toInt(),
+      "target length mismatch");
+}
+
+Options make_options(
+    const torch::Tensor& source_encodings,
+    const torch::Tensor& target_encodings,
+    const torch::Tensor& weight,
+    int64_t blank,
+    int64_t num_threads) {
+  Options options;
+  options.batchSize_ = source_encodings.size(0);
+  options.maxSrcLen_ = source_encodings.size(1);
+  options.maxTgtLen_ = target_encodings.size(1);
+  options.numTargets_ = weight.size(0);
+  options.blank_ = blank;
+  options.numThreads_ = num_threads;
+  options.device_ = CPU;
+  return options;
+}
+
+// Joiner output of the cells [t0, t0 + nt) x [0, U) of one sequence:
+// hidden = activation(source[t] + target[u]), of shape (nt * U, H), and
+// logits = hidden @ weight^T + bias, of shape (nt * U, D).
+std::tuple<torch::Tensor, torch::Tensor> join_tile(
+    const torch::Tensor& source,
+    const torch::Tensor& target,
+    const torch::Tensor& weight,
+    const torch::Tensor& bias,
+    Activation activation,
+    int t0,
+    int nt,
+    int U) {
+  torch::Tensor hidden =
+      source.narrow(0, t0, nt).unsqueeze(1) + target.narrow(0, 0, U);
+  hidden = hidden.reshape({nt * U, -1});
+  if (activation == Activation::kReLU) {
+    hidden.relu_();
+  } else {
+    hidden.tanh_();
+  }
+  torch::Tensor logits = torch::addmm(bias, hidden, weight.t());
+  return std::make_tuple(hidden, logits);
+}
+
+int tile_rows(int U) {
+  return std::max(1, kTileCells / U);
+}
+
+} // namespace
+
+// Transducer loss of the joiner
+//   logits(t, u) = weight @ activation(source(t) + target(u)) + bias
+// computed tile by tile, so that the (B, T, U, D) logits are never
+// materialized. Returns the costs with the alphas and betas the backward pass
+// needs to recompute the gradients.
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor> compute_fused_joiner(
+    const torch::Tensor& source_encodings,
+    const torch::Tensor& target_encodings,
+    const torch::Tensor& weight,
+    const torch::Tensor& bias,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    const std::string& activation,
+    int64_t num_threads = 0) {
+  check_inputs(
+      source_encodings,
+      target_encodings,
+      weight,
+      bias,
+      targets,
+      logit_lengths,
+      target_lengths,
+      blank,
+      num_threads);
+  const Activation act = parse_activation(activation);
+  const Options options = make_options(
+      source_encodings, target_encodings, weight, blank, num_threads);
+
+  const int& B = options.batchSize_;
+  const int& maxT = options.maxSrcLen_;
+  const int& maxU = options.maxTgtLen_;
+  const int& D = options.numTargets_;
+
+  const torch::Tensor source = source_encodings.to(torch::kFloat32);
+  const torch::Tensor target = target_encodings.to(torch::kFloat32);
+  const torch::Tensor w = weight.to(torch::kFloat32);
+  const torch::Tensor bs = bias.to(torch::kFloat32);
+  const int* targetsData = targets.data_ptr<int>();
+  const torch::Tensor srcLengths = logit_lengths.contiguous();
+  const torch::Tensor tgtLengths = target_lengths.contiguous();
+
+  torch::TensorOptions floatOptions =
+      torch::TensorOptions().device(source.device()).dtype(torch::kFloat32);
+  torch::Tensor logProbs = torch::empty({B, maxT, maxU, 2}, floatOptions);
+  torch::Tensor alphas = torch::zeros({B, maxT, maxU}, floatOptions);
+  torch::Tensor betas = torch::zeros({B, maxT, maxU}, floatOptions);
+  torch::Tensor costs = torch::empty({B}, floatOptions);
+
+  ParallelFor(options, B, [&](int b) {
+    const int T = srcLengths.data_ptr<int>()[b];
+    const int U = tgtLengths.data_ptr<int>()[b] + 1; // with prepended blank.
+    const int* seqTargets = targetsData + b * (maxU - 1);
+    const int64_t offset = int64_t(b) * maxT * maxU;
+    LogProbs<float>* logProbsData =
+        reinterpret_cast<LogProbs<float>*>(logProbs.data_ptr<float>()) +
+        offset;
+    TensorView<LogProbs<float>, 2> seqLogProbs({maxT, maxU}, logProbsData);
+
+    const int rows = tile_rows(U);
+    for (int t0 = 0; t0 < T; t0 += rows) {
+      const int nt = std::min(rows, T - t0);
+      torch::Tensor logits = std::get<1>(join_tile(
+          source[b], target[b], w, bs, act, t0, nt, U));
+      const float* logitsData = logits.data_ptr<float>();
+      for (int i = 0; i < nt * U; ++i) {
+        const float* row = logitsData + int64_t(i) * D;
+        const int t = t0 + i / U;
+        const int u = i % U;
+        const float denom = RowLogSumExp(row, D);
+        seqLogProbs({t, u}).skip() = row[blank] - denom;
+        seqLogProbs({t, u}).emit() =
+            (u < U - 1) ? row[seqTargets[u]] - denom : 0.f;
+      }
+    }
+
+    TensorView<const LogProbs<float>, 2> constLogProbs(
+        {maxT, maxU}, logProbsData);
+    TensorView<float, 2> alpha(
+        {maxT, maxU}, alphas.data_ptr<float>() + offset);
+    TensorView<float, 2> beta({maxT, maxU}, betas.data_ptr<float>() + offset);
+    ComputeAlphaOneSequence<float>(constLogProbs, T, U, alpha);
+    costs.data_ptr<float>()[b] =
+        -ComputeBetaOneSequence<float>(constLogProbs, T, U, beta);
+  });
+
+  return std::make_tuple(costs.to(source_encodings.dtype()), alphas, betas);
+}
+
+// Recomputes the joiner logits tile by tile, turns them into the gradients of
+// the costs scaled by grad_costs, and backpropagates them through the joiner.
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+compute_fused_joiner_backward(
+    const torch::Tensor& grad_costs,
+    const torch::Tensor& source_encodings,
+    const torch::Tensor& target_encodings,
+    const torch::Tensor& weight,
+    const torch::Tensor& bias,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    const torch::Tensor& alphas,
+    const torch::Tensor& betas,
+    int64_t blank,
+    const std::string& activation,
+    double clamp,
+    int64_t num_threads = 0) {
+  check_inputs(
+      source_encodings,
+      target_encodings,
+      weight,
+      bias,
+      targets,
+      logit_lengths,
+      target_lengths,
+      blank,
+      num_threads);
+  const Activation act = parse_activation(activation);
+  const Options options = make_options(
+      source_encodings, target_encodings, weight, blank, num_threads);
+
+  const int& B = options.batchSize_;
+  const int& maxT = options.maxSrcLen_;
+  const int& maxU = options.maxTgtLen_;
+  const int& D = options.numTargets_;
+  TORCH_CHECK(
+      alphas.dtype() == torch::kFloat32 && betas.dtype() == torch::kFloat32,
+      "alphas and betas must be float32 type");
+  TORCH_CHECK(
+      alphas.is_contiguous() && betas.is_contiguous(),
+      "alphas and betas must be contiguous");
+  TORCH_CHECK(
+      alphas.numel() == int64_t(B) * maxT * maxU &&
+          betas.numel() == int64_t(B) * maxT * maxU,
+      "alphas and betas must be of shape (batch, time, target)");
+
+  const torch::Tensor source = source_encodings.to(torch::kFloat32);
+  const torch::Tensor target = target_encodings.to(torch::kFloat32);
+  const torch::Tensor w = weight.to(torch::kFloat32);
+  const torch::Tensor bs = bias.to(torch::kFloat32);
+  const torch::Tensor scales = grad_costs.to(torch::kFloat32).contiguous();
+  const int* targetsData = targets.data_ptr<int>();
+  const torch::Tensor srcLengths = logit_lengths.contiguous();
+  const torch::Tensor tgtLengths = target_lengths.contiguous();
+  const float clampValue = clamp;
+
+  torch::Tensor sourceGrad = torch::zeros_like(source);
+  torch::Tensor targetGrad = torch::zeros_like(target);
+  // the joiner parameters are shared by all the sequences: every thread
+  // accumulates its own gradients, which are summed at the end.
+  std::vector<torch::Tensor> weightGrads(at::get_num_threads());
+  std::vector<torch::Tensor> biasGrads(at::get_num_threads());
+
+  ParallelFor(options, B, [&](int b) {
+    const int T = srcLengths.data_ptr<int>()[b];
+    const int U = tgtLengths.data_ptr<int>()[b] + 1; // with prepended blank.
+    const int* seqTargets = targetsData + b * (maxU - 1);
+    const int64_t offset = int64_t(b) * maxT * maxU;
+    TensorView<const float, 2> alpha(
+        {maxT, maxU}, alphas.data_ptr<float>() + offset);
+    TensorView<const float, 2> beta(
+        {maxT, maxU}, betas.data_ptr<float>() + offset);
+    const float cost = -beta({0, 0});
+    const float scale = scales.data_ptr<float>()[b];
+
+    const int thread = at::get_thread_num();
+    if (!weightGrads[thread].defined()) {
+      weightGrads[thread] = torch::zeros_like(w);
+      biasGrads[thread] = torch::zeros_like(bs);
+    }
+
+    const int rows = tile_rows(U);
+    for (int t0 = 0; t0 < T; t0 += rows) {
+      const int nt = std::min(rows, T - t0);
+      torch::Tensor hidden, logits;
+      std::tie(hidden, logits) =
+          join_tile(source[b], target[b], w, bs, act, t0, nt, U);
+
+      // logits -> d(cost) / d(logits), in place. Same as the fused log
+      // softmax gradients of ComputeGradientsOneSequence.
+      float* grads = logits.data_ptr<float>();
+      for (int i = 0; i < nt * U; ++i) {
+        float* row = grads + int64_t(i) * D;
+        const int t = t0 + i / U;
+        const int u = i % U;
+        const float c = alpha({t, u}) + cost - RowLogSumExp(row, D);
+        for (int d = 0; d < D; ++d) {
+          const float g = row[d] + c;
+          float grad = std::exp(g + beta({t, u}));
+          if (d == blank && t == T - 1 && u == U - 1) {
+            grad -= std::exp(g);
+          } else if (d == blank && t < T - 1) {
+            grad -= std::exp(g + beta({t + 1, u}));
+          } else if (u < U - 1 && d == seqTargets[u]) {
+            grad -= std::exp(g + beta({t, u + 1}));
+          }
+          if (clampValue > 0) {
+            grad = math::min(grad, clampValue);
+            grad = math::max(grad, -clampValue);
+          }
+          row[d] = grad * scale;
+        }
+      }
+
+      weightGrads[thread].addmm_(logits.t(), hidden);
+      biasGrads[thread].add_(logits.sum(0));
+      torch::Tensor hiddenGrad = torch::mm(logits, w);
+      if (act == Activation::kReLU) {
+        hiddenGrad.mul_(hidden > 0);
+      } else {
+        hiddenGrad.mul_(1 - hidden * hidden);
+      }
+      hiddenGrad = hiddenGrad.view({nt, U, -1});
+      sourceGrad[b].narrow(0, t0, nt).add_(hiddenGrad.sum(1));
+      targetGrad[b].narrow(0, 0, U).add_(hiddenGrad.sum(0));
+    }
+  });
+
+  torch::Tensor weightGrad = torch::zeros_like(w);
+  torch::Tensor biasGrad = torch::zeros_like(bs);
+  for (size_t i = 0; i < weightGrads.size(); ++i) {
+    if (weightGrads[i].defined()) {
+      weightGrad.add_(weightGrads[i]);
+      biasGrad.add_(biasGrads[i]);
+    }
+  }
+
+  return std::make_tuple(
+      sourceGrad.to(source_encodings.dtype()),
+      targetGrad.to(target_encodings.dtype()),
+      weightGrad.to(weight.dtype()),
+      biasGrad.to(bias.dtype()));
+}
+
+TORCH_LIBRARY_IMPL(torchaudio, CPU, m) {
+  m.impl("rnnt_loss_fused_joiner", &compute_fused_joiner);
+  m.impl("rnnt_loss_fused_joiner_backward", &compute_fused_joiner_backward);
+}
+
+} // namespace cpu
+} // namespace rnnt
+} // namespace torchaudio
@@ -0,0 +1,166 @@
+#include <libtorchaudio/rnnt/cpu/cpu_packed_kernels.h>
+#include <torch/script.h>
+
+#include <limits>
+
+namespace torchaudio {
+namespace rnnt {
+namespace cpu {
+
+// Entry point into RNNT Loss on packed logits of dimension
+// (sum_b logit_lengths[b] * (target_lengths[b] + 1), class).
+std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute_packed(
+    torch::Tensor& logits,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    double clamp,
+    bool fused_log_softmax = true,
+    int64_t num_threads = 0) {
+  TORCH_CHECK_EQ(logits.device().type(), torch::DeviceType::CPU);
+  TORCH_CHECK(
+      logits.dtype() == torch::kFloat32 || logits.dtype() == torch::kFloat16 ||
+          logits.dtype() == torch::kBFloat16,
+      "logits must be float32, float16 (half) or bfloat16 type");
+  TORCH_CHECK(targets.dtype() == torch::kInt32, "targets must be int32 type");
+  TORCH_CHECK(
+      logit_lengths.dtype() == torch::kInt32,
+      "logit_lengths must be int32 type");
+  TORCH_CHECK(
+      target_lengths.dtype() == torch::kInt32,
+      "target_lengths must be int32 type");
+
+  TORCH_CHECK(logits.is_contiguous(), "logits must be contiguous");
+  TORCH_CHECK(targets.is_contiguous(), "targets must be contiguous");
+  TORCH_CHECK(
+      logit_lengths.is_contiguous(), "logit_lengths must be contiguous");
+  TORCH_CHECK(
+      target_lengths.is_contiguous(), "target_lengths must be contiguous");
+
+  TORCH_CHECK(logits.dim() == 2, "logits must be 2-D (cell, class)");
+  TORCH_CHECK(
+      targets.dim() == 2, "targets must be 2-D (batch, max target length)");
+  TORCH_CHECK(logit_lengths.dim() == 1, "logit_lengths must be 1-D");
+  TORCH_CHECK(target_lengths.dim() == 1, "target_lengths must be 1-D");
+
+  TORCH_CHECK(
+      target_lengths.size(0) == logit_lengths.size(0),
+      "batch dimension mismatch between logit_lengths and target_lengths");
+  TORCH_CHECK(
+      targets.size(0) == logit_lengths.size(0),
+      "batch dimension mismatch between logit_lengths and targets");
+  TORCH_CHECK(
+      targets.size(1) == at::max(target_lengths).item().toInt(),
+      "target length mismatch");
+
+  TORCH_CHECK(
+      blank >= 0 && blank < logits.size(-1),
+      "blank must be within [0, logits.shape[-1])");
+  TORCH_CHECK(num_threads >= 0, "num_threads must be non-negative");
+
+  const int B = logit_lengths.size(0);
+  const int* srcLengths = logit_lengths.data_ptr<int>();
+  const int* tgtLengths = target_lengths.data_ptr<int>();
+  std::vector<int64_t> offsets(B + 1, 0);
+  for (int b = 0; b < B; ++b) {
+    TORCH_CHECK(
+        srcLengths[b] > 0 && tgtLengths[b] >= 0,
+        "logit_lengths must be positive and target_lengths non-negative");
+    offsets[b + 1] = offsets[b] + int64_t(srcLengths[b]) * (tgtLengths[b] + 1);
+  }
+  TORCH_CHECK(
+      logits.size(0) == offsets[B],
+      "logits must have sum(logit_lengths * (target_lengths + 1)) rows");
+  TORCH_CHECK(
+      offsets[B] <= std::numeric_limits<int>::max(),
+      "too many cells in the batch");
+
+  Options options;
+  options.batchSize_ = B;
+  options.maxSrcLen_ = at::max(logit_lengths).item().toInt();
+  options.maxTgtLen_ = targets.size(1) + 1;
+  options.numTargets_ = logits.size(1);
+  options.blank_ = blank;
+  options.clamp_ = clamp;
+  options.fusedLogSmax_ = fused_log_softmax;
+  options.packed_ = true;
+  options.numThreads_ = num_threads;
+  options.device_ = CPU;
+
+  torch::TensorOptions floatOptions =
+      torch::TensorOptions().device(logits.device()).dtype(torch::kFloat32);
+  torch::Tensor denominators = torch::empty(offsets[B], floatOptions);
+  torch::Tensor logProbs = torch::empty({offsets[B], 2}, floatOptions);
+  torch::Tensor alphas = torch::empty_like(denominators);
+  torch::Tensor betas = torch::empty_like(denominators);
+
+  torch::Tensor costs = torch::empty(
+      B, torch::TensorOptions().device(logits.device()).dtype(logits.dtype()));
+  // there is no padding: every element is written by ComputePacked.
+  std::optional<torch::Tensor> gradients = torch::empty_like(logits);
+
+  switch (logits.scalar_type()) {
+    case torch::ScalarType::Float: {
+      ComputePacked</*DTYPE=*/float, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*offsets=*/offsets.data(),
+          /*logits=*/logits.data_ptr<float>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*srcLengths=*/srcLengths,
+          /*tgtLengths=*/tgtLengths,
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*logProbs=*/logProbs.data_ptr<float>(),
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*costs=*/costs.data_ptr<float>(),
+          /*gradients=*/gradients->data_ptr<float>());
+      break;
+    }
+    case torch::ScalarType::Half: {
+      ComputePacked</*DTYPE=*/c10::Half, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*offsets=*/offsets.data(),
+          /*logits=*/logits.data_ptr<c10::Half>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*srcLengths=*/srcLengths,
+          /*tgtLengths=*/tgtLengths,
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*logProbs=*/logProbs.data_ptr<float>(),
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*costs=*/costs.data_ptr<c10::Half>(),
+          /*gradients=*/gradients->data_ptr<c10::Half>());
+      break;
+    }
+    case torch::ScalarType::BFloat16: {
+      ComputePacked</*DTYPE=*/c10::BFloat16, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*offsets=*/offsets.data(),
+          /*logits=*/logits.data_ptr<c10::BFloat16>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*srcLengths=*/srcLengths,
+          /*tgtLengths=*/tgtLengths,
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*logProbs=*/logProbs.data_ptr<float>(),
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*costs=*/costs.data_ptr<c10::BFloat16>(),
+          /*gradients=*/gradients->data_ptr<c10::BFloat16>());
+      break;
+    }
+    default: {
+      break;
+    }
+  };
+
+  return std::make_tuple(costs, gradients);
+}
+
+TORCH_LIBRARY_IMPL(torchaudio, CPU, m) {
+  m.impl("rnnt_loss_packed", &compute_packed);
+}
+
+} // namespace cpu
+} // namespace rnnt
+} // namespace torchaudio
@@ -0,0 +1,375 @@
+#include <libtorchaudio/rnnt/cpu/cpu_pruned_kernels.h>
+#include <torch/script.h>
+
+namespace torchaudio {
+namespace rnnt {
+namespace cpu {
+
+namespace {
+
+void check_lengths(
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t batch_size) {
+  TORCH_CHECK(targets.dtype() == torch::kInt32, "targets must be int32 type");
+  TORCH_CHECK(
+      logit_lengths.dtype() == torch::kInt32,
+      "logit_lengths must be int32 type");
+  TORCH_CHECK(
+      target_lengths.dtype() == torch::kInt32,
+      "target_lengths must be int32 type");
+  TORCH_CHECK(targets.is_contiguous(), "targets must be contiguous");
+  TORCH_CHECK(
+      logit_lengths.is_contiguous(), "logit_lengths must be contiguous");
+  TORCH_CHECK(
+      target_lengths.is_contiguous(), "target_lengths must be contiguous");
+  TORCH_CHECK(
+      targets.dim() == 2, "targets must be 2-D (batch, max target length)");
+  TORCH_CHECK(logit_lengths.dim() == 1, "logit_lengths must be 1-D");
+  TORCH_CHECK(target_lengths.dim() == 1, "target_lengths must be 1-D");
+  TORCH_CHECK(
+      logit_lengths.size(0) == batch_size,
+      "batch dimension mismatch between logits and logit_lengths");
+  TORCH_CHECK(
+      target_lengths.size(0) == batch_size,
+      "batch dimension mismatch between logits and target_lengths");
+  TORCH_CHECK(
+      targets.size(0) == batch_size,
+      "batch dimension mismatch between logits and targets");
+  TORCH_CHECK(
+      targets.size(1) == at::max(target_lengths).item().toInt(),
+      "target length mismatch");
+}
+
+bool is_supported_dtype(const torch::Tensor& tensor) {
+  return tensor.dtype() == torch::kFloat32 ||
+      tensor.dtype() == torch::kFloat16 || tensor.dtype() == torch::kBFloat16;
+}
+
+} // namespace
+
+// Transducer loss with a trivial joiner, logits(t, u) = am(t) + lm(u), whose
+// occupation probabilities are used to find the band of the lattice that the
+// pruned loss is evaluated on.
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+compute_simple(
+    const torch::Tensor& am,
+    const torch::Tensor& lm,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    int64_t s_range,
+    int64_t num_threads = 0) {
+  TORCH_CHECK_EQ(am.device().type(), torch::DeviceType::CPU);
+  TORCH_CHECK(
+      am.device().type() == lm.device().type(),
+      "am and lm must be on the same device");
+  TORCH_CHECK(
+      is_supported_dtype(am) && am.dtype() == lm.dtype(),
+      "am and lm must be float32, float16 (half) or bfloat16 type");
+  TORCH_CHECK(am.dim() == 3, "am must be 3-D (batch, time, class)");
+  TORCH_CHECK(lm.dim() == 3, "lm must be 3-D (batch, target, class)");
+  TORCH_CHECK(
+      lm.size(0) == am.size(0),
+      "batch dimension mismatch between am and lm");
+  TORCH_CHECK(
+      lm.size(2) == am.size(2), "class dimension mismatch between am and lm");
+  check_lengths(targets, logit_lengths, target_lengths, am.size(0));
+  TORCH_CHECK(
+      blank >= 0 && blank < am.size(-1),
+      "blank must be within [0, am.shape[-1])");
+  TORCH_CHECK(s_range > 0, "s_range must be positive");
+  TORCH_CHECK(num_threads >= 0, "num_threads must be non-negative");
+  TORCH_CHECK(
+      am.size(1) == at::max(logit_lengths).item().toInt(),
+      "input length mismatch");
+  TORCH_CHECK(
+      lm.size(1) == at::max(target_lengths).item().toInt() + 1,
+      "output length mismatch");
+
+  Options options;
+  options.batchSize_ = am.size(0);
+  options.maxSrcLen_ = am.size(1);
+  options.maxTgtLen_ = lm.size(1);
+  options.numTargets_ = am.size(2);
+  options.blank_ = blank;
+  options.numThreads_ = num_threads;
+  options.device_ = CPU;
+
+  const int& B = options.batchSize_;
+  const int& maxT = options.maxSrcLen_;
+  const int& maxU = options.maxTgtLen_;
+  const int* srcLengths = logit_lengths.data_ptr<int>();
+  const int* tgtLengths = target_lengths.data_ptr<int>();
+
+  for (int b = 0; b < B; ++b) {
+    const int T = srcLengths[b];
+    const int U = tgtLengths[b] + 1;
+    const int S = std::min<int>(s_range, U);
+    TORCH_CHECK(
+        (T - 1) * (S - 1) >= U - S,
+        "s_range ",
+        s_range,
+        " is too small to align ",
+        U - 1,
+        " targets to ",
+        T,
+        " frames");
+  }
+
+  torch::Tensor amf = am.to(torch::kFloat32);
+  torch::Tensor lmf = lm.to(torch::kFloat32);
+  torch::Tensor targets64 = targets.to(torch::kInt64);
+
+  // normalizers log(sum_d(exp(am(t, d) + lm(u, d)))), as a matrix product.
+  torch::Tensor amMax = std::get<0>(amf.max(/*dim=*/2, /*keepdim=*/true));
+  torch::Tensor lmMax = std::get<0>(lmf.max(/*dim=*/2, /*keepdim=*/true));
+  torch::Tensor amExp = (amf - amMax).exp();
+  torch::Tensor lmExp = (lmf - lmMax).exp();
+  torch::Tensor sums = torch::bmm(amExp, lmExp.transpose(1, 2));
+  torch::Tensor denom = sums.log() + amMax + lmMax.transpose(1, 2);
+
+  torch::Tensor skip = amf.select(2, blank).unsqueeze(2) +
+      lmf.select(2, blank).unsqueeze(1) - denom;
+  torch::Tensor emit = torch::zeros_like(skip);
+  emit.narrow(2, 0, maxU - 1)
+      .copy_(
+          amf.gather(2, targets64.unsqueeze(1).expand({B, maxT, maxU - 1})) +
+          lmf.narrow(1, 0, maxU - 1)
+              .gather(2, targets64.unsqueeze(2))
+              .squeeze(2)
+              .unsqueeze(1) -
+          denom.narrow(2, 0, maxU - 1));
+  torch::Tensor logProbs =
+      torch::stack({skip, emit}, /*dim=*/3).contiguous();
+
+  torch::Tensor alphas = torch::zeros_like(denom);
+  torch::Tensor betas = torch::zeros_like(denom);
+  torch::Tensor costs = torch::empty({B}, amf.options());
+  torch::Tensor skipOccupation = torch::zeros_like(denom);
+  torch::Tensor emitOccupation = torch::zeros_like(denom);
+  torch::Tensor occupation = torch::zeros_like(denom);
+  torch::Tensor ranges = torch::zeros({B, maxT}, targets.options());
+
+  const LogProbs<float>* logProbsData =
+      reinterpret_cast<const LogProbs<float>*>(logProbs.data_ptr<float>());
+  ParallelFor(options, B, [&](int b) {
+    const int64_t offset = int64_t(b) * maxT * maxU;
+    const int T = srcLengths[b];
+    const int U = tgtLengths[b] + 1;
+    TensorView<const LogProbs<float>, 2> seqLogProbs(
+        {maxT, maxU}, logProbsData + offset);
+    TensorView<float, 2> alpha(
+        {maxT, maxU}, alphas.data_ptr<float>() + offset);
+    TensorView<float, 2> beta({maxT, maxU}, betas.data_ptr<float>() + offset);
+    ComputeAlphaOneSequence<float>(seqLogProbs, T, U, alpha);
+    const float logProb =
+        ComputeBetaOneSequence<float>(seqLogProbs, T, U, beta);
+    costs.data_ptr<float>()[b] = -logProb;
+
+    TensorView<float, 2> skipOcc(
+        {maxT, maxU}, skipOccupation.data_ptr<float>() + offset);
+    TensorView<float, 2> emitOcc(
+        {maxT, maxU}, emitOccupation.data_ptr<float>() + offset);
+    TensorView<float, 2> occ(
+        {maxT, maxU}, occupation.data_ptr<float>() + offset);
+    for (int t = 0; t < T; ++t) {
+      for (int u = 0; u < U; ++u) {
+        const float a = alpha({t, u}) - logProb;
+        if (t < T - 1) {
+          skipOcc({t, u}) =
+              std::exp(a + seqLogProbs({t, u}).skip() + beta({t + 1, u}));
+        } else if (u == U - 1) {
+          skipOcc({t, u}) = std::exp(a + seqLogProbs({t, u}).skip());
+        }
+        if (u < U - 1) {
+          emitOcc({t, u}) =
+              std::exp(a + seqLogProbs({t, u}).emit() + beta({t, u + 1}));
+        }
+        occ({t, u}) = skipOcc({t, u}) + emitOcc({t, u});
+      }
+    }
+
+    TensorView<const float, 2> constOcc(
+        {maxT, maxU}, occupation.data_ptr<float>() + offset);
+    int* seqRanges = ranges.data_ptr<int>() + b * maxT;
+    ComputePruningRangesOneSequence<float>(
+        constOcc, T, U, s_range, seqRanges);
+    for (int t = T; t < maxT; ++t) {
+      seqRanges[t] = seqRanges[T - 1];
+    }
+  });
+
+  // d(cost) / d(am(t, d) + lm(u, d)) is
+  // occupation(t, u) * softmax(t, u, d) - skipOccupation(t, u) [d == blank]
+  //                                     - emitOccupation(t, u) [d == target]
+  // and the softmax term is summed over u (resp. t) with matrix products.
+  torch::Tensor weights = torch::where(
+      occupation > 0, occupation / sums, torch::zeros_like(occupation));
+  torch::Tensor amGrad = amExp * torch::bmm(weights, lmExp);
+  torch::Tensor lmGrad = lmExp * torch::bmm(weights.transpose(1, 2), amExp);
+  amGrad.select(2, blank).sub_(skipOccupation.sum(2));
+  lmGrad.select(2, blank).sub_(skipOccupation.sum(1));
+  torch::Tensor targetOccupation = emitOccupation.narrow(2, 0, maxU - 1);
+  amGrad.scatter_add_(
+      2,
+      targets64.unsqueeze(1).expand({B, maxT, maxU - 1}),
+      -targetOccupation);
+  lmGrad.narrow(1, 0, maxU - 1)
+      .scatter_add_(
+          2, targets64.unsqueeze(2), -targetOccupation.sum(1).unsqueeze(2));
+
+  return std::make_tuple(
+      costs.to(am.dtype()),
+      amGrad.to(am.dtype()),
+      lmGrad.to(lm.dtype()),
+      ranges);
+}
+
+// Transducer loss on the band of the lattice given by ranges: logits has
+// shape (batch, max seq length, s_range, class) and logits[b, t, s] is the
+// output of the joiner for frame t and symbol ranges[b, t] + s.
+std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute_pruned(
+    torch::Tensor& logits,
+    const torch::Tensor& targets,
+    const torch::Tensor& ranges,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    double clamp,
+    bool fused_log_softmax = true,
+    int64_t num_threads = 0) {
+  TORCH_CHECK_EQ(logits.device().type(), torch::DeviceType::CPU);
+  TORCH_CHECK(
+      is_supported_dtype(logits),
+      "logits must be float32, float16 (half) or bfloat16 type");
+  TORCH_CHECK(logits.is_contiguous(), "logits must be contiguous");
+  TORCH_CHECK(
+      logits.dim() == 4, "logits must be 4-D (batch, time, s_range, class)");
+  check_lengths(targets, logit_lengths, target_lengths, logits.size(0));
+  TORCH_CHECK(ranges.dtype() == torch::kInt32, "ranges must be int32 type");
+  TORCH_CHECK(ranges.is_contiguous(), "ranges must be contiguous");
+  TORCH_CHECK(ranges.dim() == 2, "ranges must be 2-D (batch, time)");
+  TORCH_CHECK(
+      ranges.size(0) == logits.size(0) && ranges.size(1) == logits.size(1),
+      "ranges must have the same batch and time dimensions as logits");
+  TORCH_CHECK(
+      blank >= 0 && blank < logits.size(-1),
+      "blank must be within [0, logits.shape[-1])");
+  TORCH_CHECK(num_threads >= 0, "num_threads must be non-negative");
+  TORCH_CHECK(
+      logits.size(1) == at::max(logit_lengths).item().toInt(),
+      "input length mismatch");
+
+  Options options;
+  options.batchSize_ = logits.size(0);
+  options.maxSrcLen_ = logits.size(1);
+  options.maxTgtLen_ = targets.size(1) + 1;
+  options.numTargets_ = logits.size(3);
+  options.blank_ = blank;
+  options.clamp_ = clamp;
+  options.fusedLogSmax_ = fused_log_softmax;
+  options.numThreads_ = num_threads;
+  options.device_ = CPU;
+
+  const int S = logits.size(2);
+  const int* rangesData = ranges.data_ptr<int>();
+  const int* srcLengths = logit_lengths.data_ptr<int>();
+  const int* tgtLengths = target_lengths.data_ptr<int>();
+  for (int b = 0; b < options.batchSize_; ++b) {
+    const int* r = rangesData + b * options.maxSrcLen_;
+    const int T = srcLengths[b];
+    const int U = tgtLengths[b] + 1;
+    TORCH_CHECK(r[0] == 0, "ranges must start at 0");
+    for (int t = 1; t < T; ++t) {
+      TORCH_CHECK(
+          r[t] >= r[t - 1] && r[t] - r[t - 1] < S,
+          "ranges must be non-decreasing, with steps smaller than s_range");
+    }
+    TORCH_CHECK(r[T - 1] + S >= U, "ranges must cover the last target");
+  }
+
+  torch::TensorOptions floatOptions =
+      torch::TensorOptions().device(logits.device()).dtype(torch::kFloat32);
+  torch::Tensor denominators =
+      torch::empty({options.batchSize_, options.maxSrcLen_, S}, floatOptions);
+  torch::Tensor logProbs = torch::empty(
+      {options.batchSize_, options.maxSrcLen_, S, 2}, floatOptions);
+  torch::Tensor alphas = torch::empty_like(denominators);
+  torch::Tensor betas = torch::empty_like(denominators);
+
+  torch::Tensor costs = torch::empty(
+      options.batchSize_,
+      torch::TensorOptions().device(logits.device()).dtype(logits.dtype()));
+  std::optional<torch::Tensor> gradients = torch::zeros_like(logits);
+
+  switch (logits.scalar_type()) {
+    case torch::ScalarType::Float: {
+      ComputePruned</*DTYPE=*/float, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*sRange=*/S,
+          /*logits=*/logits.data_ptr<float>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*ranges=*/rangesData,
+          /*srcLengths=*/srcLengths,
+          /*tgtLengths=*/tgtLengths,
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*logProbs=*/logProbs.data_ptr<float>(),
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*costs=*/costs.data_ptr<float>(),
+          /*gradients=*/gradients->data_ptr<float>());
+      break;
+    }
+    case torch::ScalarType::Half: {
+      ComputePruned</*DTYPE=*/c10::Half, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*sRange=*/S,
+          /*logits=*/logits.data_ptr<c10::Half>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*ranges=*/rangesData,
+          /*srcLengths=*/srcLengths,
+          /*tgtLengths=*/tgtLengths,
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*logProbs=*/logProbs.data_ptr<float>(),
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*costs=*/costs.data_ptr<c10::Half>(),
+          /*gradients=*/gradients->data_ptr<c10::Half>());
+      break;
+    }
+    case torch::ScalarType::BFloat16: {
+      ComputePruned</*DTYPE=*/c10::BFloat16, /*CAST_DTYPE=*/float>(
+          /*options=*/options,
+          /*sRange=*/S,
+          /*logits=*/logits.data_ptr<c10::BFloat16>(),
+          /*targets=*/targets.data_ptr<int>(),
+          /*ranges=*/rangesData,
+          /*srcLengths=*/srcLengths,
+          /*tgtLengths=*/tgtLengths,
+          /*denominators=*/denominators.data_ptr<float>(),
+          /*logProbs=*/logProbs.data_ptr<float>(),
+          /*alphas=*/alphas.data_ptr<float>(),
+          /*betas=*/betas.data_ptr<float>(),
+          /*costs=*/costs.data_ptr<c10::BFloat16>(),
+          /*gradients=*/gradients->data_ptr<c10::BFloat16>());
+      break;
+    }
+    default: {
+      break;
+    }
+  };
+
+  return std::make_tuple(costs, gradients);
+}
+
+TORCH_LIBRARY_IMPL(torchaudio, CPU, m) {
+  m.impl("rnnt_loss_simple", &compute_simple);
+  m.impl("rnnt_loss_pruned", &compute_pruned);
+}
+
+} // namespace cpu
+} // namespace rnnt
+} // namespace torchaudio
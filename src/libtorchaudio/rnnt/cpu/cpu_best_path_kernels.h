@@ -0,0 +1,172 @@
+#pragma once
+
+#include <libtorchaudio/rnnt/cpu/cpu_kernels.h>
+
+namespace torchaudio {
+namespace rnnt {
+namespace cpu {
+
+// Best path (Viterbi) alignment of the transducer lattice.
+//
+// The recursion is the one of the alphas, with max instead of log-sum-exp:
+//   score(t, u) = max(score(t - 1, u) + skip(t - 1, u),
+//                     score(t, u - 1) + emit(t, u - 1))
+// and the best path ends with the blank emitted at (T - 1, U - 1). It has
+// T + U - 1 steps: T blanks and U - 1 targets.
+
+// Back-pointer of node (t, u): the node the best path comes from.
+enum BackPointer : int8_t {
+  kFromBlank = 0, // (t - 1, u).
+  kFromEmit = 1, // (t, u - 1).
+};
+
+// Inputs:
+//   logProbs: (maxT, maxU) log probs of the sequence.
+//   srcLen, tgtLen: T and U (with the prepended blank).
+//   targets: (U - 1, ) targets of the sequence.
+//   scores: (2, U) scratch buffer.
+//   backPointers: (T, U) scratch buffer.
+//
+// Outputs:
+//   path: (T + U - 1, 2) (t, u) node of each step.
+//   labels: (T + U - 1, ) token emitted at each step (blank or target).
+//   stepScores: (T + U - 1, ) log prob of each step.
+// Returns the score of the best path.
+template <typename DTYPE>
+DTYPE ComputeBestPathOneSequence(
+    const Options& options,
+    TensorView<const LogProbs<DTYPE>, 2>& logProbs,
+    const int* targets,
+    int srcLen,
+    int tgtLen,
+    TensorView<DTYPE, 2>& scores,
+    TensorView<int8_t, 2>& backPointers,
+    int* path,
+    int* labels,
+    DTYPE* stepScores) {
+  const int& T = srcLen;
+  const int& U = tgtLen;
+  const int& blank = options.blank_;
+
+  // only the rows t - 1 and t of the scores are kept, in rows (t - 1) % 2
+  // and t % 2, since the backtracking only needs the back-pointers.
+  scores({0, 0}) = DTYPE(0);
+  for (int u = 1; u < U; ++u) { // t == 0.
+    scores({0, u}) = scores({0, u - 1}) + logProbs({0, u - 1}).emit();
+    backPointers({0, u}) = kFromEmit;
+  }
+  for (int t = 1; t < T; ++t) {
+    const int cur = t % 2;
+    const int prev = 1 - cur;
+    scores({cur, 0}) = scores({prev, 0}) + logProbs({t - 1, 0}).skip();
+    backPointers({t, 0}) = kFromBlank;
+    for (int u = 1; u < U; ++u) {
+      DTYPE fromBlank = scores({prev, u}) + logProbs({t - 1, u}).skip();
+      DTYPE fromEmit = scores({cur, u - 1}) + logProbs({t, u - 1}).emit();
+      // ties go to blank, so that targets are emitted as late as possible.
+      if (fromEmit > fromBlank) {
+        scores({cur, u}) = fromEmit;
+        backPointers({t, u}) = kFromEmit;
+      } else {
+        scores({cur, u}) = fromBlank;
+        backPointers({t, u}) = kFromBlank;
+      }
+    }
+  }
+
+  const DTYPE best =
+      scores({(T - 1) % 2, U - 1}) + logProbs({T - 1, U - 1}).skip();
+  if (!options.backtrack_) {
+    return best;
+  }
+
+  // backtrack from the last blank, filling the steps from the end.
+  int step = T + U - 2;
+  path[2 * step] = T - 1;
+  path[2 * step + 1] = U - 1;
+  labels[step] = blank;
+  stepScores[step] = logProbs({T - 1, U - 1}).skip();
+  int t = T - 1;
+  int u = U - 1;
+  while (step > 0) {
+    --step;
+    if (backPointers({t, u}) == kFromBlank) {
+      --t;
+      labels[step] = blank;
+      stepScores[step] = logProbs({t, u}).skip();
+    } else {
+      --u;
+      labels[step] = targets[u];
+      stepScores[step] = logProbs({t, u}).emit();
+    }
+    path[2 * step] = t;
+    path[2 * step + 1] = u;
+  }
+
+  return best;
+}
+
+// Inputs:
+//   options: options, with backtrack_ set to return the paths.
+//   logProbs: (B, maxT, maxU, 2) log probs, from ComputeLogProbs.
+//   targets: pointer to (B, maxU - 1) targets in the batch.
+//   srcLengths: pointer to (B, ) source lengths in the batch.
+//   tgtLengths: pointer to (B, ) target lengths in the batch.
+//
+// Outputs:
+//   paths: pointer to (B, maxT + maxU - 1, 2) paths, padded with -1.
+//   labels: pointer to (B, maxT + maxU - 1) labels, padded with -1.
+//   stepScores: pointer to (B, maxT + maxU - 1) step scores, padded with 0.
+template <typename DTYPE, typename CAST_DTYPE>
+void ComputeBestPaths(
+    const Options& options,
+    const CAST_DTYPE* logProbs,
+    const int* targets,
+    const int* srcLengths,
+    const int* tgtLengths,
+    int* paths,
+    int* labels,
+    CAST_DTYPE* stepScores) {
+  const int& B = options.batchSize_;
+  const int& maxT = options.maxSrcLen_;
+  const int& maxU = options.maxTgtLen_;
+  const int maxSteps = maxT + maxU - 1;
+
+  ParallelFor(options, B, [&](int b) {
+    const int T = srcLengths[b];
+    const int U = tgtLengths[b] + 1; // with prepended blank.
+    // back-pointers are stored as int8, as they are kept for the whole
+    // lattice until the backtracking, while only two rows of scores are.
+    std::vector<CAST_DTYPE> scoresData(2 * U);
+    std::vector<int8_t> backPointersData(int64_t(T) * U);
+    TensorView<CAST_DTYPE, 2> scores({2, U}, scoresData.data());
+    TensorView<int8_t, 2> backPointers({T, U}, backPointersData.data());
+    TensorView<const LogProbs<CAST_DTYPE>, 2> seqLogProbs(
+        {maxT, maxU},
+        reinterpret_cast<const LogProbs<CAST_DTYPE>*>(logProbs) +
+            int64_t(b) * maxT * maxU);
+
+    int* seqPath = paths + int64_t(b) * maxSteps * 2;
+    int* seqLabels = labels + int64_t(b) * maxSteps;
+    CAST_DTYPE* seqStepScores = stepScores + int64_t(b) * maxSteps;
+    std::fill(seqPath + (T + U - 1) * 2, seqPath + maxSteps * 2, -1);
+    std::fill(seqLabels + T + U - 1, seqLabels + maxSteps, -1);
+    std::fill(seqStepScores + T + U - 1, seqStepScores + maxSteps, 0);
+
+    ComputeBestPathOneSequence<CAST_DTYPE>(
+        /*options=*/options,
+        /*logProbs=*/seqLogProbs,
+        /*targets=*/targets + b * (maxU - 1),
+        /*srcLen=*/T,
+        /*tgtLen=*/U,
+        /*scores=*/scores,
+        /*backPointers=*/backPointers,
+        /*path=*/seqPath,
+        /*labels=*/seqLabels,
+        /*stepScores=*/seqStepScores);
+  });
+}
+
+} // namespace cpu
+} // namespace rnnt
+} // namespace torchaudio
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <libtorchaudio/rnnt/cpu/logsumexp.h>
 #include <libtorchaudio/rnnt/cpu/math.h>
 #include <libtorchaudio/rnnt/options.h>
 #include <libtorchaudio/rnnt/types.h>
 
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/vec.h>
 #include <c10/util/Logging.h>
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <limits>
 #include <vector>
@@ -36,52 +41,65 @@ struct LogProbs {
   }
 };
 
-// TensorView: view a block of allocated memory as a tensor.
-template <typename DTYPE>
+// TensorView: view a block of allocated memory as a tensor of rank RANK.
+// The rank is fixed at compile time so that indexing does not allocate and
+// the index arithmetic can be fully unrolled and inlined in the hot loops.
+template <typename DTYPE, int RANK>
 class TensorView {
  public:
-  TensorView(const std::vector<int>& dims, DTYPE* data)
+  TensorView(const std::array<int, RANK>& dims, DTYPE* data)
       : dims_(dims), data_(data) {
-    strides_.resize(dims.size());
-    strides_.back() = 1;
-    for (int i = dims.size() - 2; i >= 0; --i) {
+    strides_[RANK - 1] = 1;
+    for (int i = RANK - 2; i >= 0; --i) {
       strides_[i] = strides_[i + 1] * dims[i + 1];
     }
   }
 
-  DTYPE& operator()(const std::vector<int>& indices) {
-    TORCH_CHECK_EQ(indices.size(), dims_.size());
-    int index = indices.back();
-    for (int i = indices.size() - 2; i >= 0; --i) {
+  FORCE_INLINE DTYPE& operator()(const std::array<int, RANK>& indices) const {
+    int64_t index = indices[RANK - 1];
+    for (int i = RANK - 2; i >= 0; --i) {
       index += indices[i] * strides_[i];
     }
     return data_[index];
   }
 
   void SetZero() {
-    int size = dims_[0] * strides_[0];
+    int64_t size = dims_[0] * strides_[0];
     std::memset(data_, 0, sizeof(DTYPE) * size);
   }
 
  private:
-  std::vector<int> dims_;
-  std::vector<int> strides_;
+  std::array<int, RANK> dims_;
+  std::array<int64_t, RANK> strides_;
   DTYPE* data_;
 };
 
-template <typename DTYPE, typename CAST_DTYPE>
-status_t LogSumExp2D(int N, int D, const DTYPE* logits, CAST_DTYPE* outputs) {
-  for (int i = 0; i < N * D; i += D) {
-    CAST_DTYPE max = logits[i];
-    for (int j = 1; j < D; ++j) {
-      max = std::max(max, CAST_DTYPE(logits[i + j]));
-    }
-    CAST_DTYPE sum = 0;
-    for (int j = 0; j < D; ++j) {
-      sum = sum + std::exp(CAST_DTYPE(logits[i + j]) - max);
-    }
-    outputs[i / D] = max + std::log(sum);
+// Calls fn(i) for i in [0, n) using ATen's intra-op thread pool.
+// options.numThreads_ caps the number of chunks (and thus threads) the work
+// is split into; a non-positive value uses all the intra-op threads.
+template <typename FUNC>
+void ParallelFor(const Options& options, int n, const FUNC& fn) {
+  int64_t grainSize = 1;
+  if (options.numThreads_ > 0) {
+    grainSize = (n + options.numThreads_ - 1) / options.numThreads_;
   }
+  at::parallel_for(0, n, grainSize, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      fn(i);
+    }
+  });
+}
+
+template <typename DTYPE, typename CAST_DTYPE>
+status_t LogSumExp2D(
+    const Options& options,
+    int N,
+    int D,
+    const DTYPE* logits,
+    CAST_DTYPE* outputs) {
+  ParallelFor(options, N, [&](int i) {
+    outputs[i] = CAST_DTYPE(RowLogSumExp(logits + int64_t(i) * D, D));
+  });
 
   return SUCCESS;
 }
@@ -89,12 +107,12 @@ status_t LogSumExp2D(int N, int D, const DTYPE* logits, CAST_DTYPE* outputs) {
 template <typename DTYPE, typename CAST_DTYPE>
 void ComputeLogProbsOneSequence(
     const Options& options,
-    TensorView<const DTYPE>& logits,
+    TensorView<const DTYPE, 3>& logits,
     const int* targets,
     int srcLen,
     int tgtLen,
-    TensorView<const CAST_DTYPE>& denom,
-    TensorView<LogProbs<CAST_DTYPE>>& logProbs) {
+    TensorView<const CAST_DTYPE, 2>& denom,
+    TensorView<LogProbs<CAST_DTYPE>, 2>& logProbs) {
   const int& T = srcLen;
   const int& U = tgtLen;
   const int& blank = options.blank_;
@@ -128,28 +146,28 @@ status_t ComputeLogProbs(
     const int* tgtLengths,
     const CAST_DTYPE* denominators,
     CAST_DTYPE* logProbs) {
-  std::vector<TensorView<const DTYPE>> seqLogits;
+  std::vector<TensorView<const DTYPE, 3>> seqLogits;
   std::vector<const int*> seqTargets;
-  std::vector<TensorView<const CAST_DTYPE>> seqDenoms;
-  std::vector<TensorView<LogProbs<CAST_DTYPE>>> seqlogProbs;
+  std::vector<TensorView<const CAST_DTYPE, 2>> seqDenoms;
+  std::vector<TensorView<LogProbs<CAST_DTYPE>, 2>> seqlogProbs;
 
   const int& B = options.batchSize_;
   const int& maxT = options.maxSrcLen_;
   const int& maxU = options.maxTgtLen_;
   const int& D = options.numTargets_;
   for (int b = 0; b < B; ++b) {
-    seqLogits.push_back(
-        TensorView<const DTYPE>({maxT, maxU, D}, logits + b * maxT * maxU * D));
+    seqLogits.push_back(TensorView<const DTYPE, 3>(
+        {maxT, maxU, D}, logits + int64_t(b) * maxT * maxU * D));
     seqTargets.push_back(targets + b * (maxU - 1));
-    seqDenoms.push_back(TensorView<const CAST_DTYPE>(
-        {maxT, maxU}, denominators + b * maxT * maxU));
-    seqlogProbs.push_back(TensorView<LogProbs<CAST_DTYPE>>(
+    seqDenoms.push_back(TensorView<const CAST_DTYPE, 2>(
+        {maxT, maxU}, denominators + int64_t(b) * maxT * maxU));
+    seqlogProbs.push_back(TensorView<LogProbs<CAST_DTYPE>, 2>(
         {maxT, maxU},
-        reinterpret_cast<LogProbs<CAST_DTYPE>*>(logProbs) + b * maxT * maxU));
+        reinterpret_cast<LogProbs<CAST_DTYPE>*>(logProbs) +
+            int64_t(b) * maxT * maxU));
   }
 
-  //#pragma omp parallel for
-  for (int b = 0; b < B; ++b) { // use max 2 * B threads.
+  ParallelFor(options, B, [&](int b) {
     ComputeLogProbsOneSequence<DTYPE, CAST_DTYPE>(
         /*options=*/options,
         /*logits=*/seqLogits[b],
@@ -158,20 +176,162 @@ status_t ComputeLogProbs(
         /*tgtLen=*/tgtLengths[b] + 1, // with prepended blank.
         /*denom=*/seqDenoms[b],
         /*logProbs=*/seqlogProbs[b]);
-  }
+  });
 
   return SUCCESS;
 }
 
+// Cells on the anti-diagonal t + u = k of the (T, U) lattice only depend on
+// cells of the diagonal k - 1 (alpha) or k + 1 (beta), so a whole diagonal can
+// be evaluated at once with SIMD. A diagonal has at most min(T, U) cells;
+// below this length the row-major recursion is used, as the gather / scatter
+// of the diagonals is not amortized.
+constexpr int kMinWavefrontLength = 16;
+
+// out[i] = lse(a[i] + x[i], b[i] + y[i]) for i in [0, n).
+template <typename DTYPE>
+void LseOfSums(
+    int n,
+    const DTYPE* a,
+    const DTYPE* x,
+    const DTYPE* b,
+    const DTYPE* y,
+    DTYPE* out) {
+  using Vec = at::vec::Vectorized<DTYPE>;
+  int i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    Vec p = Vec::loadu(a + i) + Vec::loadu(x + i);
+    Vec q = Vec::loadu(b + i) + Vec::loadu(y + i);
+    // max(p, q) + log(1 + exp(-|p - q|)); exact when either side is -inf.
+    Vec r = at::vec::maximum(p, q) + (p - q).abs().neg().exp().log1p();
+    r.store(out + i);
+  }
+  for (; i < n; ++i) {
+    out[i] = math::lse(a[i] + x[i], b[i] + y[i]);
+  }
+}
+
+// Wavefront version of ComputeAlphaOneSequence.
+// Alphas and log probs of one diagonal are kept contiguous in buffers indexed
+// by t + 1, so that t = -1 and t = k (out of the lattice) read -inf alphas.
+template <typename DTYPE>
+DTYPE ComputeAlphaOneSequenceWavefront(
+    TensorView<const LogProbs<DTYPE>, 2>& logProbs,
+    int srcLen,
+    int tgtLen,
+    TensorView<DTYPE, 2>& alpha) {
+  const int& T = srcLen;
+  const int& U = tgtLen;
+  const DTYPE kNegInfinity = -std::numeric_limits<DTYPE>::infinity();
+
+  std::vector<DTYPE> diags[2] = {
+      std::vector<DTYPE>(T + 1, kNegInfinity),
+      std::vector<DTYPE>(T + 1, kNegInfinity)};
+  std::vector<DTYPE> skip(T + 1, 0);
+  std::vector<DTYPE> emit(T + 1, 0);
+
+  diags[0][1] = DTYPE(0);
+  alpha({0, 0}) = DTYPE(0);
+
+  for (int k = 1; k < T + U - 1; ++k) {
+    const DTYPE* prev = diags[(k - 1) & 1].data();
+    DTYPE* cur = diags[k & 1].data();
+
+    // gather log probs of diagonal k - 1 in diagonal-major order.
+    for (int t = std::max(0, k - U), end = std::min(k - 1, T - 1); t <= end;
+         ++t) {
+      const int u = k - 1 - t;
+      skip[t + 1] = logProbs({t, u}).skip();
+      emit[t + 1] = (u < U - 1) ? logProbs({t, u}).emit() : DTYPE(0);
+    }
+
+    const int tlo = std::max(0, k - U + 1);
+    const int thi = std::min(k, T - 1);
+    // alpha(t, u) = lse(alpha(t - 1, u) + skip(t - 1, u),
+    //                   alpha(t, u - 1) + emit(t, u - 1))
+    LseOfSums<DTYPE>(
+        /*n=*/thi - tlo + 1,
+        /*a=*/prev + tlo,
+        /*x=*/skip.data() + tlo,
+        /*b=*/prev + tlo + 1,
+        /*y=*/emit.data() + tlo + 1,
+        /*out=*/cur + tlo + 1);
+
+    for (int t = tlo; t <= thi; ++t) {
+      alpha({t, k - t}) = cur[t + 1];
+    }
+  }
+
+  return alpha({T - 1, U - 1}) + logProbs({T - 1, U - 1}).skip();
+}
+
+// Wavefront version of ComputeBetaOneSequence.
+// Betas of one diagonal are kept contiguous in buffers indexed by t + 1, so
+// that t = T and u = U (out of the lattice) read -inf betas.
+template <typename DTYPE>
+DTYPE ComputeBetaOneSequenceWavefront(
+    TensorView<const LogProbs<DTYPE>, 2>& logProbs,
+    int srcLen,
+    int tgtLen,
+    TensorView<DTYPE, 2>& beta) {
+  const int& T = srcLen;
+  const int& U = tgtLen;
+  const DTYPE kNegInfinity = -std::numeric_limits<DTYPE>::infinity();
+
+  std::vector<DTYPE> diags[2] = {
+      std::vector<DTYPE>(T + 2, kNegInfinity),
+      std::vector<DTYPE>(T + 2, kNegInfinity)};
+  std::vector<DTYPE> skip(T + 1, 0);
+  std::vector<DTYPE> emit(T + 1, 0);
+
+  const int last = T + U - 2;
+  diags[last & 1][T] = logProbs({T - 1, U - 1}).skip();
+  beta({T - 1, U - 1}) = diags[last & 1][T];
+
+  for (int k = last - 1; k >= 0; --k) {
+    const DTYPE* next = diags[(k + 1) & 1].data();
+    DTYPE* cur = diags[k & 1].data();
+
+    const int tlo = std::max(0, k - U + 1);
+    const int thi = std::min(k, T - 1);
+    // gather log probs of diagonal k in diagonal-major order.
+    for (int t = tlo; t <= thi; ++t) {
+      const int u = k - t;
+      skip[t + 1] = logProbs({t, u}).skip();
+      emit[t + 1] = (u < U - 1) ? logProbs({t, u}).emit() : DTYPE(0);
+    }
+
+    // beta(t, u) = lse(beta(t + 1, u) + skip(t, u),
+    //                  beta(t, u + 1) + emit(t, u))
+    LseOfSums<DTYPE>(
+        /*n=*/thi - tlo + 1,
+        /*a=*/next + tlo + 2,
+        /*x=*/skip.data() + tlo + 1,
+        /*b=*/next + tlo + 1,
+        /*y=*/emit.data() + tlo + 1,
+        /*out=*/cur + tlo + 1);
+
+    for (int t = tlo; t <= thi; ++t) {
+      beta({t, k - t}) = cur[t + 1];
+    }
+  }
+
+  return beta({0, 0});
+}
+
 template <typename DTYPE>
 DTYPE ComputeAlphaOneSequence(
-    TensorView<const LogProbs<DTYPE>>& logProbs,
+    TensorView<const LogProbs<DTYPE>, 2>& logProbs,
     int srcLen,
     int tgtLen,
-    TensorView<DTYPE>& alpha) {
+    TensorView<DTYPE, 2>& alpha) {
   const int& T = srcLen;
   const int& U = tgtLen;
 
+  if (std::min(T, U) >= kMinWavefrontLength) {
+    return ComputeAlphaOneSequenceWavefront<DTYPE>(logProbs, T, U, alpha);
+  }
+
   alpha({0, 0}) = DTYPE(0);
 
   for (int t = 1; t < T; ++t) { // u == 0.
@@ -197,13 +357,17 @@ DTYPE ComputeAlphaOneSequence(
 
 template <typename DTYPE>
 DTYPE ComputeBetaOneSequence(
-    TensorView<const LogProbs<DTYPE>>& logProbs,
+    TensorView<const LogProbs<DTYPE>, 2>& logProbs,
     int srcLen,
     int tgtLen,
-    TensorView<DTYPE>& beta) {
+    TensorView<DTYPE, 2>& beta) {
   const int& T = srcLen;
   const int& U = tgtLen;
 
+  if (std::min(T, U) >= kMinWavefrontLength) {
+    return ComputeBetaOneSequenceWavefront<DTYPE>(logProbs, T, U, beta);
+  }
+
   beta({T - 1, U - 1}) = logProbs({T - 1, U - 1}).skip();
 
   for (int t = T - 2; t >= 0; --t) { // u == U - 1.
@@ -231,11 +395,11 @@ template <typename DTYPE>
 DTYPE ComputeAlphaOrBetaOneSequence(
     int thread,
     const Options& options,
-    TensorView<const LogProbs<DTYPE>>& logProbs,
+    TensorView<const LogProbs<DTYPE>, 2>& logProbs,
     int srcLen,
     int tgtLen,
-    TensorView<DTYPE>& alpha,
-    TensorView<DTYPE>& beta) {
+    TensorView<DTYPE, 2>& alpha,
+    TensorView<DTYPE, 2>& beta) {
   if (thread & 1) {
     return ComputeAlphaOneSequence<DTYPE>(
         /*logProbs=*/logProbs,
@@ -260,29 +424,30 @@ void ComputeAlphasBetas(
     CAST_DTYPE* alphas,
     CAST_DTYPE* betas,
     DTYPE* costs) {
-  std::vector<TensorView<const LogProbs<CAST_DTYPE>>> seqlogProbs;
-  std::vector<TensorView<CAST_DTYPE>> seq_alphas;
-  std::vector<TensorView<CAST_DTYPE>> seq_betas;
+  std::vector<TensorView<const LogProbs<CAST_DTYPE>, 2>> seqlogProbs;
+  std::vector<TensorView<CAST_DTYPE, 2>> seq_alphas;
+  std::vector<TensorView<CAST_DTYPE, 2>> seq_betas;
 
   const int& B = options.batchSize_;
   const int& maxT = options.maxSrcLen_;
   const int& maxU = options.maxTgtLen_;
 
   for (int b = 0; b < B; ++b) {
-    seqlogProbs.push_back(TensorView<const LogProbs<CAST_DTYPE>>(
+    seqlogProbs.push_back(TensorView<const LogProbs<CAST_DTYPE>, 2>(
         {maxT, maxU},
         reinterpret_cast<LogProbs<CAST_DTYPE>*>(
             const_cast<CAST_DTYPE*>(logProbs)) +
-            b * maxT * maxU));
-    seq_alphas.push_back(
-        TensorView<CAST_DTYPE>({maxT, maxU}, alphas + b * maxT * maxU));
-    seq_betas.push_back(
-        TensorView<CAST_DTYPE>({maxT, maxU}, betas + b * maxT * maxU));
+            int64_t(b) * maxT * maxU));
+    seq_alphas.push_back(TensorView<CAST_DTYPE, 2>(
+        {maxT, maxU}, alphas + int64_t(b) * maxT * maxU));
+    seq_betas.push_back(TensorView<CAST_DTYPE, 2>(
+        {maxT, maxU}, betas + int64_t(b) * maxT * maxU));
   }
 
   std::vector<CAST_DTYPE> scores(B << 1);
-  //#pragma omp parallel for
-  for (int t = 0; t < (B << 1); ++t) { // use max 2 * B threads.
+  // alpha and beta of the same sequence are independent, so they run as
+  // separate tasks: use max 2 * B threads.
+  ParallelFor(options, B << 1, [&](int t) {
     int i = (t >> 1);
     scores[t] = ComputeAlphaOrBetaOneSequence<CAST_DTYPE>(
         /*thread=*/t,
@@ -292,7 +457,7 @@ void ComputeAlphasBetas(
         /*tgtLen=*/tgtLengths[i] + 1, // with prepended blank.
         /*alpha=*/seq_alphas[i],
         /*beta=*/seq_betas[i]);
-  }
+  });
   for (int b = 0; b < B; ++b) {
     costs[b] = -scores[b << 1];
   }
@@ -301,16 +466,17 @@ void ComputeAlphasBetas(
 template <typename DTYPE, typename CAST_DTYPE>
 void ComputeGradientsOneSequence(
     const Options& options,
-    TensorView<const DTYPE>& logits,
+    TensorView<const DTYPE, 3>& logits,
     const int* targets,
     int srcLen,
     int tgtLen,
-    TensorView<const CAST_DTYPE>& denom,
-    TensorView<const CAST_DTYPE>& alpha,
-    TensorView<const CAST_DTYPE>& beta,
-    TensorView<DTYPE>& gradients) {
-  // don't set gradients to zero to here as gradients might reuse memory from
-  // logits
+    TensorView<const CAST_DTYPE, 2>& denom,
+    TensorView<const CAST_DTYPE, 2>& alpha,
+    TensorView<const CAST_DTYPE, 2>& beta,
+    TensorView<DTYPE, 3>& gradients) {
+  // gradients are not zero-initialized: they might reuse memory from logits,
+  // or come uninitialized from the caller. The cells outside of the
+  // (srcLen, tgtLen) lattice are zeroed at the end.
 
   const int& T = srcLen;
   const int& U = tgtLen;
@@ -384,23 +550,24 @@ void ComputeGradientsOneSequence(
     }
   }
 
-  // zero out the rest of the gradients, necessary when reusing logits memory
-  // check the memory location to see if it's necessary
-  if (&gradients({0, 0, 0}) == &logits({0, 0, 0})) {
-    const int& maxT = options.maxSrcLen_;
-    const int& maxU = options.maxTgtLen_;
-    for (int t = T; t < maxT; ++t) {
-      for (int u = 0; u < maxU; ++u) {
-        for (int d = 0; d < D; ++d) {
-          gradients({t, u, d}) = 0.;
-        }
+  if (options.packed_) { // there is no padding.
+    return;
+  }
+
+  // zero out the rest of the gradients.
+  const int& maxT = options.maxSrcLen_;
+  const int& maxU = options.maxTgtLen_;
+  for (int t = T; t < maxT; ++t) {
+    for (int u = 0; u < maxU; ++u) {
+      for (int d = 0; d < D; ++d) {
+        gradients({t, u, d}) = 0.;
       }
     }
-    for (int t = 0; t < T; ++t) {
-      for (int u = U; u < maxU; ++u) {
-        for (int d = 0; d < D; ++d) {
-          gradients({t, u, d}) = 0.;
-        }
+  }
+  for (int t = 0; t < T; ++t) {
+    for (int u = U; u < maxU; ++u) {
+      for (int d = 0; d < D; ++d) {
+        gradients({t, u, d}) = 0.;
       }
     }
   }
@@ -417,33 +584,32 @@ void ComputeGradients(
     const CAST_DTYPE* alphas,
     const CAST_DTYPE* betas,
     DTYPE* gradients) {
-  std::vector<TensorView<const DTYPE>> seqLogits;
+  std::vector<TensorView<const DTYPE, 3>> seqLogits;
   std::vector<const int*> seqTargets;
-  std::vector<TensorView<const CAST_DTYPE>> seqDenoms;
-  std::vector<TensorView<const CAST_DTYPE>> seq_alphas;
-  std::vector<TensorView<const CAST_DTYPE>> seq_betas;
-  std::vector<TensorView<DTYPE>> seq_gradients;
+  std::vector<TensorView<const CAST_DTYPE, 2>> seqDenoms;
+  std::vector<TensorView<const CAST_DTYPE, 2>> seq_alphas;
+  std::vector<TensorView<const CAST_DTYPE, 2>> seq_betas;
+  std::vector<TensorView<DTYPE, 3>> seq_gradients;
 
   const int& B = options.batchSize_;
   const int& maxT = options.maxSrcLen_;
   const int& maxU = options.maxTgtLen_;
   const int& D = options.numTargets_;
   for (int b = 0; b < B; ++b) {
-    seqLogits.push_back(
-        TensorView<const DTYPE>({maxT, maxU, D}, logits + b * maxT * maxU * D));
+    seqLogits.push_back(TensorView<const DTYPE, 3>(
+        {maxT, maxU, D}, logits + int64_t(b) * maxT * maxU * D));
     seqTargets.push_back(targets + b * (maxU - 1));
-    seqDenoms.push_back(TensorView<const CAST_DTYPE>(
-        {maxT, maxU}, denominators + b * maxT * maxU));
-    seq_alphas.push_back(
-        TensorView<const CAST_DTYPE>({maxT, maxU}, alphas + b * maxT * maxU));
-    seq_betas.push_back(
-        TensorView<const CAST_DTYPE>({maxT, maxU}, betas + b * maxT * maxU));
-    seq_gradients.push_back(
-        TensorView<DTYPE>({maxT, maxU, D}, gradients + b * maxT * maxU * D));
-  }
-
-  //#pragma omp parallel for
-  for (int b = 0; b < B; ++b) { // use max 2 * B threads.
+    seqDenoms.push_back(TensorView<const CAST_DTYPE, 2>(
+        {maxT, maxU}, denominators + int64_t(b) * maxT * maxU));
+    seq_alphas.push_back(TensorView<const CAST_DTYPE, 2>(
+        {maxT, maxU}, alphas + int64_t(b) * maxT * maxU));
+    seq_betas.push_back(TensorView<const CAST_DTYPE, 2>(
+        {maxT, maxU}, betas + int64_t(b) * maxT * maxU));
+    seq_gradients.push_back(TensorView<DTYPE, 3>(
+        {maxT, maxU, D}, gradients + int64_t(b) * maxT * maxU * D));
+  }
+
+  ParallelFor(options, B, [&](int b) {
     ComputeGradientsOneSequence<DTYPE, CAST_DTYPE>(
         /*options=*/options,
         /*logits=*/seqLogits[b],
@@ -454,7 +620,7 @@ void ComputeGradients(
         /*alpha=*/seq_alphas[b],
         /*beta=*/seq_betas[b],
         /*gradients=*/seq_gradients[b]);
-  }
+  });
 }
 
 template <typename DTYPE, typename CAST_DTYPE>
@@ -464,31 +630,30 @@ void ComputeAlphas(
     const int* srcLengths,
     const int* tgtLengths,
     CAST_DTYPE* alphas) {
-  std::vector<TensorView<const LogProbs<CAST_DTYPE>>> seqlogProbs;
-  std::vector<TensorView<CAST_DTYPE>> seq_alphas;
+  std::vector<TensorView<const LogProbs<CAST_DTYPE>, 2>> seqlogProbs;
+  std::vector<TensorView<CAST_DTYPE, 2>> seq_alphas;
 
   const int& B = options.batchSize_;
   const int& maxT = options.maxSrcLen_;
   const int& maxU = options.maxTgtLen_;
 
   for (int b = 0; b < B; ++b) {
-    seqlogProbs.push_back(TensorView<const LogProbs<CAST_DTYPE>>(
+    seqlogProbs.push_back(TensorView<const LogProbs<CAST_DTYPE>, 2>(
         {maxT, maxU},
         reinterpret_cast<LogProbs<CAST_DTYPE>*>(
             const_cast<CAST_DTYPE*>(logProbs)) +
-            b * maxT * maxU));
-    seq_alphas.push_back(
-        TensorView<CAST_DTYPE>({maxT, maxU}, alphas + b * maxT * maxU));
+            int64_t(b) * maxT * maxU));
+    seq_alphas.push_back(TensorView<CAST_DTYPE, 2>(
+        {maxT, maxU}, alphas + int64_t(b) * maxT * maxU));
   }
 
-  //#pragma omp parallel for
-  for (int i = 0; i < B; ++i) { // use max 2 * B threads.
+  ParallelFor(options, B, [&](int i) {
     ComputeAlphaOneSequence<DTYPE>(
         /*logProbs=*/seqlogProbs[i],
         /*srcLen=*/srcLengths[i],
         /*tgtLen=*/tgtLengths[i] + 1, // with prepended blank.
         /*alpha=*/seq_alphas[i]);
-  }
+  });
 }
 
 template <typename DTYPE, typename CAST_DTYPE>
@@ -499,31 +664,30 @@ void ComputeBetas(
     const int* tgtLengths,
     CAST_DTYPE* costs,
     CAST_DTYPE* betas) {
-  std::vector<TensorView<const LogProbs<CAST_DTYPE>>> seqlogProbs;
-  std::vector<TensorView<CAST_DTYPE>> seq_betas;
+  std::vector<TensorView<const LogProbs<CAST_DTYPE>, 2>> seqlogProbs;
+  std::vector<TensorView<CAST_DTYPE, 2>> seq_betas;
 
   const int& B = options.batchSize_;
   const int& maxT = options.maxSrcLen_;
   const int& maxU = options.maxTgtLen_;
 
   for (int b = 0; b < B; ++b) {
-    seqlogProbs.push_back(TensorView<const LogProbs<CAST_DTYPE>>(
+    seqlogProbs.push_back(TensorView<const LogProbs<CAST_DTYPE>, 2>(
         {maxT, maxU},
         reinterpret_cast<LogProbs<CAST_DTYPE>*>(
             const_cast<CAST_DTYPE*>(logProbs)) +
-            b * maxT * maxU));
-    seq_betas.push_back(
-        TensorView<CAST_DTYPE>({maxT, maxU}, betas + b * maxT * maxU));
+            int64_t(b) * maxT * maxU));
+    seq_betas.push_back(TensorView<CAST_DTYPE, 2>(
+        {maxT, maxU}, betas + int64_t(b) * maxT * maxU));
   }
 
-  //#pragma omp parallel for
-  for (int i = 0; i < B; ++i) {
+  ParallelFor(options, B, [&](int i) {
     ComputeBetaOneSequence<DTYPE>(
         /*logProbs=*/seqlogProbs[i],
         /*srcLen=*/srcLengths[i],
         /*tgtLen=*/tgtLengths[i] + 1, // with prepended blank.
         /*betas=*/seq_betas[i]);
-  }
+  });
 }
 
 } // namespace cpu
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <libtorchaudio/rnnt/cpu/cpu_kernels.h>
+
+namespace torchaudio {
+namespace rnnt {
+namespace cpu {
+
+// Transducer loss on packed sequences.
+//
+// Logits of sequence b are stored as a dense (T_b, U_b, D) block starting at
+// row offsets[b] of the (N, D) logits, where N = sum_b T_b * U_b and
+// U_b = tgtLengths[b] + 1. Denominators, log probs, alphas and betas use the
+// same row offsets, so no memory nor compute is spent on padding.
+//
+// Inputs:
+//   offsets: pointer to (B + 1, ) row offsets of the sequences.
+//   logits: pointer to (N, D) logits.
+//   targets: pointer to (B, maxU - 1) targets in the batch.
+//   srcLengths: pointer to (B, ) source lengths in the batch.
+//   tgtLengths: pointer to (B, ) target lengths in the batch.
+//   denominators, logProbs, alphas, betas: (N, ), (N, 2), (N, ) and (N, )
+//     buffers.
+//
+// Outputs:
+//   costs: pointer to (B, ) costs in the batch.
+//   gradients: pointer to (N, D) gradients, or nullptr.
+template <typename DTYPE, typename CAST_DTYPE>
+void ComputePacked(
+    const Options& options,
+    const int64_t* offsets,
+    const DTYPE* logits,
+    const int* targets,
+    const int* srcLengths,
+    const int* tgtLengths,
+    CAST_DTYPE* denominators,
+    CAST_DTYPE* logProbs,
+    CAST_DTYPE* alphas,
+    CAST_DTYPE* betas,
+    DTYPE* costs,
+    DTYPE* gradients) {
+  const int& B = options.batchSize_;
+  const int& maxU = options.maxTgtLen_;
+  const int& D = options.numTargets_;
+
+  TORCH_CHECK(options.packed_);
+
+  { // compute denominators of the real cells only.
+    LogSumExp2D<DTYPE, CAST_DTYPE>(
+        /*options=*/options,
+        /*N=*/static_cast<int>(offsets[B]),
+        /*D=*/D,
+        /*logits=*/logits,
+        /*denominators=*/denominators);
+  }
+
+  ParallelFor(options, B, [&](int b) {
+    const int64_t offset = offsets[b];
+    const int T = srcLengths[b];
+    const int U = tgtLengths[b] + 1; // with prepended blank.
+
+    TensorView<const DTYPE, 3> seqLogits({T, U, D}, logits + offset * D);
+    TensorView<const CAST_DTYPE, 2> seqDenoms({T, U}, denominators + offset);
+    TensorView<LogProbs<CAST_DTYPE>, 2> seqLogProbs(
+        {T, U}, reinterpret_cast<LogProbs<CAST_DTYPE>*>(logProbs) + offset);
+    TensorView<const LogProbs<CAST_DTYPE>, 2> constLogProbs(
+        {T, U},
+        reinterpret_cast<const LogProbs<CAST_DTYPE>*>(logProbs) + offset);
+    TensorView<CAST_DTYPE, 2> seqAlphas({T, U}, alphas + offset);
+    TensorView<CAST_DTYPE, 2> seqBetas({T, U}, betas + offset);
+    const int* seqTargets = targets + b * (maxU - 1);
+
+    ComputeLogProbsOneSequence<DTYPE, CAST_DTYPE>(
+        /*options=*/options,
+        /*logits=*/seqLogits,
+        /*targets=*/seqTargets,
+        /*srcLen=*/T,
+        /*tgtLen=*/U,
+        /*denom=*/seqDenoms,
+        /*logProbs=*/seqLogProbs);
+    ComputeAlphaOneSequence<CAST_DTYPE>(
+        /*logProbs=*/constLogProbs,
+        /*srcLen=*/T,
+        /*tgtLen=*/U,
+        /*alpha=*/seqAlphas);
+    costs[b] = -ComputeBetaOneSequence<CAST_DTYPE>(
+        /*logProbs=*/constLogProbs,
+        /*srcLen=*/T,
+        /*tgtLen=*/U,
+        /*beta=*/seqBetas);
+
+    if (gradients != nullptr) {
+      TensorView<const CAST_DTYPE, 2> constAlphas({T, U}, alphas + offset);
+      TensorView<const CAST_DTYPE, 2> constBetas({T, U}, betas + offset);
+      TensorView<DTYPE, 3> seqGradients({T, U, D}, gradients + offset * D);
+      ComputeGradientsOneSequence<DTYPE, CAST_DTYPE>(
+          /*options=*/options,
+          /*logits=*/seqLogits,
+          /*targets=*/seqTargets,
+          /*srcLen=*/T,
+          /*tgtLen=*/U,
+          /*denom=*/seqDenoms,
+          /*alpha=*/constAlphas,
+          /*beta=*/constBetas,
+          /*gradients=*/seqGradients);
+    }
+  });
+}
+
+} // namespace cpu
+} // namespace rnnt
+} // namespace torchaudio
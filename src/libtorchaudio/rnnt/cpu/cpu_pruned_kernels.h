@@ -0,0 +1,352 @@
+#pragma once
+
+#include <libtorchaudio/rnnt/cpu/cpu_kernels.h>
+
+namespace torchaudio {
+namespace rnnt {
+namespace cpu {
+
+// Kernels of the pruned transducer loss.
+//
+// For every frame t, only the sRange symbols u in [ranges[t],
+// ranges[t] + sRange) of the (T, U) lattice are kept, so logits, log probs,
+// alphas and betas are stored on a (T, sRange) band: cell (t, s) of the band
+// is the node (t, ranges[t] + s) of the lattice. Nodes outside of the band
+// and nodes with u >= U have zero probability.
+
+template <typename DTYPE>
+FORCE_INLINE DTYPE LogAddOrNegInf(DTYPE x, DTYPE y) {
+  const DTYPE kNegInfinity = -std::numeric_limits<DTYPE>::infinity();
+  if (x == kNegInfinity) {
+    return y;
+  }
+  if (y == kNegInfinity) {
+    return x;
+  }
+  return math::lse(x, y);
+}
+
+// Returns the band index s of node (t, u), or -1 if it is outside of the band.
+FORCE_INLINE int
+BandIndex(const int* ranges, int sRange, int tgtLen, int t, int u) {
+  const int s = u - ranges[t];
+  return (s >= 0 && s < sRange && u < tgtLen) ? s : -1;
+}
+
+template <typename DTYPE, typename CAST_DTYPE>
+void ComputePrunedLogProbsOneSequence(
+    const Options& options,
+    TensorView<const DTYPE, 3>& logits,
+    const int* targets,
+    const int* ranges,
+    int srcLen,
+    int tgtLen,
+    int sRange,
+    TensorView<CAST_DTYPE, 2>& denom,
+    TensorView<LogProbs<CAST_DTYPE>, 2>& logProbs) {
+  const int& T = srcLen;
+  const int& U = tgtLen;
+  const int& S = sRange;
+  const int& D = options.numTargets_;
+  const int& blank = options.blank_;
+
+  for (int t = 0; t < T; ++t) {
+    for (int s = 0; s < S; ++s) {
+      const int u = ranges[t] + s;
+      if (u >= U) {
+        break;
+      }
+      denom({t, s}) = 0;
+      if (options.fusedLogSmax_) {
+        denom({t, s}) = CAST_DTYPE(RowLogSumExp(&logits({t, s, 0}), D));
+      }
+      logProbs({t, s}).skip() =
+          CAST_DTYPE(logits({t, s, blank})) - denom({t, s});
+      logProbs({t, s}).emit() = (u < U - 1)
+          ? CAST_DTYPE(logits({t, s, targets[u]})) - denom({t, s})
+          : CAST_DTYPE(0);
+    }
+  }
+}
+
+template <typename DTYPE>
+DTYPE ComputePrunedAlphaOneSequence(
+    TensorView<const LogProbs<DTYPE>, 2>& logProbs,
+    const int* ranges,
+    int srcLen,
+    int tgtLen,
+    int sRange,
+    TensorView<DTYPE, 2>& alpha) {
+  const int& T = srcLen;
+  const int& U = tgtLen;
+  const int& S = sRange;
+  const DTYPE kNegInfinity = -std::numeric_limits<DTYPE>::infinity();
+
+  for (int t = 0; t < T; ++t) {
+    for (int s = 0; s < S; ++s) {
+      const int u = ranges[t] + s;
+      if (u >= U) {
+        alpha({t, s}) = kNegInfinity;
+        continue;
+      }
+      if (t == 0 && u == 0) {
+        alpha({t, s}) = DTYPE(0);
+        continue;
+      }
+      DTYPE skip = kNegInfinity;
+      const int prev = (t > 0) ? BandIndex(ranges, S, U, t - 1, u) : -1;
+      if (prev >= 0) {
+        skip = alpha({t - 1, prev}) + logProbs({t - 1, prev}).skip();
+      }
+      DTYPE emit = kNegInfinity;
+      if (s > 0) {
+        emit = alpha({t, s - 1}) + logProbs({t, s - 1}).emit();
+      }
+      alpha({t, s}) = LogAddOrNegInf(skip, emit);
+    }
+  }
+
+  const int last = BandIndex(ranges, S, U, T - 1, U - 1);
+  return alpha({T - 1, last}) + logProbs({T - 1, last}).skip();
+}
+
+template <typename DTYPE>
+DTYPE ComputePrunedBetaOneSequence(
+    TensorView<const LogProbs<DTYPE>, 2>& logProbs,
+    const int* ranges,
+    int srcLen,
+    int tgtLen,
+    int sRange,
+    TensorView<DTYPE, 2>& beta) {
+  const int& T = srcLen;
+  const int& U = tgtLen;
+  const int& S = sRange;
+  const DTYPE kNegInfinity = -std::numeric_limits<DTYPE>::infinity();
+
+  for (int t = T - 1; t >= 0; --t) {
+    for (int s = S - 1; s >= 0; --s) {
+      const int u = ranges[t] + s;
+      if (u >= U) {
+        beta({t, s}) = kNegInfinity;
+        continue;
+      }
+      if (t == T - 1 && u == U - 1) {
+        beta({t, s}) = logProbs({t, s}).skip();
+        continue;
+      }
+      DTYPE skip = kNegInfinity;
+      const int next = (t < T - 1) ? BandIndex(ranges, S, U, t + 1, u) : -1;
+      if (next >= 0) {
+        skip = beta({t + 1, next}) + logProbs({t, s}).skip();
+      }
+      DTYPE emit = kNegInfinity;
+      if (s < S - 1 && u < U - 1) {
+        emit = beta({t, s + 1}) + logProbs({t, s}).emit();
+      }
+      beta({t, s}) = LogAddOrNegInf(skip, emit);
+    }
+  }
+
+  return beta({0, 0});
+}
+
+template <typename DTYPE, typename CAST_DTYPE>
+void ComputePrunedGradientsOneSequence(
+    const Options& options,
+    TensorView<const DTYPE, 3>& logits,
+    const int* targets,
+    const int* ranges,
+    int srcLen,
+    int tgtLen,
+    int sRange,
+    TensorView<const CAST_DTYPE, 2>& denom,
+    TensorView<const CAST_DTYPE, 2>& alpha,
+    TensorView<const CAST_DTYPE, 2>& beta,
+    TensorView<DTYPE, 3>& gradients) {
+  const int& T = srcLen;
+  const int& U = tgtLen;
+  const int& S = sRange;
+  const int& D = options.numTargets_;
+  const int& blank = options.blank_;
+  const CAST_DTYPE clamp = options.clamp_;
+  const bool& fusedLogSmax = options.fusedLogSmax_;
+  const CAST_DTYPE kNegInfinity =
+      -std::numeric_limits<CAST_DTYPE>::infinity();
+
+  CAST_DTYPE cost = -beta({0, 0});
+
+  for (int t = 0; t < T; ++t) {
+    for (int s = 0; s < S; ++s) {
+      const int u = ranges[t] + s;
+      if (u >= U) {
+        break;
+      }
+      // beta of the nodes reached by a blank and by the target from (t, u).
+      CAST_DTYPE skipBeta = kNegInfinity;
+      if (t == T - 1 && u == U - 1) {
+        skipBeta = CAST_DTYPE(0);
+      } else if (t < T - 1) {
+        const int next = BandIndex(ranges, S, U, t + 1, u);
+        if (next >= 0) {
+          skipBeta = beta({t + 1, next});
+        }
+      }
+      CAST_DTYPE emitBeta = kNegInfinity;
+      if (s < S - 1 && u < U - 1) {
+        emitBeta = beta({t, s + 1});
+      }
+
+      const CAST_DTYPE c = alpha({t, s}) + cost - denom({t, s});
+      for (int d = 0; d < D; ++d) {
+        const CAST_DTYPE g = CAST_DTYPE(logits({t, s, d})) + c;
+        CAST_DTYPE grad;
+        if (fusedLogSmax) {
+          grad = std::exp(g + beta({t, s}));
+          if (d == blank) {
+            grad -= std::exp(g + skipBeta);
+          } else if (u < U - 1 && d == targets[u]) {
+            grad -= std::exp(g + emitBeta);
+          }
+        } else {
+          grad = CAST_DTYPE(0);
+          if (d == blank) {
+            grad = -std::exp(g + skipBeta);
+          } else if (u < U - 1 && d == targets[u]) {
+            grad = -std::exp(g + emitBeta);
+          }
+        }
+        if (clamp > 0) {
+          grad = math::min(grad, clamp);
+          grad = math::max(grad, -clamp);
+        }
+        gradients({t, s, d}) = grad;
+      }
+    }
+  }
+}
+
+// Picks, for every frame, the window of sRange symbols that holds most of the
+// occupation probability of the frame, then adjusts the windows so that they
+// are non-decreasing, consecutive windows overlap, and the first and last
+// nodes of the lattice are covered.
+template <typename DTYPE>
+void ComputePruningRangesOneSequence(
+    TensorView<const DTYPE, 2>& occupation,
+    int srcLen,
+    int tgtLen,
+    int sRange,
+    int* ranges) {
+  const int& T = srcLen;
+  const int& U = tgtLen;
+  const int S = std::min(sRange, U);
+
+  std::vector<DTYPE> cumsum(U + 1);
+  for (int t = 0; t < T; ++t) {
+    cumsum[0] = 0;
+    for (int u = 0; u < U; ++u) {
+      cumsum[u + 1] = cumsum[u] + occupation({t, u});
+    }
+    int best = 0;
+    for (int u = 1; u + S <= U; ++u) {
+      if (cumsum[u + S] - cumsum[u] > cumsum[best + S] - cumsum[best]) {
+        best = u;
+      }
+    }
+    ranges[t] = best;
+  }
+
+  ranges[0] = 0;
+  ranges[T - 1] = U - S;
+  for (int t = 1; t < T; ++t) {
+    ranges[t] = std::max(ranges[t], ranges[t - 1]);
+  }
+  for (int t = T - 2; t >= 0; --t) {
+    ranges[t] = std::max(ranges[t], ranges[t + 1] - (S - 1));
+  }
+}
+
+template <typename DTYPE, typename CAST_DTYPE>
+void ComputePruned(
+    const Options& options,
+    int sRange,
+    const DTYPE* logits,
+    const int* targets,
+    const int* ranges,
+    const int* srcLengths,
+    const int* tgtLengths,
+    CAST_DTYPE* denominators,
+    CAST_DTYPE* logProbs,
+    CAST_DTYPE* alphas,
+    CAST_DTYPE* betas,
+    DTYPE* costs,
+    DTYPE* gradients) {
+  const int& B = options.batchSize_;
+  const int& maxT = options.maxSrcLen_;
+  const int& maxU = options.maxTgtLen_;
+  const int& D = options.numTargets_;
+  const int& S = sRange;
+
+  ParallelFor(options, B, [&](int b) {
+    const int64_t offset = int64_t(b) * maxT * S;
+    TensorView<const DTYPE, 3> seqLogits({maxT, S, D}, logits + offset * D);
+    TensorView<DTYPE, 3> seqGradients({maxT, S, D}, gradients + offset * D);
+    TensorView<CAST_DTYPE, 2> seqDenoms({maxT, S}, denominators + offset);
+    TensorView<LogProbs<CAST_DTYPE>, 2> seqLogProbs(
+        {maxT, S}, reinterpret_cast<LogProbs<CAST_DTYPE>*>(logProbs) + offset);
+    TensorView<CAST_DTYPE, 2> seqAlphas({maxT, S}, alphas + offset);
+    TensorView<CAST_DTYPE, 2> seqBetas({maxT, S}, betas + offset);
+    TensorView<const LogProbs<CAST_DTYPE>, 2> constLogProbs(
+        {maxT, S},
+        reinterpret_cast<const LogProbs<CAST_DTYPE>*>(logProbs) + offset);
+    TensorView<const CAST_DTYPE, 2> constDenoms(
+        {maxT, S}, denominators + offset);
+    TensorView<const CAST_DTYPE, 2> constAlphas({maxT, S}, alphas + offset);
+    TensorView<const CAST_DTYPE, 2> constBetas({maxT, S}, betas + offset);
+
+    const int* seqTargets = targets + b * (maxU - 1);
+    const int* seqRanges = ranges + b * maxT;
+    const int T = srcLengths[b];
+    const int U = tgtLengths[b] + 1; // with prepended blank.
+
+    ComputePrunedLogProbsOneSequence<DTYPE, CAST_DTYPE>(
+        /*options=*/options,
+        /*logits=*/seqLogits,
+        /*targets=*/seqTargets,
+        /*ranges=*/seqRanges,
+        /*srcLen=*/T,
+        /*tgtLen=*/U,
+        /*sRange=*/S,
+        /*denom=*/seqDenoms,
+        /*logProbs=*/seqLogProbs);
+    ComputePrunedAlphaOneSequence<CAST_DTYPE>(
+        /*logProbs=*/constLogProbs,
+        /*ranges=*/seqRanges,
+        /*srcLen=*/T,
+        /*tgtLen=*/U,
+        /*sRange=*/S,
+        /*alpha=*/seqAlphas);
+    costs[b] = -ComputePrunedBetaOneSequence<CAST_DTYPE>(
+        /*logProbs=*/constLogProbs,
+        /*ranges=*/seqRanges,
+        /*srcLen=*/T,
+        /*tgtLen=*/U,
+        /*sRange=*/S,
+        /*beta=*/seqBetas);
+    ComputePrunedGradientsOneSequence<DTYPE, CAST_DTYPE>(
+        /*options=*/options,
+        /*logits=*/seqLogits,
+        /*targets=*/seqTargets,
+        /*ranges=*/seqRanges,
+        /*srcLen=*/T,
+        /*tgtLen=*/U,
+        /*sRange=*/S,
+        /*denom=*/constDenoms,
+        /*alpha=*/constAlphas,
+        /*beta=*/constBetas,
+        /*gradients=*/seqGradients);
+  });
+}
+
+} // namespace cpu
+} // namespace rnnt
+} // namespace torchaudio
@@ -37,6 +37,7 @@ status_t Compute(
 
   { // compute denominators.
     LogSumExp2D<DTYPE, CAST_DTYPE>(
+        /*options=*/options,
         /*N=*/B * maxT * maxU,
         /*D=*/D,
         /*logits=*/logits,
@@ -81,6 +82,60 @@ status_t Compute(
   return SUCCESS;
 }
 
+// Forward pass of the loss that defers the gradients to ComputeGradients:
+// the denominators, alphas and betas needed by the gradients are written to
+// caller-owned (B, maxT, maxU) buffers, while the log probs only live in the
+// (B, maxT, maxU, 2) scratch buffer.
+template <typename DTYPE, typename CAST_DTYPE>
+status_t ComputeDeferred(
+    const Options& options,
+    const DTYPE* logits,
+    const int* targets,
+    const int* srcLengths,
+    const int* tgtLengths,
+    CAST_DTYPE* denominators,
+    CAST_DTYPE* logProbs,
+    CAST_DTYPE* alphas,
+    CAST_DTYPE* betas,
+    DTYPE* costs) {
+  TORCH_CHECK_EQ(options.device_, CPU);
+
+  const int& D = options.numTargets_;
+
+  { // compute denominators.
+    LogSumExp2D<DTYPE, CAST_DTYPE>(
+        /*options=*/options,
+        /*N=*/options.BTU(),
+        /*D=*/D,
+        /*logits=*/logits,
+        /*denominators=*/denominators);
+  }
+
+  { // compute log prob pairs.
+    ComputeLogProbs<DTYPE, CAST_DTYPE>(
+        /*options=*/options,
+        /*logits=*/logits,
+        /*targets=*/targets,
+        /*srcLengths=*/srcLengths,
+        /*tgtLengths=*/tgtLengths,
+        /*denominators=*/denominators,
+        /*log_probs=*/logProbs);
+  }
+
+  { // compute alphas and betas.
+    ComputeAlphasBetas<DTYPE, CAST_DTYPE>(
+        /*options=*/options,
+        /*log_probs=*/logProbs,
+        /*srcLengths=*/srcLengths,
+        /*tgtLengths=*/tgtLengths,
+        /*alphas=*/alphas,
+        /*betas=*/betas,
+        /*costs=*/costs);
+  }
+
+  return SUCCESS;
+}
+
 template <typename DTYPE, typename CAST_DTYPE>
 status_t ComputeAlphas(
     const Workspace<CAST_DTYPE>& workspace,
@@ -100,6 +155,7 @@ status_t ComputeAlphas(
 
   { // compute denominators.
     LogSumExp2D<DTYPE, CAST_DTYPE>(
+        /*options=*/options,
         /*N=*/B * maxT * maxU,
         /*D=*/D,
         /*logits=*/logits,
@@ -149,6 +205,7 @@ status_t ComputeBetas(
 
   { // compute denominators.
     LogSumExp2D<DTYPE, CAST_DTYPE>(
+        /*options=*/options,
         /*N=*/B * maxT * maxU,
         /*D=*/D,
         /*logits=*/logits,
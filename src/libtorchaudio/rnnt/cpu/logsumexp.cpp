@@ -0,0 +1,314 @@
+#include <libtorchaudio/rnnt/cpu/logsumexp.h>
+#include <torch/script.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TORCHAUDIO_RNNT_X86_KERNELS
+#include <immintrin.h>
+#define TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+namespace torchaudio {
+namespace rnnt {
+namespace cpu {
+
+namespace {
+
+constexpr float kLowest = std::numeric_limits<float>::lowest();
+
+// Reduces per-lane (max, sum of exp(x - max)) pairs together with n trailing
+// elements that did not fill a vector.
+template <typename DTYPE>
+float CombineLanes(
+    const float* maxs,
+    const float* sums,
+    int lanes,
+    const DTYPE* tail,
+    int n) {
+  float max = kLowest;
+  for (int i = 0; i < lanes; ++i) {
+    max = std::max(max, maxs[i]);
+  }
+  for (int i = 0; i < n; ++i) {
+    max = std::max(max, float(tail[i]));
+  }
+  float sum = 0;
+  for (int i = 0; i < lanes; ++i) {
+    sum += sums[i] * std::exp(maxs[i] - max);
+  }
+  for (int i = 0; i < n; ++i) {
+    sum += std::exp(float(tail[i]) - max);
+  }
+  return max + std::log(sum);
+}
+
+template <typename DTYPE>
+float RowLogSumExpScalar(const DTYPE* row, int D) {
+  return CombineLanes<DTYPE>(nullptr, nullptr, 0, row, D);
+}
+
+#ifdef TORCHAUDIO_RNNT_X86_KERNELS
+
+// Cephes-style exp: range reduction to [-ln2/2, ln2/2] followed by a degree 6
+// polynomial, within 2 ulp of std::exp. Inputs below -87.3 (including -inf)
+// flush to 0, which is all the log-sum-exp needs as its arguments are <= 0.
+constexpr float kExpLo = -87.3f;
+constexpr float kExpHi = 88.3f;
+constexpr float kLog2e = 1.44269504088896341f;
+constexpr float kLn2Hi = 0.693359375f;
+constexpr float kLn2Lo = -2.12194440e-4f;
+constexpr float kExpP0 = 1.9875691500e-4f;
+constexpr float kExpP1 = 1.3981999507e-3f;
+constexpr float kExpP2 = 8.3334519073e-3f;
+constexpr float kExpP3 = 4.1665795894e-2f;
+constexpr float kExpP4 = 1.6666665459e-1f;
+constexpr float kExpP5 = 5.0000001201e-1f;
+
+TARGET_AVX2 inline __m256 Exp(__m256 x) {
+  const __m256 underflow =
+      _mm256_cmp_ps(x, _mm256_set1_ps(kExpLo), _CMP_LT_OQ);
+  x = _mm256_max_ps(x, _mm256_set1_ps(kExpLo));
+  x = _mm256_min_ps(x, _mm256_set1_ps(kExpHi));
+
+  const __m256 fx = _mm256_round_ps(
+      _mm256_mul_ps(x, _mm256_set1_ps(kLog2e)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(kLn2Hi), x);
+  x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(kLn2Lo), x);
+
+  __m256 y = _mm256_set1_ps(kExpP0);
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP1));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP2));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP3));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP4));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP5));
+  y = _mm256_fmadd_ps(
+      y, _mm256_mul_ps(x, x), _mm256_add_ps(x, _mm256_set1_ps(1.f)));
+
+  __m256i n = _mm256_cvtps_epi32(fx);
+  n = _mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23);
+  y = _mm256_mul_ps(y, _mm256_castsi256_ps(n));
+  return _mm256_andnot_ps(underflow, y);
+}
+
+TARGET_AVX2 inline __m256 Load8(const float* p) {
+  return _mm256_loadu_ps(p);
+}
+
+TARGET_AVX2 inline __m256 Load8(const c10::Half* p) {
+  return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+TARGET_AVX2 inline __m256 Load8(const c10::BFloat16* p) {
+  const __m256i x = _mm256_cvtepu16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(x, 16));
+}
+
+template <typename DTYPE>
+TARGET_AVX2 float RowLogSumExpAvx2(const DTYPE* row, int D) {
+  __m256 max = _mm256_set1_ps(kLowest);
+  __m256 sum = _mm256_setzero_ps();
+  int j = 0;
+  for (; j + 8 <= D; j += 8) {
+    const __m256 x = Load8(row + j);
+    const __m256 newMax = _mm256_max_ps(max, x);
+    sum = _mm256_fmadd_ps(
+        sum,
+        Exp(_mm256_sub_ps(max, newMax)),
+        Exp(_mm256_sub_ps(x, newMax)));
+    max = newMax;
+  }
+  alignas(32) float maxs[8];
+  alignas(32) float sums[8];
+  _mm256_store_ps(maxs, max);
+  _mm256_store_ps(sums, sum);
+  return CombineLanes<DTYPE>(maxs, sums, 8, row + j, D - j);
+}
+
+TARGET_AVX512 inline __m512 Exp(__m512 x) {
+  const __mmask16 underflow =
+      _mm512_cmp_ps_mask(x, _mm512_set1_ps(kExpLo), _CMP_LT_OQ);
+  x = _mm512_max_ps(x, _mm512_set1_ps(kExpLo));
+  x = _mm512_min_ps(x, _mm512_set1_ps(kExpHi));
+
+  const __m512 fx = _mm512_roundscale_ps(
+      _mm512_mul_ps(x, _mm512_set1_ps(kLog2e)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  x = _mm512_fnmadd_ps(fx, _mm512_set1_ps(kLn2Hi), x);
+  x = _mm512_fnmadd_ps(fx, _mm512_set1_ps(kLn2Lo), x);
+
+  __m512 y = _mm512_set1_ps(kExpP0);
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(kExpP1));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(kExpP2));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(kExpP3));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(kExpP4));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(kExpP5));
+  y = _mm512_fmadd_ps(
+      y, _mm512_mul_ps(x, x), _mm512_add_ps(x, _mm512_set1_ps(1.f)));
+
+  __m512i n = _mm512_cvtps_epi32(fx);
+  n = _mm512_slli_epi32(_mm512_add_epi32(n, _mm512_set1_epi32(127)), 23);
+  y = _mm512_mul_ps(y, _mm512_castsi512_ps(n));
+  return _mm512_maskz_mov_ps(static_cast<__mmask16>(~underflow), y);
+}
+
+TARGET_AVX512 inline __m512 Load16(const float* p) {
+  return _mm512_loadu_ps(p);
+}
+
+TARGET_AVX512 inline __m512 Load16(const c10::Half* p) {
+  return _mm512_cvtph_ps(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+}
+
+TARGET_AVX512 inline __m512 Load16(const c10::BFloat16* p) {
+  const __m512i x = _mm512_cvtepu16_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(x, 16));
+}
+
+template <typename DTYPE>
+TARGET_AVX512 float RowLogSumExpAvx512(const DTYPE* row, int D) {
+  __m512 max = _mm512_set1_ps(kLowest);
+  __m512 sum = _mm512_setzero_ps();
+  int j = 0;
+  for (; j + 16 <= D; j += 16) {
+    const __m512 x = Load16(row + j);
+    const __m512 newMax = _mm512_max_ps(max, x);
+    sum = _mm512_fmadd_ps(
+        sum,
+        Exp(_mm512_sub_ps(max, newMax)),
+        Exp(_mm512_sub_ps(x, newMax)));
+    max = newMax;
+  }
+  alignas(64) float maxs[16];
+  alignas(64) float sums[16];
+  _mm512_store_ps(maxs, max);
+  _mm512_store_ps(sums, sum);
+  return CombineLanes<DTYPE>(maxs, sums, 16, row + j, D - j);
+}
+
+#endif // TORCHAUDIO_RNNT_X86_KERNELS
+
+enum class Isa { kDefault, kAvx2, kAvx512 };
+
+Isa DetectIsa() {
+  Isa isa = Isa::kDefault;
+#ifdef TORCHAUDIO_RNNT_X86_KERNELS
+  __builtin_cpu_init();
+  // the AVX2 kernel converts half rows with F16C.
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+      __builtin_cpu_supports("f16c")) {
+    isa = Isa::kAvx2;
+  }
+  if (__builtin_cpu_supports("avx512f")) {
+    isa = Isa::kAvx512;
+  }
+#endif
+  const char* env = std::getenv("ATEN_CPU_CAPABILITY");
+  if (env != nullptr) {
+    if (std::strcmp(env, "default") == 0) {
+      isa = Isa::kDefault;
+    } else if (std::strcmp(env, "avx2") == 0 && isa == Isa::kAvx512) {
+      isa = Isa::kAvx2;
+    }
+  }
+  return isa;
+}
+
+Isa GetIsa() {
+  static const Isa isa = DetectIsa();
+  return isa;
+}
+
+template <typename DTYPE>
+float RowLogSumExpImpl(const DTYPE* row, int D) {
+  switch (GetIsa()) {
+#ifdef TORCHAUDIO_RNNT_X86_KERNELS
+    case Isa::kAvx512:
+      return RowLogSumExpAvx512<DTYPE>(row, D);
+    case Isa::kAvx2:
+      return RowLogSumExpAvx2<DTYPE>(row, D);
+#endif
+    default:
+      return RowLogSumExpScalar<DTYPE>(row, D);
+  }
+}
+
+} // namespace
+
+float RowLogSumExp(const float* row, int D) {
+  return RowLogSumExpImpl<float>(row, D);
+}
+
+float RowLogSumExp(const c10::Half* row, int D) {
+  return RowLogSumExpImpl<c10::Half>(row, D);
+}
+
+float RowLogSumExp(const c10::BFloat16* row, int D) {
+  return RowLogSumExpImpl<c10::BFloat16>(row, D);
+}
+
+namespace {
+
+template <typename DTYPE>
+void RowLogSumExps(const DTYPE* rows, int64_t N, int D, float* output) {
+  for (int64_t n = 0; n < N; ++n) {
+    output[n] = RowLogSumExp(rows + n * D, D);
+  }
+}
+
+// Log-sum-exp of the rows of a (N, D) tensor, in float, with the kernel used
+// by the loss, so that its accuracy can be tested directly.
+torch::Tensor row_logsumexp(const torch::Tensor& x) {
+  TORCH_CHECK(x.device().is_cpu(), "x must be on CPU.");
+  TORCH_CHECK(x.dim() == 2, "x must be a 2D tensor.");
+  const torch::Tensor rows = x.contiguous();
+  const int64_t N = rows.size(0);
+  const int D = rows.size(1);
+  torch::Tensor output =
+      torch::empty({N}, rows.options().dtype(torch::kFloat32));
+
+  switch (rows.scalar_type()) {
+    case torch::ScalarType::Float: {
+      RowLogSumExps(rows.data_ptr<float>(), N, D, output.data_ptr<float>());
+      break;
+    }
+    case torch::ScalarType::Half: {
+      RowLogSumExps(
+          rows.data_ptr<c10::Half>(), N, D, output.data_ptr<float>());
+      break;
+    }
+    case torch::ScalarType::BFloat16: {
+      RowLogSumExps(
+          rows.data_ptr<c10::BFloat16>(), N, D, output.data_ptr<float>());
+      break;
+    }
+    default: {
+      TORCH_CHECK(false, "unsupported dtype ", rows.scalar_type());
+    }
+  };
+  return output;
+}
+
+} // namespace
+
+// Private op, only meant for the tests.
+TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
+  m.def("torchaudio::_rnnt_row_logsumexp_for_test(Tensor x) -> Tensor");
+}
+
+TORCH_LIBRARY_IMPL(torchaudio, CPU, m) {
+  m.impl("_rnnt_row_logsumexp_for_test", &row_logsumexp);
+}
+
+} // namespace cpu
+} // namespace rnnt
+} // namespace torchaudio
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <c10/util/BFloat16.h>
+#include <c10/util/Half.h>
+
+namespace torchaudio {
+namespace rnnt {
+namespace cpu {
+
+// Computes log(sum_j(exp(row[j]))) over a row of D logits, in float.
+//
+// The row is scanned once, keeping a running max and a sum of exponentials
+// that is rescaled whenever the max grows (online log-sum-exp). The kernel is
+// picked at runtime from AVX-512, AVX2 and a portable scalar fallback; the
+// choice can be capped with the ATEN_CPU_CAPABILITY environment variable
+// ("default", "avx2" or "avx512"), as for ATen kernels.
+float RowLogSumExp(const float* row, int D);
+float RowLogSumExp(const c10::Half* row, int D);
+float RowLogSumExp(const c10::BFloat16* row, int D);
+
+} // namespace cpu
+} // namespace rnnt
+} // namespace torchaudio
@@ -0,0 +1,156 @@
+#include <libtorchaudio/rnnt/cpu/workspace_pool.h>
+
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace torchaudio {
+namespace rnnt {
+namespace cpu {
+
+namespace {
+
+using Key = std::tuple<int64_t, int64_t, int64_t>;
+
+// 1 GiB of idle workspaces by default.
+constexpr int64_t DEFAULT_MAX_IDLE_BYTES = int64_t(1) << 30;
+
+// Rounds n up to a multiple of an eighth of its highest power of two, so that
+// the padding is at most 12.5%, e.g. 100 -> 104, 1000 -> 1024, 1100 -> 1152.
+int64_t RoundUpToBucket(int64_t n) {
+  int64_t step = 1;
+  while ((step << 4) <= n) {
+    step <<= 1;
+  }
+  return (n + step - 1) / step * step;
+}
+
+struct Pool {
+  std::mutex mutex;
+  // the idle buffers, the most recently released first.
+  std::list<std::pair<Key, torch::Tensor>> idle;
+  int64_t idle_bytes = 0;
+  int64_t max_idle_bytes = DEFAULT_MAX_IDLE_BYTES;
+  int64_t allocations = 0;
+  int64_t reuses = 0;
+
+  // Moves the least recently released buffers beyond the limit to evicted,
+  // so that they are freed outside of the lock.
+  void Evict(std::vector<torch::Tensor>& evicted) {
+    while (idle_bytes > max_idle_bytes) {
+      idle_bytes -= idle.back().second.nbytes();
+      evicted.push_back(std::move(idle.back().second));
+      idle.pop_back();
+    }
+  }
+};
+
+Pool& GetPool() {
+  static Pool* pool = new Pool();
+  return *pool;
+}
+
+} // namespace
+
+PooledWorkspace::PooledWorkspace(const Options& options) {
+  Options bucket = options;
+  bucket.batchSize_ = RoundUpToBucket(options.batchSize_);
+  bucket.maxSrcLen_ = RoundUpToBucket(options.maxSrcLen_);
+  bucket.maxTgtLen_ = RoundUpToBucket(options.maxTgtLen_);
+  key_ = Key(
+      int64_t(bucket.batchSize_) * bucket.nHypos_,
+      bucket.maxSrcLen_,
+      bucket.maxTgtLen_);
+
+  {
+    Pool& pool = GetPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    auto it = std::find_if(
+        pool.idle.begin(), pool.idle.end(), [&](const auto& entry) {
+          return entry.first == key_;
+        });
+    if (it != pool.idle.end()) {
+      buffer_ = std::move(it->second);
+      pool.idle_bytes -= buffer_.nbytes();
+      pool.idle.erase(it);
+      ++pool.reuses;
+    } else {
+      ++pool.allocations;
+    }
+  }
+  if (!buffer_.defined()) {
+    buffer_ = torch::empty(
+        DtypeWorkspace<float>::ComputeSizeFromOptions(bucket),
+        torch::TensorOptions()
+            .device(torch::kCPU)
+            .dtype(torch::ScalarType::Float));
+  }
+
+  // the int workspace is only used on GPU.
+  TORCH_CHECK_EQ(IntWorkspace::ComputeSizeFromOptions(options), 0);
+  workspace_.Reset(
+      /*options=*/options,
+      /*dtype_data=*/buffer_.data_ptr<float>(),
+      /*dtype_size=*/buffer_.numel(),
+      /*int_data=*/nullptr,
+      /*int_size=*/0);
+}
+
+PooledWorkspace::~PooledWorkspace() {
+  std::vector<torch::Tensor> evicted;
+  Pool& pool = GetPool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  pool.idle_bytes += buffer_.nbytes();
+  pool.idle.emplace_front(key_, std::move(buffer_));
+  pool.Evict(evicted);
+}
+
+void ReleaseWorkspaces() {
+  std::list<std::pair<Key, torch::Tensor>> idle;
+  {
+    Pool& pool = GetPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    idle.swap(pool.idle);
+    pool.idle_bytes = 0;
+  }
+  // buffers are freed here, outside of the lock.
+}
+
+void SetWorkspaceCacheLimit(int64_t max_bytes) {
+  TORCH_CHECK(max_bytes >= 0, "max_bytes must be non-negative.");
+  std::vector<torch::Tensor> evicted;
+  Pool& pool = GetPool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  pool.max_idle_bytes = max_bytes;
+  pool.Evict(evicted);
+}
+
+void release_workspaces() {
+  ReleaseWorkspaces();
+}
+
+void set_workspace_cache_limit(int64_t max_bytes) {
+  SetWorkspaceCacheLimit(max_bytes);
+}
+
+// Returns the bytes of the idle workspaces, and the number of workspaces
+// allocated and reused since the start of the process.
+std::tuple<int64_t, int64_t, int64_t> workspace_stats() {
+  Pool& pool = GetPool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  return std::make_tuple(pool.idle_bytes, pool.allocations, pool.reuses);
+}
+
+TORCH_LIBRARY_FRAGMENT(torchaudio, m) {
+  m.def("torchaudio::rnnt_release_workspaces", &release_workspaces);
+  m.def(
+      "torchaudio::rnnt_set_workspace_cache_limit",
+      &set_workspace_cache_limit);
+  m.def("torchaudio::rnnt_workspace_stats", &workspace_stats);
+}
+
+} // namespace cpu
+} // namespace rnnt
+} // namespace torchaudio
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <libtorchaudio/rnnt/workspace.h>
+#include <torch/script.h>
+
+#include <tuple>
+
+namespace torchaudio {
+namespace rnnt {
+namespace cpu {
+
+// Float workspaces of the CPU transducer are cached between calls, so that
+// training with variable length batches does not allocate and free a
+// B * max_T * max_U * 5 buffer at every step.
+//
+// Workspaces are keyed on (B, max_T, max_U) rounded up to buckets with at
+// most 12.5% of padding on each dimension: a buffer sized for the bucket fits
+// every shape that rounds up to it. Buffers are handed out exclusively, so
+// concurrent calls with the same bucket get different buffers.
+//
+// The idle buffers are kept up to a byte limit, beyond which the least
+// recently released ones are freed.
+class PooledWorkspace {
+ public:
+  explicit PooledWorkspace(const Options& options);
+  ~PooledWorkspace();
+
+  PooledWorkspace(const PooledWorkspace&) = delete;
+  PooledWorkspace& operator=(const PooledWorkspace&) = delete;
+
+  Workspace<float>& Get() {
+    return workspace_;
+  }
+
+ private:
+  std::tuple<int64_t, int64_t, int64_t> key_;
+  torch::Tensor buffer_;
+  Workspace<float> workspace_;
+};
+
+// Frees the cached workspaces that are not in use.
+void ReleaseWorkspaces();
+
+// Sets the maximum number of bytes of the idle workspaces, and frees the least
+// recently released ones beyond it.
+void SetWorkspaceCacheLimit(int64_t max_bytes);
+
+} // namespace cpu
+} // namespace rnnt
+} // namespace torchaudio
@@ -6,15 +6,19 @@ namespace torchaudio {
 namespace rnnt {
 namespace gpu {
 
-// Entry point into RNNT Loss
-std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
-    torch::Tensor& logits,
+namespace {
+
+// Computes the costs, and writes the gradients into gradients, which may be
+// logits itself.
+torch::Tensor compute_costs_and_gradients(
+    const torch::Tensor& logits,
     const torch::Tensor& targets,
     const torch::Tensor& logit_lengths,
     const torch::Tensor& target_lengths,
     int64_t blank,
     double clamp,
-    bool fused_log_softmax = true) {
+    bool fused_log_softmax,
+    torch::Tensor& gradients) {
   TORCH_CHECK(
       logits.device().type() == targets.device().type(),
       "logits and targets must be on the same device");
@@ -92,8 +96,6 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
   torch::Tensor costs = torch::empty(
       options.batchSize_ * options.nHypos_,
       torch::TensorOptions().device(logits.device()).dtype(logits.dtype()));
-  std::optional<torch::Tensor> gradients = torch::zeros_like(logits);
-
   torch::Tensor int_workspace = torch::empty(
       IntWorkspace::ComputeSizeFromOptions(options),
       torch::TensorOptions()
@@ -122,7 +124,7 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
           /*logit_lengths=*/logit_lengths.data_ptr<int>(),
           /*target_lengths=*/target_lengths.data_ptr<int>(),
           /*costs=*/costs.data_ptr<float>(),
-          /*gradients=*/gradients->data_ptr<float>());
+          /*gradients=*/gradients.data_ptr<float>());
       break;
     }
     case torch::ScalarType::Half: {
@@ -133,7 +135,7 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
           /*logit_lengths=*/logit_lengths.data_ptr<int>(),
           /*target_lengths=*/target_lengths.data_ptr<int>(),
           /*costs=*/costs.data_ptr<c10::Half>(),
-          /*gradients=*/gradients->data_ptr<c10::Half>());
+          /*gradients=*/gradients.data_ptr<c10::Half>());
       break;
     }
     default: {
@@ -141,11 +143,60 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
     }
   };
 
+  return costs;
+}
+
+} // namespace
+
+// Entry point into RNNT Loss
+std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute(
+    torch::Tensor& logits,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    double clamp,
+    bool fused_log_softmax = true,
+    int64_t num_threads = 0) {
+  torch::Tensor gradients = torch::zeros_like(logits);
+  torch::Tensor costs = compute_costs_and_gradients(
+      logits,
+      targets,
+      logit_lengths,
+      target_lengths,
+      blank,
+      clamp,
+      fused_log_softmax,
+      gradients);
   return std::make_tuple(costs, gradients);
 }
 
+// Same as compute, with the gradients written into the storage of the logits.
+// ComputeGradients zeroes the padding when gradients alias logits.
+std::tuple<torch::Tensor, std::optional<torch::Tensor>> compute_reuse_logits(
+    torch::Tensor& logits,
+    const torch::Tensor& targets,
+    const torch::Tensor& logit_lengths,
+    const torch::Tensor& target_lengths,
+    int64_t blank,
+    double clamp,
+    bool fused_log_softmax = true,
+    int64_t num_threads = 0) {
+  torch::Tensor costs = compute_costs_and_gradients(
+      logits,
+      targets,
+      logit_lengths,
+      target_lengths,
+      blank,
+      clamp,
+      fused_log_softmax,
+      logits);
+  return std::make_tuple(costs, logits);
+}
+
 TORCH_LIBRARY_IMPL(torchaudio, CUDA, m) {
   m.impl("rnnt_loss", &compute);
+  m.impl("rnnt_loss_reuse_logits", &compute_reuse_logits);
 }
 
 } // namespace gpu
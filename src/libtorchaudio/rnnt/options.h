@@ -5,6 +5,7 @@
 #endif // USE_CUDA
 
 #include <libtorchaudio/rnnt/types.h>
+#include <cstdint>
 #include <ostream>
 
 namespace torchaudio {
@@ -18,6 +19,7 @@ struct Options {
   cudaStream_t stream_;
 #endif
   // The maximum number of threads that can be used.
+  // 0 means all the intra-op threads (CPU only).
   int numThreads_;
 
   // the index for "blank".
@@ -46,6 +48,12 @@ struct Options {
   // True by default
   bool fusedLogSmax_;
 
+  // if set to true, logits of the sequences are concatenated as
+  // (sum_b T_b * (U_b + 1), D) rows, without padding, and so are the
+  // denominators, log probs, alphas, betas and gradients.
+  // False by default
+  bool packed_;
+
   Options()
       : device_(UNDEFINED),
         numThreads_(0),
@@ -57,14 +65,15 @@ struct Options {
         maxSrcLen_(0),
         maxTgtLen_(0),
         numTargets_(0),
-        fusedLogSmax_(true) {}
+        fusedLogSmax_(true),
+        packed_(false) {}
 
-  int BU() const {
-    return batchSize_ * maxTgtLen_ * nHypos_;
+  int64_t BU() const {
+    return int64_t(batchSize_) * maxTgtLen_ * nHypos_;
   }
 
-  int BTU() const {
-    return batchSize_ * maxSrcLen_ * maxTgtLen_ * nHypos_;
+  int64_t BTU() const {
+    return int64_t(batchSize_) * maxSrcLen_ * maxTgtLen_ * nHypos_;
   }
 
   friend std::ostream& operator<<(std::ostream& os, const Options& options) {
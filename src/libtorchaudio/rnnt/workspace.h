@@ -22,13 +22,13 @@ template <typename DTYPE>
 class DtypeWorkspace {
  public:
   DtypeWorkspace() : options_(), size_(0), data_(nullptr) {}
-  DtypeWorkspace(const Options& options, DTYPE* data, int size)
+  DtypeWorkspace(const Options& options, DTYPE* data, int64_t size)
       : DtypeWorkspace() {
     Reset(options, data, size);
   }
   ~DtypeWorkspace() {}
 
-  static int ComputeSizeFromOptions(const Options& options) {
+  static int64_t ComputeSizeFromOptions(const Options& options) {
     TORCH_CHECK_NE(options.device_, UNDEFINED);
     return ComputeSizeForDenominators(options) +
         ComputeSizeForLogProbs(options) + ComputeSizeForAlphas(options) +
@@ -36,14 +36,14 @@ class DtypeWorkspace {
   }
 
   void Free();
-  void Reset(const Options& options, DTYPE* data, int size) {
-    int needed_size = ComputeSizeFromOptions(options);
+  void Reset(const Options& options, DTYPE* data, int64_t size) {
+    int64_t needed_size = ComputeSizeFromOptions(options);
     TORCH_CHECK_LE(needed_size, size);
     options_ = options;
     data_ = data;
     size_ = size;
   }
-  int Size() const {
+  int64_t Size() const {
     return size_;
   }
 
@@ -61,24 +61,26 @@ class DtypeWorkspace {
   }
 
  private:
-  static int ComputeSizeForDenominators(const Options& options) { // B * T * U
+  static int64_t ComputeSizeForDenominators(
+      const Options& options) { // B * T * U
     return options.BTU();
   }
 
-  static int ComputeSizeForLogProbs(const Options& options) { // B * T * U * 2
+  static int64_t ComputeSizeForLogProbs(
+      const Options& options) { // B * T * U * 2
     return options.BTU() * 2;
   }
 
-  static int ComputeSizeForAlphas(const Options& options) { // B * T * U
+  static int64_t ComputeSizeForAlphas(const Options& options) { // B * T * U
     return options.BTU();
   }
 
-  static int ComputeSizeForBetas(const Options& options) { // B * T * U
+  static int64_t ComputeSizeForBetas(const Options& options) { // B * T * U
     return options.BTU();
   }
 
   Options options_;
-  int size_; // number of elements in allocated memory.
+  int64_t size_; // number of elements in allocated memory.
   DTYPE* data_; // pointer to the allocated memory.
 };
 
@@ -88,25 +90,26 @@ class DtypeWorkspace {
 class IntWorkspace {
  public:
   IntWorkspace() : options_(), size_(0), data_(nullptr) {}
-  IntWorkspace(const Options& options, int* data, int size) : IntWorkspace() {
+  IntWorkspace(const Options& options, int* data, int64_t size)
+      : IntWorkspace() {
     Reset(options, data, size);
   }
   ~IntWorkspace() {}
 
-  static int ComputeSizeFromOptions(const Options& options) {
+  static int64_t ComputeSizeFromOptions(const Options& options) {
     return ComputeSizeForAlphaCounters(options) +
         ComputeSizeForBetaCounters(options);
   }
 
-  void Reset(const Options& options, int* data, int size) {
-    int needed_size = ComputeSizeFromOptions(options);
+  void Reset(const Options& options, int* data, int64_t size) {
+    int64_t needed_size = ComputeSizeFromOptions(options);
     TORCH_CHECK_LE(needed_size, size);
     options_ = options;
     data_ = data;
     size_ = size;
     ResetAlphaBetaCounters();
   }
-  int Size() const {
+  int64_t Size() const {
     return size_;
   }
 
@@ -135,7 +138,7 @@ class IntWorkspace {
 #endif // USE_CUDA
   }
 
-  static int ComputeSizeForAlphaCounters(const Options& options) { // B * U
+  static int64_t ComputeSizeForAlphaCounters(const Options& options) { // B * U
 #ifdef USE_CUDA
     if (options.device_ == GPU) {
       return options.BU();
@@ -146,7 +149,7 @@ class IntWorkspace {
     return 0;
 #endif // USE_CUDA
   }
-  static int ComputeSizeForBetaCounters(const Options& options) { // B * U
+  static int64_t ComputeSizeForBetaCounters(const Options& options) { // B * U
 #ifdef USE_CUDA
     if (options.device_ == GPU) {
       return options.BU();
@@ -159,7 +162,7 @@ class IntWorkspace {
   }
 
   Options options_;
-  int size_; // number of elements in allocated memory.
+  int64_t size_; // number of elements in allocated memory.
   int* data_; // pointer to the allocated memory.
 };
 
@@ -173,9 +176,9 @@ class Workspace {
   Workspace(
       const Options& options,
       DTYPE* dtype_data,
-      int dtype_size,
+      int64_t dtype_size,
       int* int_data,
-      int int_size)
+      int64_t int_size)
       : Workspace() {
     Reset(options, dtype_data, dtype_size, int_data, int_size);
   }
@@ -184,9 +187,9 @@ class Workspace {
   void Reset(
       const Options& options,
       DTYPE* dtype_data,
-      int dtype_size,
+      int64_t dtype_size,
       int* int_data,
-      int int_size) {
+      int64_t int_size) {
     options_ = options;
     dtype_workspace_.Reset(options_, dtype_data, dtype_size);
     int_workspace_.Reset(options_, int_data, int_size);
@@ -1,9 +1,11 @@
 import math
+from functools import lru_cache
 from typing import Tuple
 
 import torch
 import torchaudio
 from torch import Tensor
+from torchaudio._extension import _IS_TORCHAUDIO_EXT_AVAILABLE
 
 __all__ = [
     "get_mel_banks",
@@ -11,6 +13,8 @@ __all__ = [
     "inverse_mel_scale_scalar",
     "mel_scale",
     "mel_scale_scalar",
+    "OnlineFbank",
+    "OnlineMfcc",
     "spectrogram",
     "fbank",
     "mfcc",
@@ -135,20 +139,34 @@ def _get_waveform_and_window_properties(
     channel = max(channel, 0)
     assert channel < waveform.size(0), "Invalid channel {} for size {}".format(channel, waveform.size(0))
     waveform = waveform[channel, :]  # size (n)
+    window_shift, window_size, padded_window_size = _get_window_properties(
+        sample_frequency, frame_shift, frame_length, round_to_power_of_two, preemphasis_coefficient
+    )
+
+    assert window_size <= len(waveform), "choose a window size {} that is [2, {}]".format(window_size, len(waveform))
+    return waveform, window_shift, window_size, padded_window_size
+
+
+def _get_window_properties(
+    sample_frequency: float,
+    frame_shift: float,
+    frame_length: float,
+    round_to_power_of_two: bool,
+    preemphasis_coefficient: float,
+) -> Tuple[int, int, int]:
+    r"""Gets the window properties, which do not depend on the waveform"""
     window_shift = int(sample_frequency * frame_shift * MILLISECONDS_TO_SECONDS)
     window_size = int(sample_frequency * frame_length * MILLISECONDS_TO_SECONDS)
     padded_window_size = _next_power_of_2(window_size) if round_to_power_of_two else window_size
 
-    assert 2 <= window_size <= len(waveform), "choose a window size {} that is [2, {}]".format(
-        window_size, len(waveform)
-    )
+    assert 2 <= window_size, "choose a window size {} that is at least 2".format(window_size)
     assert 0 < window_shift, "`window_shift` must be greater than 0"
     assert padded_window_size % 2 == 0, (
         "the padded `window_size` must be divisible by two." " use `round_to_power_of_two` or change `frame_length`"
     )
     assert 0.0 <= preemphasis_coefficient <= 1.0, "`preemphasis_coefficient` must be between [0,1]"
     assert sample_frequency > 0, "`sample_frequency` must be greater than zero"
-    return waveform, window_shift, window_size, padded_window_size
+    return window_shift, window_size, padded_window_size
 
 
 def _get_window(
@@ -511,6 +529,122 @@ def get_mel_banks(
     return bins, center_freqs
 
 
+def _get_mel_energies(
+    waveform: Tensor,
+    padded_window_size: int,
+    window_size: int,
+    window_shift: int,
+    window_type: str,
+    blackman_coeff: float,
+    snip_edges: bool,
+    raw_energy: bool,
+    energy_floor: float,
+    dither: float,
+    remove_dc_offset: bool,
+    preemphasis_coefficient: float,
+    use_power: bool,
+    num_mel_bins: int,
+    sample_frequency: float,
+    low_freq: float,
+    high_freq: float,
+    vtln_low: float,
+    vtln_high: float,
+    vtln_warp: float,
+    use_log_fbank: bool,
+) -> Tuple[Tensor, Tensor]:
+    r"""Gets the mel energies of the frames and their log energy
+
+    Returns:
+        (Tensor, Tensor): mel_energies of size (m, ``num_mel_bins``) and signal_log_energy of size (m)
+    """
+    device, dtype = waveform.device, waveform.dtype
+
+    # strided_input, size (m, padded_window_size) and signal_log_energy, size (m)
+    strided_input, signal_log_energy = _get_window(
+        waveform,
+        padded_window_size,
+        window_size,
+        window_shift,
+        window_type,
+        blackman_coeff,
+        snip_edges,
+        raw_energy,
+        energy_floor,
+        dither,
+        remove_dc_offset,
+        preemphasis_coefficient,
+    )
+
+    # size (m, padded_window_size // 2 + 1)
+    spectrum = torch.fft.rfft(strided_input).abs()
+    if use_power:
+        spectrum = spectrum.pow(2.0)
+
+    # size (num_mel_bins, padded_window_size // 2)
+    mel_energies, _ = get_mel_banks(
+        num_mel_bins, padded_window_size, sample_frequency, low_freq, high_freq, vtln_low, vtln_high, vtln_warp
+    )
+    mel_energies = mel_energies.to(device=device, dtype=dtype)
+
+    # pad right column with zeros and add dimension, size (num_mel_bins, padded_window_size // 2 + 1)
+    mel_energies = torch.nn.functional.pad(mel_energies, (0, 1), mode="constant", value=0)
+
+    # sum with mel fiterbanks over the power spectrum, size (m, num_mel_bins)
+    mel_energies = torch.mm(spectrum, mel_energies.T)
+    if use_log_fbank:
+        # avoid log of zero (which should be prevented anyway by dithering)
+        mel_energies = torch.max(mel_energies, _get_epsilon(device, dtype)).log()
+    return mel_energies, signal_log_energy
+
+
+def _add_log_energy(mel_energies: Tensor, signal_log_energy: Tensor, use_energy: bool, htk_compat: bool) -> Tensor:
+    r"""Returns the mel energies of size (m, ``num_mel_bins + use_energy``)"""
+    # if use_energy then add it as the last column for htk_compat == true else first column
+    if use_energy:
+        signal_log_energy = signal_log_energy.unsqueeze(1)  # size (m, 1)
+        # returns size (m, num_mel_bins + 1)
+        if htk_compat:
+            mel_energies = torch.cat((mel_energies, signal_log_energy), dim=1)
+        else:
+            mel_energies = torch.cat((signal_log_energy, mel_energies), dim=1)
+    return mel_energies
+
+
+def _can_use_native_fbank(waveform: Tensor) -> bool:
+    r"""Whether the native fbank, which runs on CPU and does not support autograd, can process the waveform"""
+    return (
+        waveform.device.type == "cpu"
+        and waveform.dtype in (torch.float32, torch.float64)
+        and not (waveform.requires_grad and torch.is_grad_enabled())
+    )
+
+
+@lru_cache(maxsize=16)
+def _get_fbank_constants(
+    window_type: str,
+    window_size: int,
+    blackman_coeff: float,
+    num_mel_bins: int,
+    padded_window_size: int,
+    sample_frequency: float,
+    low_freq: float,
+    high_freq: float,
+    vtln_low: float,
+    vtln_high: float,
+    vtln_warp: float,
+    dtype: torch.dtype,
+) -> Tuple[Tensor, Tensor]:
+    r"""Returns the window function of size (``window_size``) and the mel banks of size
+    (``num_mel_bins``, ``padded_window_size // 2 + 1``) of the native fbank on CPU"""
+    device = torch.device("cpu")
+    window_function = _feature_window_function(window_type, window_size, blackman_coeff, device, dtype)
+    mel_banks, _ = get_mel_banks(
+        num_mel_bins, padded_window_size, sample_frequency, low_freq, high_freq, vtln_low, vtln_high, vtln_warp
+    )
+    mel_banks = torch.nn.functional.pad(mel_banks.to(dtype=dtype), (0, 1), mode="constant", value=0)
+    return window_function, mel_banks
+
+
 def fbank(
     waveform: Tensor,
     blackman_coeff: float = 0.42,
@@ -538,6 +672,7 @@ def fbank(
     vtln_low: float = 100.0,
     vtln_warp: float = 1.0,
     window_type: str = POVEY,
+    use_native: bool = False,
 ) -> Tensor:
     r"""Create a fbank from a raw audio signal. This matches the input/output of Kaldi's
     compute-fbank-feats.
@@ -581,6 +716,9 @@ def fbank(
         vtln_warp (float, optional): Vtln warp factor (only applicable if vtln_map not specified) (Default: ``1.0``)
         window_type (str, optional): Type of window ('hamming'|'hanning'|'povey'|'rectangular'|'blackman')
          (Default: ``'povey'``)
+        use_native (bool, optional): If True, a waveform on CPU which does not require grad is processed by a
+            native kernel, which is faster but matches the default implementation up to float rounding only, not
+            bit for bit. Other waveforms use the default implementation. (Default: ``False``)
 
     Returns:
         Tensor: A fbank identical to what Kaldi would output. The shape is (m, ``num_mel_bins + use_energy``)
@@ -596,51 +734,64 @@ def fbank(
         # signal is too short
         return torch.empty(0, device=device, dtype=dtype)
 
-    # strided_input, size (m, padded_window_size) and signal_log_energy, size (m)
-    strided_input, signal_log_energy = _get_window(
-        waveform,
-        padded_window_size,
-        window_size,
-        window_shift,
-        window_type,
-        blackman_coeff,
-        snip_edges,
-        raw_energy,
-        energy_floor,
-        dither,
-        remove_dc_offset,
-        preemphasis_coefficient,
-    )
-
-    # size (m, padded_window_size // 2 + 1)
-    spectrum = torch.fft.rfft(strided_input).abs()
-    if use_power:
-        spectrum = spectrum.pow(2.0)
-
-    # size (num_mel_bins, padded_window_size // 2)
-    mel_energies, _ = get_mel_banks(
-        num_mel_bins, padded_window_size, sample_frequency, low_freq, high_freq, vtln_low, vtln_high, vtln_warp
-    )
-    mel_energies = mel_energies.to(device=device, dtype=dtype)
-
-    # pad right column with zeros and add dimension, size (num_mel_bins, padded_window_size // 2 + 1)
-    mel_energies = torch.nn.functional.pad(mel_energies, (0, 1), mode="constant", value=0)
-
-    # sum with mel fiterbanks over the power spectrum, size (m, num_mel_bins)
-    mel_energies = torch.mm(spectrum, mel_energies.T)
-    if use_log_fbank:
-        # avoid log of zero (which should be prevented anyway by dithering)
-        mel_energies = torch.max(mel_energies, _get_epsilon(device, dtype)).log()
-
-    # if use_energy then add it as the last column for htk_compat == true else first column
-    if use_energy:
-        signal_log_energy = signal_log_energy.unsqueeze(1)  # size (m, 1)
-        # returns size (m, num_mel_bins + 1)
-        if htk_compat:
-            mel_energies = torch.cat((mel_energies, signal_log_energy), dim=1)
-        else:
-            mel_energies = torch.cat((signal_log_energy, mel_energies), dim=1)
+    if use_native and _IS_TORCHAUDIO_EXT_AVAILABLE and _can_use_native_fbank(waveform):
+        # the constants do not depend on the waveform, so they are computed once for every set of options.
+        window_function, mel_banks = _get_fbank_constants(
+            window_type,
+            window_size,
+            blackman_coeff,
+            num_mel_bins,
+            padded_window_size,
+            sample_frequency,
+            low_freq,
+            high_freq,
+            vtln_low,
+            vtln_high,
+            vtln_warp,
+            dtype,
+        )
+        # size (m, num_mel_bins) and size (m)
+        mel_energies, signal_log_energy = torch.ops.torchaudio.kaldi_fbank(
+            waveform,
+            window_function,
+            mel_banks,
+            window_shift,
+            padded_window_size,
+            snip_edges,
+            dither,
+            remove_dc_offset,
+            preemphasis_coefficient,
+            raw_energy,
+            energy_floor,
+            use_power,
+            use_log_fbank,
+        )
+    else:
+        mel_energies, signal_log_energy = _get_mel_energies(
+            waveform,
+            padded_window_size,
+            window_size,
+            window_shift,
+            window_type,
+            blackman_coeff,
+            snip_edges,
+            raw_energy,
+            energy_floor,
+            dither,
+            remove_dc_offset,
+            preemphasis_coefficient,
+            use_power,
+            num_mel_bins,
+            sample_frequency,
+            low_freq,
+            high_freq,
+            vtln_low,
+            vtln_high,
+            vtln_warp,
+            use_log_fbank,
+        )
 
+    mel_energies = _add_log_energy(mel_energies, signal_log_energy, use_energy, htk_compat)
     mel_energies = _subtract_column_mean(mel_energies, subtract_mean)
     return mel_energies
 
@@ -666,6 +817,46 @@ def _get_lifter_coeffs(num_ceps: int, cepstral_lifter: float) -> Tensor:
     return 1.0 + 0.5 * cepstral_lifter * torch.sin(math.pi * i / cepstral_lifter)
 
 
+def _fbank_to_mfcc(
+    feature: Tensor, num_ceps: int, num_mel_bins: int, cepstral_lifter: float, use_energy: bool, htk_compat: bool
+) -> Tensor:
+    r"""Returns the mfcc of size (m, ``num_ceps``) of the log mel energies of size (m, ``num_mel_bins + use_energy``)"""
+    device, dtype = feature.device, feature.dtype
+
+    if use_energy:
+        # size (m)
+        signal_log_energy = feature[:, num_mel_bins if htk_compat else 0]
+        # offset is 0 if htk_compat==True else 1
+        mel_offset = int(not htk_compat)
+        feature = feature[:, mel_offset : (num_mel_bins + mel_offset)]
+
+    # size (num_mel_bins, num_ceps)
+    dct_matrix = _get_dct_matrix(num_ceps, num_mel_bins).to(dtype=dtype, device=device)
+
+    # size (m, num_ceps)
+    feature = feature.matmul(dct_matrix)
+
+    if cepstral_lifter != 0.0:
+        # size (1, num_ceps)
+        lifter_coeffs = _get_lifter_coeffs(num_ceps, cepstral_lifter).unsqueeze(0)
+        feature *= lifter_coeffs.to(device=device, dtype=dtype)
+
+    # if use_energy then replace the last column for htk_compat == true else first column
+    if use_energy:
+        feature[:, 0] = signal_log_energy
+
+    if htk_compat:
+        energy = feature[:, 0].unsqueeze(1)  # size (m, 1)
+        feature = feature[:, 1:]  # size (m, num_ceps - 1)
+        if not use_energy:
+            # scale on C0 (actually removing a scale we previously added that's
+            # part of one common definition of the cosine transform.)
+            energy *= math.sqrt(2)
+
+        feature = torch.cat((feature, energy), dim=1)
+    return feature
+
+
 def mfcc(
     waveform: Tensor,
     blackman_coeff: float = 0.42,
@@ -693,6 +884,7 @@ def mfcc(
     vtln_low: float = 100.0,
     vtln_warp: float = 1.0,
     window_type: str = POVEY,
+    use_native: bool = False,
 ) -> Tensor:
     r"""Create a mfcc from a raw audio signal. This matches the input/output of Kaldi's
     compute-mfcc-feats.
@@ -736,6 +928,8 @@ def mfcc(
         vtln_warp (float, optional): Vtln warp factor (only applicable if vtln_map not specified) (Default: ``1.0``)
         window_type (str, optional): Type of window ('hamming'|'hanning'|'povey'|'rectangular'|'blackman')
          (Default: ``"povey"``)
+        use_native (bool, optional): If True, the fbank of a waveform on CPU which does not require grad is
+            computed by a native kernel, see :py:func:`fbank`. (Default: ``False``)
 
     Returns:
         Tensor: A mfcc identical to what Kaldi would output. The shape is (m, ``num_ceps``)
@@ -743,8 +937,6 @@ def mfcc(
     """
     assert num_ceps <= num_mel_bins, "num_ceps cannot be larger than num_mel_bins: %d vs %d" % (num_ceps, num_mel_bins)
 
-    device, dtype = waveform.device, waveform.dtype
-
     # The mel_energies should not be squared (use_power=True), not have mean subtracted
     # (subtract_mean=False), and use log (use_log_fbank=True).
     # size (m, num_mel_bins + use_energy)
@@ -775,39 +967,172 @@ def mfcc(
         vtln_low=vtln_low,
         vtln_warp=vtln_warp,
         window_type=window_type,
+        use_native=use_native,
     )
 
-    if use_energy:
-        # size (m)
-        signal_log_energy = feature[:, num_mel_bins if htk_compat else 0]
-        # offset is 0 if htk_compat==True else 1
-        mel_offset = int(not htk_compat)
-        feature = feature[:, mel_offset : (num_mel_bins + mel_offset)]
+    feature = _fbank_to_mfcc(feature, num_ceps, num_mel_bins, cepstral_lifter, use_energy, htk_compat)
+    feature = _subtract_column_mean(feature, subtract_mean)
+    return feature
 
-    # size (num_mel_bins, num_ceps)
-    dct_matrix = _get_dct_matrix(num_ceps, num_mel_bins).to(dtype=dtype, device=device)
 
-    # size (m, num_ceps)
-    feature = feature.matmul(dct_matrix)
+class OnlineFbank:
+    r"""Create fbanks from a raw audio signal given by chunks. The frames are the ones :py:func:`fbank` gives
+    for the whole signal with ``snip_edges=True``: the samples of the frames which are not complete at the end
+    of a chunk are kept until the next chunk, so every frame is computed once, whatever the chunk sizes.
 
-    if cepstral_lifter != 0.0:
-        # size (1, num_ceps)
-        lifter_coeffs = _get_lifter_coeffs(num_ceps, cepstral_lifter).unsqueeze(0)
-        feature *= lifter_coeffs.to(device=device, dtype=dtype)
+    The arguments are the ones of :py:func:`fbank`, without the ones which need the whole signal. Without
+    dither, the frames are identical to the ones of :py:func:`fbank`. The dither noise is drawn for the frames
+    of every chunk, so it differs from the noise of :py:func:`fbank`.
 
-    # if use_energy then replace the last column for htk_compat == true else first column
-    if use_energy:
-        feature[:, 0] = signal_log_energy
+    Args:
+        blackman_coeff (float, optional): Constant coefficient for generalized Blackman window. (Default: ``0.42``)
+        dither (float, optional): Dithering constant (0.0 means no dither). If you turn this off, you should set
+            the energy_floor option, e.g. to 1.0 or 0.1 (Default: ``0.0``)
+        energy_floor (float, optional): Floor on energy (absolute, not relative) in Spectrogram computation.
+            (Default: ``1.0``)
+        frame_length (float, optional): Frame length in milliseconds (Default: ``25.0``)
+        frame_shift (float, optional): Frame shift in milliseconds (Default: ``10.0``)
+        high_freq (float, optional): High cutoff frequency for mel bins (if <= 0, offset from Nyquist)
+         (Default: ``0.0``)
+        htk_compat (bool, optional): If true, put energy last. (Default: ``False``)
+        low_freq (float, optional): Low cutoff frequency for mel bins (Default: ``20.0``)
+        num_mel_bins (int, optional): Number of triangular mel-frequency bins (Default: ``23``)
+        preemphasis_coefficient (float, optional): Coefficient for use in signal preemphasis (Default: ``0.97``)
+        raw_energy (bool, optional): If True, compute energy before preemphasis and windowing (Default: ``True``)
+        remove_dc_offset (bool, optional): Subtract mean from waveform on each frame (Default: ``True``)
+        round_to_power_of_two (bool, optional): If True, round window size to power of two by zero-padding input
+            to FFT. (Default: ``True``)
+        sample_frequency (float, optional): Waveform data sample frequency (Default: ``16000.0``)
+        use_energy (bool, optional): Add an extra dimension with energy to the FBANK output. (Default: ``False``)
+        use_log_fbank (bool, optional):If true, produce log-filterbank, else produce linear. (Default: ``True``)
+        use_power (bool, optional): If true, use power, else use magnitude. (Default: ``True``)
+        vtln_high (float, optional): High inflection point in piecewise linear VTLN warping function (if
+            negative, offset from high-mel-freq (Default: ``-500.0``)
+        vtln_low (float, optional): Low inflection point in piecewise linear VTLN warping function (Default: ``100.0``)
+        vtln_warp (float, optional): Vtln warp factor (only applicable if vtln_map not specified) (Default: ``1.0``)
+        window_type (str, optional): Type of window ('hamming'|'hanning'|'povey'|'rectangular'|'blackman')
+         (Default: ``'povey'``)
+        dtype (torch.dtype, optional): Type of the audio chunks, ``torch.float32`` or ``torch.float64``.
+            (Default: ``torch.float32``)
+
+    Example
+        >>> extractor = OnlineFbank(num_mel_bins=80)
+        >>> for chunk in chunks:  # chunks of size (1, n) of a mono stream
+        ...     features = extractor.accept_waveform(chunk)  # size (m, 80)
+        >>> extractor.reset()  # before the next stream
+    """
 
-    if htk_compat:
-        energy = feature[:, 0].unsqueeze(1)  # size (m, 1)
-        feature = feature[:, 1:]  # size (m, num_ceps - 1)
-        if not use_energy:
-            # scale on C0 (actually removing a scale we previously added that's
-            # part of one common definition of the cosine transform.)
-            energy *= math.sqrt(2)
+    def __init__(
+        self,
+        blackman_coeff: float = 0.42,
+        dither: float = 0.0,
+        energy_floor: float = 1.0,
+        frame_length: float = 25.0,
+        frame_shift: float = 10.0,
+        high_freq: float = 0.0,
+        htk_compat: bool = False,
+        low_freq: float = 20.0,
+        num_mel_bins: int = 23,
+        preemphasis_coefficient: float = 0.97,
+        raw_energy: bool = True,
+        remove_dc_offset: bool = True,
+        round_to_power_of_two: bool = True,
+        sample_frequency: float = 16000.0,
+        use_energy: bool = False,
+        use_log_fbank: bool = True,
+        use_power: bool = True,
+        vtln_high: float = -500.0,
+        vtln_low: float = 100.0,
+        vtln_warp: float = 1.0,
+        window_type: str = POVEY,
+        dtype: torch.dtype = torch.float32,
+    ) -> None:
+        if not _IS_TORCHAUDIO_EXT_AVAILABLE:
+            raise RuntimeError("OnlineFbank requires the torchaudio C++ extension.")
+        window_shift, window_size, padded_window_size = _get_window_properties(
+            sample_frequency, frame_shift, frame_length, round_to_power_of_two, preemphasis_coefficient
+        )
+        window_function, mel_banks = _get_fbank_constants(
+            window_type,
+            window_size,
+            blackman_coeff,
+            num_mel_bins,
+            padded_window_size,
+            sample_frequency,
+            low_freq,
+            high_freq,
+            vtln_low,
+            vtln_high,
+            vtln_warp,
+            dtype,
+        )
+        self.use_energy = use_energy
+        self.htk_compat = htk_compat
+        self._extractor = torch.classes.torchaudio.KaldiOnlineFbank(
+            window_function,
+            mel_banks,
+            window_shift,
+            padded_window_size,
+            dither,
+            remove_dc_offset,
+            preemphasis_coefficient,
+            raw_energy,
+            energy_floor,
+            use_power,
+            use_log_fbank,
+        )
 
-        feature = torch.cat((feature, energy), dim=1)
+    def accept_waveform(self, waveform: Tensor) -> Tensor:
+        r"""Processes the next chunk of the stream.
 
-    feature = _subtract_column_mean(feature, subtract_mean)
-    return feature
+        Args:
+            waveform (Tensor): Chunk of mono audio of size (1, n) or (n), on CPU. It can have any size,
+                including 0.
+
+        Returns:
+            Tensor: The fbank of the frames which end in the chunk, of size (m, ``num_mel_bins + use_energy``).
+        """
+        if waveform.dim() == 2:
+            assert waveform.size(0) == 1, "Only mono audio is supported, got {} channels".format(waveform.size(0))
+            waveform = waveform[0]
+        mel_energies, signal_log_energy = self._extractor.accept_waveform(waveform)
+        return _add_log_energy(mel_energies, signal_log_energy, self.use_energy, self.htk_compat)
+
+    def reset(self) -> None:
+        r"""Drops the samples kept from the previous chunks, to start a new stream."""
+        self._extractor.reset()
+
+
+class OnlineMfcc(OnlineFbank):
+    r"""Create mfccs from a raw audio signal given by chunks, like :py:class:`OnlineFbank` does for
+    :py:func:`mfcc`.
+
+    Args:
+        cepstral_lifter (float, optional): Constant that controls scaling of MFCCs (Default: ``22.0``)
+        num_ceps (int, optional): Number of cepstra in MFCC computation (including C0) (Default: ``13``)
+        **kwargs: The arguments of :py:class:`OnlineFbank`, except ``use_log_fbank`` and ``use_power``.
+    """
+
+    def __init__(self, cepstral_lifter: float = 22.0, num_ceps: int = 13, num_mel_bins: int = 23, **kwargs) -> None:
+        assert num_ceps <= num_mel_bins, "num_ceps cannot be larger than num_mel_bins: %d vs %d" % (
+            num_ceps,
+            num_mel_bins,
+        )
+        super().__init__(num_mel_bins=num_mel_bins, use_log_fbank=True, use_power=True, **kwargs)
+        self.cepstral_lifter = cepstral_lifter
+        self.num_ceps = num_ceps
+        self.num_mel_bins = num_mel_bins
+
+    def accept_waveform(self, waveform: Tensor) -> Tensor:
+        r"""Processes the next chunk of the stream.
+
+        Args:
+            waveform (Tensor): Chunk of mono audio of size (1, n) or (n), on CPU.
+
+        Returns:
+            Tensor: The mfcc of the frames which end in the chunk, of size (m, ``num_ceps``).
+        """
+        feature = super().accept_waveform(waveform)
+        return _fbank_to_mfcc(
+            feature, self.num_ceps, self.num_mel_bins, self.cepstral_lifter, self.use_energy, self.htk_compat
+        )
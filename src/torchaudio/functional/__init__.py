@@ -1,6 +1,12 @@
 from torchaudio._internal.module_utils import dropping_support
 
-from ._alignment import forced_align as _forced_align, merge_tokens, TokenSpan
+from ._alignment import (
+    forced_align as _forced_align,
+    forced_align_windowed,
+    merge_tokens,
+    TokenSpan,
+)
+from ._rir import histogram_to_rir
 from .filtering import (
     allpass_biquad,
     band_biquad,
@@ -58,7 +64,12 @@ from .functional import (
     preemphasis,
     psd,
     resample,
+    rnnt_best_path,
     rnnt_loss,
+    rnnt_loss_fused_joiner,
+    rnnt_loss_packed,
+    rnnt_loss_pruned,
+    rnnt_loss_simple,
     rtf_evd,
     rtf_power,
     sliding_window_cmn,
@@ -100,6 +111,7 @@ __all__ = [
     "filtfilt",
     "flanger",
     "forced_align",
+    "forced_align_windowed",
     "merge_tokens",
     "TokenSpan",
     "gain",
@@ -116,6 +128,11 @@ __all__ = [
     "edit_distance",
     "pitch_shift",
     "rnnt_loss",
+    "rnnt_loss_simple",
+    "rnnt_loss_pruned",
+    "rnnt_loss_fused_joiner",
+    "rnnt_loss_packed",
+    "rnnt_best_path",
     "psd",
     "mvdr_weights_souden",
     "mvdr_weights_rtf",
@@ -129,4 +146,5 @@ __all__ = [
     "preemphasis",
     "deemphasis",
     "frechet_distance",
+    "histogram_to_rir",
 ]
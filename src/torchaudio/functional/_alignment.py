@@ -1,9 +1,11 @@
+import math
 from dataclasses import dataclass
 from typing import List, Optional, Tuple
 
 import torch
 from torch import Tensor
-from torchaudio._extension import fail_if_no_align
+from torchaudio._extension import _IS_ALIGN_AVAILABLE, fail_if_no_align
+from torchaudio._internal.module_utils import dropping_support
 
 __all__ = []
 
@@ -37,8 +39,10 @@ def forced_align(
     Returns:
         Tuple(Tensor, Tensor):
             Tensor: Label for each time step in the alignment path computed using forced alignment.
+            Time steps past the input length are filled with ``blank``.
 
             Tensor: Log probability scores of the labels for each time step.
+            Time steps past the input length have a score of 0.
 
     Note:
         The sequence length of `log_probs` must satisfy:
@@ -51,7 +55,12 @@ def forced_align(
         For example, in str `"aabbc"`, the number of repeats are `2`.
 
     Note:
-        The current version only supports ``batch_size==1``.
+        On CPU, the utterances of a batch are aligned in parallel, and their lengths may differ.
+        Targets past ``target_lengths`` are ignored, but must not be ``blank``.
+        On CUDA, only ``batch_size==1`` is supported.
+        On CPU, utterances whose back-pointer table (`T` times `2L + 1` bytes) would exceed 1 GiB
+        are aligned in :math:`O(\sqrt{T} \cdot L)` memory, at about twice the compute,
+        by recomputing the trellis between checkpoints while backtracking.
     """
     if blank in targets:
         raise ValueError(f"targets Tensor shouldn't contain blank index. Found {targets}.")
@@ -70,7 +79,72 @@ def forced_align(
     assert target_lengths is not None
 
     paths, scores = torch.ops.torchaudio.forced_align(log_probs, targets, input_lengths, target_lengths, blank)
-    return paths, scores[:, torch.arange(scores.shape[1]), paths[0]]
+    return paths, scores
+
+
+@fail_if_no_align
+def _forced_align_windowed(
+    log_probs: Tensor,
+    targets: Tensor,
+    blank: int = 0,
+    window_size: int = 3000,
+    overlap: int = 300,
+    anchor_threshold: float = 0.9,
+    anchor_length: int = 3,
+) -> Tuple[Tensor, Tensor, Tensor]:
+    r"""Align a long CTC label sequence to an emission, by windows aligned in parallel.
+
+    .. devices:: CPU
+
+    .. properties:: TorchScript
+
+    The emission is split into windows of ``window_size`` frames. Around each window boundary,
+    within ``overlap`` frames, an anchor is searched: ``anchor_length`` consecutive greedy emissions,
+    each with a probability of at least ``anchor_threshold``, that match a unique span of the targets
+    near its expected position. The segments between anchors are aligned independently, in parallel,
+    and their paths are stitched at the anchors.
+
+    Boundaries where no anchor is found are dropped, and the windows on each side are aligned together.
+    The result is the same as :py:func:`forced_align` when the anchors are on the best path.
+
+    Args:
+        log_probs (Tensor): log probability of CTC emission output.
+            Tensor of shape `(1, T, C)`. where `T` is the input length,
+            `C` is the number of characters in alphabet including blank.
+        targets (Tensor): Target sequence. Tensor of shape `(1, L)`,
+            where `L` is the target length.
+        blank (int, optional): The index of blank symbol in CTC emission. (Default: 0)
+        window_size (int, optional): The number of frames of the windows. (Default: 3000)
+        overlap (int, optional): The number of frames, on each side of a window boundary,
+            searched for its anchor. (Default: 300)
+        anchor_threshold (float, optional): The minimum probability of the emissions of an anchor.
+            (Default: 0.9)
+        anchor_length (int, optional): The number of tokens of an anchor. (Default: 3)
+
+    Returns:
+        Tuple(Tensor, Tensor, Tensor):
+            Tensor: Label for each time step in the alignment path. Shape: `(1, T)`.
+
+            Tensor: Log probability scores of the labels for each time step. Shape: `(1, T)`.
+
+            Tensor: Indices of the windows that could not be stitched to the previous window,
+            and were aligned together with it. Shape: `(num_failed, )`.
+    """
+    if blank in targets:
+        raise ValueError(f"targets Tensor shouldn't contain blank index. Found {targets}.")
+    if targets.numel() > 0 and torch.max(targets) >= log_probs.shape[-1]:
+        raise ValueError("targets values must be less than the CTC dimension")
+    if anchor_threshold <= 0.0 or anchor_threshold > 1.0:
+        raise ValueError(f"anchor_threshold must be within (0, 1]. Found {anchor_threshold}.")
+
+    return torch.ops.torchaudio.forced_align_windowed(
+        log_probs, targets, blank, window_size, overlap, math.log(anchor_threshold), anchor_length
+    )
+
+
+# Expose both deprecated wrapper as well as original because torchscript breaks on
+# wrapped functions.
+forced_align_windowed = dropping_support(_forced_align_windowed)
 
 
 @dataclass
@@ -102,10 +176,14 @@ def merge_tokens(tokens: Tensor, scores: Tensor, blank: int = 0) -> List[TokenSp
         scores (Tensor): Alignment scores (unbatched) returned from :py:func:`forced_align`.
             Shape: `(time, )`. When computing the token-size score, the given score is averaged
             across the corresponding time span.
+        blank (int, optional): The index of blank symbol. (Default: 0)
 
     Returns:
         list of TokenSpan
 
+    Note:
+        On CPU, the spans are computed natively in a single pass over the alignment.
+
     Example:
         >>> aligned_tokens, scores = forced_align(emission, targets, input_lengths, target_lengths)
         >>> token_spans = merge_tokens(aligned_tokens[0], scores[0])
@@ -115,6 +193,15 @@ def merge_tokens(tokens: Tensor, scores: Tensor, blank: int = 0) -> List[TokenSp
     if len(tokens) != len(scores):
         raise ValueError("`tokens` and `scores` must be the same length.")
 
+    if _IS_ALIGN_AVAILABLE and tokens.device.type == "cpu" and scores.device.type == "cpu":
+        span_tokens, starts, ends, span_scores = torch.ops.torchaudio.merge_tokens(tokens, scores, blank)
+        return [
+            TokenSpan(token=token, start=start, end=end, score=score)
+            for token, start, end, score in zip(
+                span_tokens.tolist(), starts.tolist(), ends.tolist(), span_scores.tolist()
+            )
+        ]
+
     diff = torch.diff(
         tokens, prepend=torch.tensor([-1], device=tokens.device), append=torch.tensor([-1], device=tokens.device)
     )
@@ -0,0 +1,60 @@
+from typing import Optional
+
+import torch
+from torch import Tensor
+from torchaudio._extension import fail_if_no_rir
+from torchaudio._internal.module_utils import dropping_support
+
+__all__ = []
+
+
+@fail_if_no_rir
+def _histogram_to_rir(
+    histograms: Tensor,
+    sample_rate: float,
+    volume: float,
+    hist_bin_size: float = 0.004,
+    sound_speed: float = 343.0,
+    center_frequency: Optional[Tensor] = None,
+    n_fft: int = 512,
+    seed: int = 0,
+) -> Tensor:
+    r"""Synthesize room impulse responses from the energy histograms of ray tracing.
+
+    .. devices:: CPU
+
+    .. note::
+
+       This function is a prototype, its interface may change.
+
+    For each microphone, a random Dirac sequence is drawn with the density of reflections of the room, weighted
+    per octave band so that the energy of each histogram bin is preserved, then band-pass filtered and summed
+    over the bands.
+
+    Args:
+        histograms (Tensor): Energy histograms. Tensor of shape `(num_mics, num_bands, num_bins)`,
+            with non-negative values.
+        sample_rate (float): Sample rate of the room impulse responses.
+        volume (float): Volume of the room.
+        hist_bin_size (float, optional): Width of a histogram bin in seconds. (Default: ``0.004``)
+        sound_speed (float, optional): Speed of sound. (Default: ``343.0``)
+        center_frequency (Tensor or None, optional): Center frequencies of the octave bands, of shape
+            `(num_bands,)`. If ``None``, the bands are centered on ``125 * 2 ** i``. (Default: ``None``)
+        n_fft (int, optional): Number of FFT points of the band-pass filters. (Default: ``512``)
+        seed (int, optional): Seed of the Dirac sequences. Microphone `m` uses ``seed + m``, so the result
+            does not depend on the number of threads. (Default: ``0``)
+
+    Returns:
+        Tensor: Room impulse responses of shape `(num_mics, num_bins * floor(hist_bin_size * sample_rate))`.
+    """
+    if histograms.ndim != 3:
+        raise ValueError(f"histograms must be a 3D Tensor. Found: {histograms.shape}")
+    if center_frequency is None:
+        center_frequency = 125.0 * 2.0 ** torch.arange(histograms.size(1), dtype=histograms.dtype)
+    filters = torch.ops.torchaudio._make_rir_filter(center_frequency.to(histograms.dtype), sample_rate, n_fft)
+    return torch.ops.torchaudio._histogram_to_rir(
+        histograms, filters, volume, sample_rate, hist_bin_size, sound_speed, seed
+    )
+
+
+histogram_to_rir = dropping_support(_histogram_to_rir)
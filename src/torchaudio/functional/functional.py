@@ -1767,18 +1767,92 @@ def _fix_waveform_shape(
 
 class RnntLoss(torch.autograd.Function):
     @staticmethod
-    def forward(ctx, *args):
-        output, saved = torch.ops.torchaudio.rnnt_loss_forward(*args)
+    def forward(
+        ctx,
+        logits,
+        targets,
+        logit_lengths,
+        target_lengths,
+        blank,
+        clamp,
+        fused_log_softmax,
+        num_threads,
+    ):
+        ctx.deferred = logits.device.type == "cpu"
+        if ctx.deferred:
+            # gradients are only computed if backward is called.
+            costs, denominators, alphas, betas = torch.ops.torchaudio.rnnt_loss_deferred(
+                logits, targets, logit_lengths, target_lengths, blank, fused_log_softmax, num_threads
+            )
+            ctx.save_for_backward(logits, targets, logit_lengths, target_lengths, denominators, alphas, betas)
+            ctx.blank = blank
+            ctx.clamp = clamp
+            ctx.fused_log_softmax = fused_log_softmax
+            ctx.num_threads = num_threads
+            return costs
+
+        output, saved = torch.ops.torchaudio.rnnt_loss_forward(
+            logits,
+            targets,
+            logit_lengths,
+            target_lengths,
+            blank,
+            clamp,
+            fused_log_softmax,
+            num_threads,
+        )
         ctx.save_for_backward(saved)
         return output
 
     @staticmethod
     def backward(ctx, dy):
+        if ctx.deferred:
+            result = torch.ops.torchaudio.rnnt_loss_deferred_backward(
+                dy, *ctx.saved_tensors, ctx.blank, ctx.clamp, ctx.fused_log_softmax, ctx.num_threads
+            )
+            return (result, None, None, None, None, None, None, None)
+
         grad = ctx.saved_tensors[0]
         grad_out = dy.view((-1, 1, 1, 1))
         result = grad * grad_out;
         return (result, None, None, None, None, None, None, None)
 
+
+class RnntLossReuseLogits(torch.autograd.Function):
+    @staticmethod
+    def forward(
+        ctx,
+        logits,
+        targets,
+        logit_lengths,
+        target_lengths,
+        blank,
+        clamp,
+        fused_log_softmax,
+        num_threads,
+    ):
+        output, _ = torch.ops.torchaudio.rnnt_loss_reuse_logits(
+            logits,
+            targets,
+            logit_lengths,
+            target_lengths,
+            blank,
+            clamp,
+            fused_log_softmax,
+            num_threads,
+        )
+        # the gradients overwrote the logits, so backward of the nodes that saved the logits fails.
+        ctx.mark_dirty(logits)
+        ctx.save_for_backward(logits)
+        return output, logits
+
+    @staticmethod
+    def backward(ctx, dy, _):
+        grad = ctx.saved_tensors[0]
+        result = grad * dy.view((-1, 1, 1, 1))
+        return (result, None, None, None, None, None, None, None)
+
+
 def _rnnt_loss(
     logits: Tensor,
     targets: Tensor,
@@ -1788,6 +1862,8 @@ def _rnnt_loss(
     clamp: float = -1,
     reduction: str = "mean",
     fused_log_softmax: bool = True,
+    num_threads: int = 0,
+    reuse_logits_for_grads: bool = False,
 ):
     """Compute the RNN Transducer loss from *Sequence Transduction with Recurrent Neural Networks*
     :cite:`graves2012sequence`.
@@ -1811,6 +1887,24 @@ def _rnnt_loss(
         reduction (string, optional): Specifies the reduction to apply to the output:
             ``"none"`` | ``"mean"`` | ``"sum"``. (Default: ``"mean"``)
         fused_log_softmax (bool): set to False if calling log_softmax outside of loss (Default: ``True``)
+        num_threads (int, optional): The maximum number of threads used to compute the loss on CPU.
+            ``0`` uses all the intra-op threads (see :py:func:`torch.set_num_threads`).
+            Ignored on CUDA. (Default: ``0``)
+        reuse_logits_for_grads (bool, optional): If ``True``, the gradients are written into the storage of
+            ``logits`` instead of a new tensor, which halves the peak memory of the loss. The values of ``logits``
+            are overwritten, so it must not be used afterwards, nor saved by other nodes of the autograd graph
+            (such as the output of :py:func:`torch.nn.functional.log_softmax`); in that case, the backward pass
+            raises an error. ``logits`` must not be a leaf tensor that requires grad. ``logits`` is left unchanged
+            when no gradient is computed, i.e. if it does not require grad or grad mode is disabled.
+            (Default: ``False``)
+
+    Note:
+        On CPU, the intermediate buffers of the loss are cached between calls, keyed on the batch size and
+        the maximum lengths rounded up to coarse buckets. Call ``torch.ops.torchaudio.rnnt_release_workspaces()``
+        to free the cached buffers that are not in use. At most 1 GiB of unused buffers is kept, the least recently
+        used ones are freed beyond it; ``torch.ops.torchaudio.rnnt_set_workspace_cache_limit(max_bytes)`` changes
+        the limit.
+
     Returns:
         Tensor: Loss with the reduction option applied. If ``reduction`` is  ``"none"``, then size `(batch)`,
         otherwise scalar.
@@ -1821,24 +1915,452 @@ def _rnnt_loss(
     if blank < 0:  # reinterpret blank index if blank < 0.
         blank = logits.shape[-1] + blank
 
-    costs = RnntLoss.apply(
-        logits,
+    if reuse_logits_for_grads and logits.is_leaf and logits.requires_grad:
+        raise ValueError("reuse_logits_for_grads cannot overwrite a leaf tensor that requires grad.")
+
+    # the logits are only overwritten if autograd calls the backward, since it is the one reading the gradients.
+    if reuse_logits_for_grads and torch.is_grad_enabled() and logits.requires_grad:
+        costs, _ = RnntLossReuseLogits.apply(
+            logits,
+            targets,
+            logit_lengths,
+            target_lengths,
+            blank,
+            clamp,
+            fused_log_softmax,
+            num_threads,
+        )
+    else:
+        costs = RnntLoss.apply(
+            logits,
+            targets,
+            logit_lengths,
+            target_lengths,
+            blank,
+            clamp,
+            fused_log_softmax,
+            num_threads,
+        )
+
+    if reduction == "mean":
+        return costs.mean()
+    elif reduction == "sum":
+        return costs.sum()
+
+    return costs
+
+
+class RnntLossSimple(torch.autograd.Function):
+    @staticmethod
+    def forward(ctx, *args):
+        costs, am_grad, lm_grad, ranges = torch.ops.torchaudio.rnnt_loss_simple(*args)
+        ctx.save_for_backward(am_grad, lm_grad)
+        ctx.mark_non_differentiable(ranges)
+        return costs, ranges
+
+    @staticmethod
+    def backward(ctx, dy, _):
+        am_grad, lm_grad = ctx.saved_tensors
+        grad_out = dy.view((-1, 1, 1))
+        return (am_grad * grad_out, lm_grad * grad_out, None, None, None, None, None, None)
+
+
+class RnntLossPruned(torch.autograd.Function):
+    @staticmethod
+    def forward(ctx, *args):
+        output, saved = torch.ops.torchaudio.rnnt_loss_pruned(*args)
+        ctx.save_for_backward(saved)
+        return output
+
+    @staticmethod
+    def backward(ctx, dy):
+        grad = ctx.saved_tensors[0]
+        grad_out = dy.view((-1, 1, 1, 1))
+        result = grad * grad_out
+        return (result, None, None, None, None, None, None, None, None)
+
+
+class RnntLossFusedJoiner(torch.autograd.Function):
+    @staticmethod
+    def forward(
+        ctx,
+        source_encodings,
+        target_encodings,
+        weight,
+        bias,
         targets,
         logit_lengths,
         target_lengths,
         blank,
+        activation,
         clamp,
-        fused_log_softmax
-    )
+        num_threads,
+    ):
+        costs, alphas, betas = torch.ops.torchaudio.rnnt_loss_fused_joiner(
+            source_encodings,
+            target_encodings,
+            weight,
+            bias,
+            targets,
+            logit_lengths,
+            target_lengths,
+            blank,
+            activation,
+            num_threads,
+        )
+        ctx.save_for_backward(
+            source_encodings, target_encodings, weight, bias, targets, logit_lengths, target_lengths, alphas, betas
+        )
+        ctx.blank = blank
+        ctx.activation = activation
+        ctx.clamp = clamp
+        ctx.num_threads = num_threads
+        return costs
 
+    @staticmethod
+    def backward(ctx, dy):
+        grads = torch.ops.torchaudio.rnnt_loss_fused_joiner_backward(
+            dy, *ctx.saved_tensors, ctx.blank, ctx.activation, ctx.clamp, ctx.num_threads
+        )
+        return grads + (None, None, None, None, None, None, None)
+
+
+class RnntLossPacked(torch.autograd.Function):
+    @staticmethod
+    def forward(ctx, logits, targets, logit_lengths, target_lengths, *args):
+        output, saved = torch.ops.torchaudio.rnnt_loss_packed(logits, targets, logit_lengths, target_lengths, *args)
+        ctx.save_for_backward(saved, logit_lengths * (target_lengths + 1))
+        return output
+
+    @staticmethod
+    def backward(ctx, dy):
+        grad, num_cells = ctx.saved_tensors
+        grad_out = dy.repeat_interleave(num_cells, output_size=grad.size(0)).view((-1, 1))
+        result = grad * grad_out
+        return (result, None, None, None, None, None, None, None)
+
+
+def _reduce_rnnt_costs(costs: Tensor, reduction: str) -> Tensor:
     if reduction == "mean":
         return costs.mean()
     elif reduction == "sum":
         return costs.sum()
-
     return costs
 
 
+def _rnnt_loss_simple(
+    am: Tensor,
+    lm: Tensor,
+    targets: Tensor,
+    logit_lengths: Tensor,
+    target_lengths: Tensor,
+    s_range: int,
+    blank: int = -1,
+    reduction: str = "mean",
+    num_threads: int = 0,
+) -> Tuple[Tensor, Tensor]:
+    """Compute the RNN Transducer loss with a trivial joiner, and the pruning ranges used by
+    :py:func:`rnnt_loss_pruned` :cite:`kuang2022pruned`.
+
+    .. devices:: CPU
+
+    .. properties:: Autograd
+
+    The joiner output is approximated by ``am[:, :, None, :] + lm[:, None, :, :]``, so the loss only needs
+    `(batch, max seq length, max target length + 1)` intermediate buffers. For every frame, the window of
+    ``s_range`` symbols holding most of the alignment probability mass is then selected, and the windows
+    are adjusted so that they are non-decreasing and consecutive windows overlap.
+
+    Args:
+        am (Tensor): Tensor of dimension `(batch, max seq length, class)` containing the encoder output
+            projected to the vocabulary.
+        lm (Tensor): Tensor of dimension `(batch, max target length + 1, class)` containing the predictor
+            output projected to the vocabulary.
+        targets (Tensor): Tensor of dimension `(batch, max target length)` containing targets with zero padded
+        logit_lengths (Tensor): Tensor of dimension `(batch)` containing lengths of each sequence from encoder
+        target_lengths (Tensor): Tensor of dimension `(batch)` containing lengths of targets for each sequence
+        s_range (int): Number of symbols kept for each frame.
+        blank (int, optional): blank label (Default: ``-1``)
+        reduction (string, optional): Specifies the reduction to apply to the output:
+            ``"none"`` | ``"mean"`` | ``"sum"``. (Default: ``"mean"``)
+        num_threads (int, optional): The maximum number of threads used to compute the loss.
+            ``0`` uses all the intra-op threads. (Default: ``0``)
+
+    Returns:
+        (Tensor, Tensor):
+        Tensor
+            Loss with the reduction option applied. If ``reduction`` is  ``"none"``, then size `(batch)`,
+            otherwise scalar.
+        Tensor
+            Int32 tensor of dimension `(batch, max seq length)`. Frame ``t`` of sequence ``b`` keeps the
+            symbols ``ranges[b, t] + s`` for ``s`` in ``[0, s_range)``, which can be gathered from the
+            predictor output with ``(ranges[..., None] + torch.arange(s_range)).clamp(max=lm.size(1) - 1)``.
+    """
+    if reduction not in ["none", "mean", "sum"]:
+        raise ValueError('reduction should be one of "none", "mean", or "sum"')
+
+    if blank < 0:  # reinterpret blank index if blank < 0.
+        blank = am.shape[-1] + blank
+
+    costs, ranges = RnntLossSimple.apply(
+        am,
+        lm,
+        targets,
+        logit_lengths,
+        target_lengths,
+        blank,
+        s_range,
+        num_threads,
+    )
+    return _reduce_rnnt_costs(costs, reduction), ranges
+
+
+def _rnnt_loss_pruned(
+    logits: Tensor,
+    targets: Tensor,
+    ranges: Tensor,
+    logit_lengths: Tensor,
+    target_lengths: Tensor,
+    blank: int = -1,
+    clamp: float = -1,
+    reduction: str = "mean",
+    fused_log_softmax: bool = True,
+    num_threads: int = 0,
+) -> Tensor:
+    """Compute the RNN Transducer loss on a band of the alignment lattice :cite:`kuang2022pruned`.
+
+    .. devices:: CPU
+
+    .. properties:: Autograd
+
+    Only the paths that stay within the symbols ``ranges[b, t] + s``, ``s`` in ``[0, s_range)``, of every
+    frame contribute to the loss, so the joiner only needs to be evaluated on
+    `(batch, max seq length, s_range, class)` inputs instead of the full
+    `(batch, max seq length, max target length + 1, class)` lattice. When the band covers the whole
+    lattice, the loss and gradients are the same as :py:func:`rnnt_loss`.
+
+    Args:
+        logits (Tensor): Tensor of dimension `(batch, max seq length, s_range, class)` containing output
+            from joiner on the band.
+        targets (Tensor): Tensor of dimension `(batch, max target length)` containing targets with zero padded
+        ranges (Tensor): Int32 tensor of dimension `(batch, max seq length)` containing the first symbol of
+            the band of each frame, such as the one returned by :py:func:`rnnt_loss_simple`.
+            It must start at ``0``, be non-decreasing with steps smaller than ``s_range``, and cover the
+            last target on the last frame.
+        logit_lengths (Tensor): Tensor of dimension `(batch)` containing lengths of each sequence from encoder
+        target_lengths (Tensor): Tensor of dimension `(batch)` containing lengths of targets for each sequence
+        blank (int, optional): blank label (Default: ``-1``)
+        clamp (float, optional): clamp for gradients (Default: ``-1``)
+        reduction (string, optional): Specifies the reduction to apply to the output:
+            ``"none"`` | ``"mean"`` | ``"sum"``. (Default: ``"mean"``)
+        fused_log_softmax (bool): set to False if calling log_softmax outside of loss (Default: ``True``)
+        num_threads (int, optional): The maximum number of threads used to compute the loss.
+            ``0`` uses all the intra-op threads. (Default: ``0``)
+    Returns:
+        Tensor: Loss with the reduction option applied. If ``reduction`` is  ``"none"``, then size `(batch)`,
+        otherwise scalar.
+    """
+    if reduction not in ["none", "mean", "sum"]:
+        raise ValueError('reduction should be one of "none", "mean", or "sum"')
+
+    if blank < 0:  # reinterpret blank index if blank < 0.
+        blank = logits.shape[-1] + blank
+
+    costs = RnntLossPruned.apply(
+        logits,
+        targets,
+        ranges,
+        logit_lengths,
+        target_lengths,
+        blank,
+        clamp,
+        fused_log_softmax,
+        num_threads,
+    )
+    return _reduce_rnnt_costs(costs, reduction)
+
+
+def _rnnt_loss_fused_joiner(
+    source_encodings: Tensor,
+    target_encodings: Tensor,
+    weight: Tensor,
+    bias: Tensor,
+    targets: Tensor,
+    logit_lengths: Tensor,
+    target_lengths: Tensor,
+    blank: int = -1,
+    clamp: float = -1,
+    activation: str = "relu",
+    reduction: str = "mean",
+    num_threads: int = 0,
+) -> Tensor:
+    """Compute the RNN Transducer loss of a joint network without materializing its output.
+
+    .. devices:: CPU
+
+    .. properties:: Autograd
+
+    The joiner output ``activation(source_encodings[:, :, None] + target_encodings[:, None]) @ weight.T + bias``,
+    as computed by :py:class:`~torchaudio.models.RNNT`'s joiner, is evaluated tile by tile during the forward pass,
+    and recomputed during the backward pass to produce the gradients of the encodings and of the joiner parameters.
+    Only `(batch, max seq length, max target length + 1)` intermediate buffers are kept, instead of the
+    `(batch, max seq length, max target length + 1, class)` logits and gradients of :py:func:`rnnt_loss`.
+
+    Args:
+        source_encodings (Tensor): Tensor of dimension `(batch, max seq length, hidden)` containing output from
+            encoder
+        target_encodings (Tensor): Tensor of dimension `(batch, max target length + 1, hidden)` containing output
+            from predictor
+        weight (Tensor): Tensor of dimension `(class, hidden)` containing the joiner linear weight
+        bias (Tensor): Tensor of dimension `(class)` containing the joiner linear bias
+        targets (Tensor): Tensor of dimension `(batch, max target length)` containing targets with zero padded
+        logit_lengths (Tensor): Tensor of dimension `(batch)` containing lengths of each sequence from encoder
+        target_lengths (Tensor): Tensor of dimension `(batch)` containing lengths of targets for each sequence
+        blank (int, optional): blank label (Default: ``-1``)
+        clamp (float, optional): clamp for the gradients of the joiner output (Default: ``-1``)
+        activation (str, optional): activation function of the joiner. Must be one of (``"relu"``, ``"tanh"``).
+            (Default: ``"relu"``)
+        reduction (string, optional): Specifies the reduction to apply to the output:
+            ``"none"`` | ``"mean"`` | ``"sum"``. (Default: ``"mean"``)
+        num_threads (int, optional): The maximum number of threads used to compute the loss.
+            ``0`` uses all the intra-op threads. (Default: ``0``)
+    Returns:
+        Tensor: Loss with the reduction option applied. If ``reduction`` is  ``"none"``, then size `(batch)`,
+        otherwise scalar.
+    """
+    if reduction not in ["none", "mean", "sum"]:
+        raise ValueError('reduction should be one of "none", "mean", or "sum"')
+
+    if blank < 0:  # reinterpret blank index if blank < 0.
+        blank = weight.shape[0] + blank
+
+    costs = RnntLossFusedJoiner.apply(
+        source_encodings,
+        target_encodings,
+        weight,
+        bias,
+        targets,
+        logit_lengths,
+        target_lengths,
+        blank,
+        activation,
+        clamp,
+        num_threads,
+    )
+    return _reduce_rnnt_costs(costs, reduction)
+
+
+def _rnnt_loss_packed(
+    logits: Tensor,
+    targets: Tensor,
+    logit_lengths: Tensor,
+    target_lengths: Tensor,
+    blank: int = -1,
+    clamp: float = -1,
+    reduction: str = "mean",
+    fused_log_softmax: bool = True,
+    num_threads: int = 0,
+) -> Tensor:
+    """Compute the RNN Transducer loss on logits of sequences packed without padding.
+
+    .. devices:: CPU
+
+    .. properties:: Autograd
+
+    The joiner output of sequence ``b`` is a `(logit_lengths[b], target_lengths[b] + 1, class)` block, flattened
+    to `(logit_lengths[b] * (target_lengths[b] + 1), class)` rows, and the blocks of the batch are concatenated
+    in order. Denominators, alphas, betas and gradients are only computed and stored for these rows, instead of
+    the whole `(batch, max seq length, max target length + 1, class)` lattice of :py:func:`rnnt_loss`, which
+    saves the padding of batches with mixed lengths. The loss and gradients are otherwise the same.
+
+    Args:
+        logits (Tensor): Tensor of dimension `(sum(logit_lengths * (target_lengths + 1)), class)` containing the
+            packed output from joiner
+        targets (Tensor): Tensor of dimension `(batch, max target length)` containing targets with zero padded
+        logit_lengths (Tensor): Tensor of dimension `(batch)` containing lengths of each sequence from encoder
+        target_lengths (Tensor): Tensor of dimension `(batch)` containing lengths of targets for each sequence
+        blank (int, optional): blank label (Default: ``-1``)
+        clamp (float, optional): clamp for gradients (Default: ``-1``)
+        reduction (string, optional): Specifies the reduction to apply to the output:
+            ``"none"`` | ``"mean"`` | ``"sum"``. (Default: ``"mean"``)
+        fused_log_softmax (bool): set to False if calling log_softmax outside of loss (Default: ``True``)
+        num_threads (int, optional): The maximum number of threads used to compute the loss.
+            ``0`` uses all the intra-op threads. (Default: ``0``)
+    Returns:
+        Tensor: Loss with the reduction option applied. If ``reduction`` is  ``"none"``, then size `(batch)`,
+        otherwise scalar.
+    """
+    if reduction not in ["none", "mean", "sum"]:
+        raise ValueError('reduction should be one of "none", "mean", or "sum"')
+
+    if blank < 0:  # reinterpret blank index if blank < 0.
+        blank = logits.shape[-1] + blank
+
+    costs = RnntLossPacked.apply(
+        logits,
+        targets,
+        logit_lengths,
+        target_lengths,
+        blank,
+        clamp,
+        fused_log_softmax,
+        num_threads,
+    )
+    return _reduce_rnnt_costs(costs, reduction)
+
+
+def _rnnt_best_path(
+    logits: Tensor,
+    targets: Tensor,
+    logit_lengths: Tensor,
+    target_lengths: Tensor,
+    blank: int = -1,
+    fused_log_softmax: bool = True,
+    num_threads: int = 0,
+) -> Tuple[Tensor, Tensor, Tensor]:
+    """Compute the most likely (Viterbi) alignment of targets in the RNN Transducer lattice.
+
+    .. devices:: CPU
+
+    .. properties:: TorchScript
+
+    The recursion is the forward recursion of :py:func:`rnnt_loss`, with the log-sum-exp replaced by a maximum.
+    The best path of sequence ``b`` has ``logit_lengths[b] + target_lengths[b]`` steps: one blank per frame,
+    and one step per target. Each step either emits a blank and moves from node ``(t, u)`` to ``(t + 1, u)``,
+    or emits ``targets[b, u]`` and moves from ``(t, u)`` to ``(t, u + 1)``.
+
+    Args:
+        logits (Tensor): Tensor of dimension `(batch, max seq length, max target length + 1, class)`
+            containing output from joiner
+        targets (Tensor): Tensor of dimension `(batch, max target length)` containing targets with zero padded
+        logit_lengths (Tensor): Tensor of dimension `(batch)` containing lengths of each sequence from encoder
+        target_lengths (Tensor): Tensor of dimension `(batch)` containing lengths of targets for each sequence
+        blank (int, optional): blank label (Default: ``-1``)
+        fused_log_softmax (bool): set to False if calling log_softmax outside of the function (Default: ``True``)
+        num_threads (int, optional): The maximum number of threads used to compute the alignments.
+            ``0`` uses all the intra-op threads. (Default: ``0``)
+
+    Returns:
+        (Tensor, Tensor, Tensor):
+        Tensor
+            Int32 tensor of dimension `(batch, max seq length + max target length, 2)` containing the
+            ``(t, u)`` node of each step, padded with ``-1``.
+        Tensor
+            Int32 tensor of dimension `(batch, max seq length + max target length)` containing the label
+            emitted at each step, padded with ``-1``.
+        Tensor
+            Tensor of dimension `(batch, max seq length + max target length)` containing the log probability
+            of each step, padded with ``0``. Its sum is the log probability of the best path.
+    """
+    if blank < 0:  # reinterpret blank index if blank < 0.
+        blank = logits.shape[-1] + blank
+
+    paths, labels, scores = torch.ops.torchaudio.rnnt_best_path(
+        logits, targets, logit_lengths, target_lengths, blank, fused_log_softmax, num_threads
+    )
+    return paths, labels, scores
+
+
 def psd(
     specgram: Tensor,
     mask: Optional[Tensor] = None,
@@ -1886,6 +2408,11 @@ def psd(
 # Expose both deprecated wrapper as well as original because torchscript breaks on
 # wrapped functions.
 rnnt_loss = dropping_support(_rnnt_loss)
+rnnt_loss_simple = dropping_support(_rnnt_loss_simple)
+rnnt_loss_pruned = dropping_support(_rnnt_loss_pruned)
+rnnt_loss_fused_joiner = dropping_support(_rnnt_loss_fused_joiner)
+rnnt_loss_packed = dropping_support(_rnnt_loss_packed)
+rnnt_best_path = dropping_support(_rnnt_best_path)
 
 def _compute_mat_trace(input: torch.Tensor, dim1: int = -1, dim2: int = -2) -> torch.Tensor:
     r"""Compute the trace of a Tensor along ``dim1`` and ``dim2`` dimensions.
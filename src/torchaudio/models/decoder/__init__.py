@@ -32,7 +32,8 @@ def __getattr__(name: str):
             from . import _cuda_ctc_decoder
         except AttributeError as err:
             raise RuntimeError(
-                "To use CUCTC decoder, please set BUILD_CUDA_CTC_DECODER=1 when building from source."
+                "To use CUCTC decoder, please set BUILD_CUDA_CTC_DECODER=1 or BUILD_CPU_CTC_DECODER=1 "
+                "when building from source."
             ) from err
 
         orig_item = getattr(_cuda_ctc_decoder, name)
@@ -2,7 +2,7 @@ from __future__ import annotations
 
 import math
 
-from typing import List, NamedTuple, Union
+from typing import Dict, List, NamedTuple, Union
 
 import torch
 import torchaudio
@@ -10,6 +10,8 @@ import torchaudio
 torchaudio._extension._load_lib("libctc_prefix_decoder")
 import torchaudio.lib.pybind11_prefixctc as cuctc
 
+# the GPU decoder is only compiled with BUILD_CUDA_CTC_DECODER=1.
+_HAS_CUDA_DECODER = hasattr(cuctc, "ctc_beam_search_decoder_batch_gpu_v2")
 
 __all__ = ["CUCTCHypothesis", "CUCTCDecoder", "cuda_ctc_decoder"]
 
@@ -42,7 +44,13 @@ _DEFAULT_BLANK_SKIP_THREASHOLD = 0.95
 class CUCTCDecoder:
     """CUDA CTC beam search decoder.
 
-    .. devices:: CUDA
+    .. devices:: CPU CUDA
+
+    The decoding runs on the device of the input tensors. On CPU, the sequences
+    of the batch are decoded in parallel with ``torch.get_num_threads()`` threads,
+    and a stream can be decoded chunk by chunk with :py:meth:`begin`, :py:meth:`step`
+    and :py:meth:`finalize`. On CPU, the search can also be biased towards hotwords with
+    :py:meth:`set_hotwords`.
 
     Note:
         To build the decoder, please use the factory function :func:`cuda_ctc_decoder`.
@@ -72,9 +80,13 @@ class CUCTCDecoder:
         if cuda_stream:
             if not isinstance(cuda_stream, torch.cuda.streams.Stream):
                 raise AssertionError("cuda_stream must be torch.cuda.streams.Stream")
-        cuda_stream_ = cuda_stream.cuda_stream if cuda_stream else torch.cuda.current_stream().cuda_stream
-        self.internal_data = cuctc.prefixCTC_alloc(cuda_stream_)
-        self.memory = torch.empty(0, dtype=torch.int8, device=torch.device("cuda"))
+        self.internal_data = None
+        if _HAS_CUDA_DECODER and (cuda_stream or torch.cuda.is_available()):
+            cuda_stream_ = cuda_stream.cuda_stream if cuda_stream else torch.cuda.current_stream().cuda_stream
+            self.internal_data = cuctc.prefixCTC_alloc(cuda_stream_)
+        self.cpu_internal_data = cuctc.prefixCTC_alloc_cpu(torch.get_num_threads())
+        self.stream_batch_size = None
+        self.has_hotwords = False
         if blank_id != 0:
             raise AssertionError("blank_id must be 0")
         self.blank_id = blank_id
@@ -88,14 +100,30 @@ class CUCTCDecoder:
 
     def __del__(self):
         if cuctc is not None:
-            cuctc.prefixCTC_free(self.internal_data)
+            if self.internal_data is not None:
+                cuctc.prefixCTC_free(self.internal_data)
+            cuctc.prefixCTC_free_cpu(self.cpu_internal_data)
+
+    def _decode(self, decode_fn, internal_data, log_prob, encoder_out_lens):
+        # the decoders keep their workspace across calls, and only grow it for larger batches.
+        return decode_fn(
+            internal_data,
+            log_prob.data_ptr(),
+            encoder_out_lens.data_ptr(),
+            log_prob.size(),
+            log_prob.stride(),
+            self.beam_size,
+            self.blank_id,
+            self.space_id,
+            self.blank_skip_threshold,
+        )
 
     def __call__(self, log_prob: torch.Tensor, encoder_out_lens: torch.Tensor):
         """
         Args:
-            log_prob (torch.FloatTensor): GPU tensor of shape `(batch, frame, num_tokens)` storing sequences of
-                probability distribution over labels; log_softmax(output of acoustic model).
-            lengths (dtype torch.int32): GPU tensor of shape `(batch, )` storing the valid length of
+            log_prob (torch.FloatTensor): CPU or GPU tensor of shape `(batch, frame, num_tokens)` storing sequences
+                of probability distribution over labels; log_softmax(output of acoustic model).
+            lengths (dtype torch.int32): CPU or GPU tensor of shape `(batch, )` storing the valid length of
                 in time axis of the output Tensor in each batch.
 
         Returns:
@@ -106,38 +134,158 @@ class CUCTCDecoder:
             raise AssertionError("encoder_out_lens must be torch.int32")
         if not log_prob.dtype == torch.float32:
             raise AssertionError("log_prob must be torch.float32")
-        if not (log_prob.is_cuda and encoder_out_lens.is_cuda):
-            raise AssertionError("inputs must be cuda tensors")
+        if log_prob.device != encoder_out_lens.device:
+            raise AssertionError("inputs must be on the same device")
         if not (log_prob.is_contiguous() and encoder_out_lens.is_contiguous()):
             raise AssertionError("input tensors must be contiguous")
-        required_size, score_hyps = cuctc.ctc_beam_search_decoder_batch_gpu_v2(
-            self.internal_data,
-            self.memory.data_ptr(),
-            self.memory.size(0),
-            log_prob.data_ptr(),
-            encoder_out_lens.data_ptr(),
-            log_prob.size(),
-            log_prob.stride(),
+        if log_prob.is_cuda:
+            if self.internal_data is None:
+                raise AssertionError("CUDA decoding requires torchaudio built with BUILD_CUDA_CTC_DECODER=1")
+            if self.has_hotwords:
+                raise AssertionError("hotwords are only supported on CPU")
+            score_hyps = self._decode(
+                cuctc.ctc_beam_search_decoder_batch_gpu_workspace, self.internal_data, log_prob, encoder_out_lens
+            )
+        elif log_prob.device.type == "cpu":
+            # the one-shot decoding runs on the memory of the stream.
+            if self.stream_batch_size is not None:
+                raise AssertionError("CPU decoding can not run while decoding a stream, call finalize first")
+            score_hyps = self._decode(
+                cuctc.ctc_beam_search_decoder_batch_cpu_workspace, self.cpu_internal_data, log_prob, encoder_out_lens
+            )
+        else:
+            raise AssertionError("inputs must be cpu or cuda tensors")
+        return self._get_hypos(score_hyps)
+
+    def workspace_stats(self, device: Union[str, torch.device] = "cpu") -> Dict[str, int]:
+        """Statistics of the memory the decoder keeps across calls on ``device``.
+
+        The memory is grown to the largest batch decoded so far, so ``reallocations`` stops increasing once
+        the batches stop growing.
+
+        Args:
+            device (str or torch.device, optional): ``"cpu"`` or ``"cuda"``. (Default: ``"cpu"``)
+
+        Returns:
+            Dict[str, int]: ``capacity``, the number of bytes held, ``reallocations``, the number of times the
+            memory was grown, and ``calls``, the number of batches and streams decoded.
+        """
+        device = torch.device(device)
+        if device.type == "cuda":
+            if self.internal_data is None:
+                raise AssertionError("CUDA decoding requires torchaudio built with BUILD_CUDA_CTC_DECODER=1")
+            stats = cuctc.prefixCTC_workspace_stats(self.internal_data)
+        elif device.type == "cpu":
+            stats = cuctc.prefixCTC_workspace_stats_cpu(self.cpu_internal_data)
+        else:
+            raise AssertionError("device must be cpu or cuda")
+        return dict(zip(("capacity", "reallocations", "calls"), stats))
+
+    def set_hotwords(self, hotwords: List[List[str]], weight: Union[float, List[float]] = 1.0):
+        """Biases the CPU decoding towards hotwords.
+
+        Every token of a hotword matched by a hypothesis adds ``weight`` to its score. The bonus is taken back
+        if the match fails before the end of the hotword, and is kept once the hotword is complete, so the
+        returned scores only include the bonus of the complete hotwords. The hotwords apply to the following
+        calls and streams, and an empty list removes them.
+
+        Args:
+            hotwords (List[List[str]]): tokens of each hotword, from ``vocab_list``.
+            weight (float or List[float], optional): bonus of every token, for all the hotwords or for each
+                of them. (Default: 1.0)
+        """
+        if self.stream_batch_size is not None:
+            raise AssertionError("hotwords can not be changed while decoding a stream")
+        if isinstance(weight, (int, float)):
+            weight = [float(weight)] * len(hotwords)
+        if len(weight) != len(hotwords):
+            raise AssertionError("weight must be a float or have one value per hotword")
+        token_ids = {token: i for i, token in reversed(list(enumerate(self.vocab_list)))}
+        hotword_ids = []
+        for hotword in hotwords:
+            if len(hotword) == 0:
+                raise AssertionError("hotwords must not be empty")
+            for token in hotword:
+                if token not in token_ids or token_ids[token] == self.blank_id:
+                    raise AssertionError(f"hotword token {token} must be a non-blank token of vocab_list")
+            hotword_ids.append([token_ids[token] for token in hotword])
+        cuctc.ctc_beam_search_set_hotwords_cpu(self.cpu_internal_data, hotword_ids, weight)
+        self.has_hotwords = len(hotword_ids) > 0
+
+    def begin(self, batch_size: int):
+        """Starts decoding a stream of sequences on CPU.
+
+        The chunks of the stream are passed to :py:meth:`step`, and the beams are kept between them,
+        so that every chunk only decodes its own frames.
+
+        Args:
+            batch_size (int): number of sequences in the stream.
+        """
+        cuctc.ctc_beam_search_begin_cpu(
+            self.cpu_internal_data,
+            batch_size,
+            len(self.vocab_list),
             self.beam_size,
             self.blank_id,
             self.space_id,
             self.blank_skip_threshold,
         )
-        if required_size > 0:
-            self.memory = torch.empty(required_size, dtype=torch.int8, device=log_prob.device).contiguous()
-            _, score_hyps = cuctc.ctc_beam_search_decoder_batch_gpu_v2(
-                self.internal_data,
-                self.memory.data_ptr(),
-                self.memory.size(0),
-                log_prob.data_ptr(),
-                encoder_out_lens.data_ptr(),
-                log_prob.size(),
-                log_prob.stride(),
-                self.beam_size,
-                self.blank_id,
-                self.space_id,
-                self.blank_skip_threshold,
-            )
+        self.stream_batch_size = batch_size
+
+    def step(self, log_prob: torch.Tensor, encoder_out_lens: torch.Tensor) -> List[List[CUCTCHypothesis]]:
+        """Decodes the next chunk of the stream started by :py:meth:`begin`.
+
+        Args:
+            log_prob (torch.FloatTensor): CPU tensor of shape `(batch, frame, num_tokens)` storing the next frames
+                of the sequences; log_softmax(output of acoustic model).
+            encoder_out_lens (dtype torch.int32): CPU tensor of shape `(batch, )` storing the number of valid
+                frames of the chunk in each sequence.
+
+        Returns:
+            List[List[CUCTCHypothesis]]:
+                List of sorted best partial hypotheses for each sequence of the stream.
+        """
+        if self.stream_batch_size is None:
+            raise AssertionError("begin must be called before step")
+        if not encoder_out_lens.dtype == torch.int32:
+            raise AssertionError("encoder_out_lens must be torch.int32")
+        if not log_prob.dtype == torch.float32:
+            raise AssertionError("log_prob must be torch.float32")
+        if not (log_prob.device.type == "cpu" and encoder_out_lens.device.type == "cpu"):
+            raise AssertionError("inputs must be cpu tensors")
+        if not encoder_out_lens.is_contiguous():
+            raise AssertionError("encoder_out_lens must be contiguous")
+        if log_prob.size(0) != self.stream_batch_size or log_prob.size(2) != len(self.vocab_list):
+            raise AssertionError("log_prob must be of shape (batch_size, frame, len(vocab_list))")
+        if encoder_out_lens.shape != (self.stream_batch_size,):
+            raise AssertionError("encoder_out_lens must be of shape (batch_size, )")
+        cuctc.ctc_beam_search_step_cpu(
+            self.cpu_internal_data,
+            log_prob.data_ptr(),
+            encoder_out_lens.data_ptr(),
+            log_prob.size(),
+            log_prob.stride(),
+        )
+        return self._get_hypos(
+            cuctc.ctc_beam_search_beams_cpu(self.cpu_internal_data, self.stream_batch_size, self.beam_size, False)
+        )
+
+    def finalize(self) -> List[List[CUCTCHypothesis]]:
+        """Ends the stream started by :py:meth:`begin`.
+
+        Returns:
+            List[List[CUCTCHypothesis]]:
+                List of sorted best hypotheses for each sequence of the stream.
+        """
+        if self.stream_batch_size is None:
+            raise AssertionError("begin must be called before finalize")
+        score_hyps = cuctc.ctc_beam_search_beams_cpu(
+            self.cpu_internal_data, self.stream_batch_size, self.beam_size, True
+        )
+        self.stream_batch_size = None
+        return self._get_hypos(score_hyps)
+
+    def _get_hypos(self, score_hyps):
         batch_size = len(score_hyps)
         hypos = []
         for i in range(batch_size):
@@ -48,6 +48,19 @@ def _slice_state(states: List[List[torch.Tensor]], idx: int, device: torch.devic
     return [[state.index_select(0, idx_tensor) for state in state_tuple] for state_tuple in states]
 
 
+def _flatten_state(states: List[List[torch.Tensor]]) -> List[torch.Tensor]:
+    return [state for state_tuple in states for state in state_tuple]
+
+
+def _unflatten_state(states: List[torch.Tensor], sizes: List[int]) -> List[List[torch.Tensor]]:
+    unflattened: List[List[torch.Tensor]] = []
+    offset = 0
+    for size in sizes:
+        unflattened.append(states[offset : offset + size])
+        offset += size
+    return unflattened
+
+
 def _default_hypo_sort_key(hypo: Hypothesis) -> float:
     return _get_hypo_score(hypo) / (len(_get_hypo_tokens(hypo)) + 1)
 
@@ -87,6 +100,10 @@ class RNNTBeamSearch(torch.nn.Module):
             for a given hypothesis to rank hypotheses by. If ``None``, defaults to callable that returns
             hypothesis score normalized by token sequence length. (Default: None)
         step_max_tokens (int, optional): maximum number of tokens to emit per input time step. (Default: 100)
+        native_search (bool, optional): If ``True``, the hypotheses are managed by a C++ implementation of the
+            search, and only the prediction and joint networks are run in Python. It produces the same hypotheses
+            with less per-step overhead, but requires the default ``hypo_sort_key``, and is not used once the
+            module is scripted. (Default: ``False``)
     """
 
     def __init__(
@@ -96,8 +113,11 @@ class RNNTBeamSearch(torch.nn.Module):
         temperature: float = 1.0,
         hypo_sort_key: Optional[Callable[[Hypothesis], float]] = None,
         step_max_tokens: int = 100,
+        native_search: bool = False,
     ) -> None:
         super().__init__()
+        if native_search and hypo_sort_key is not None:
+            raise ValueError("native_search only supports the default hypo_sort_key.")
         self.model = model
         self.blank = blank
         self.temperature = temperature
@@ -108,6 +128,7 @@ class RNNTBeamSearch(torch.nn.Module):
             self.hypo_sort_key = hypo_sort_key
 
         self.step_max_tokens = step_max_tokens
+        self.native_search = native_search
 
     def _init_b_hypos(self, device: torch.device) -> List[Hypothesis]:
         token = self.blank
@@ -223,12 +244,62 @@ class RNNTBeamSearch(torch.nn.Module):
             new_hypos.append((new_tokens, pred_out[i].detach(), _slice_state(pred_states, i, device), scores[i]))
         return new_hypos
 
+    @torch.jit.unused
+    def _search_native(
+        self,
+        enc_out: torch.Tensor,
+        hypo: Optional[List[Hypothesis]],
+        beam_width: int,
+    ) -> List[Hypothesis]:
+        device = enc_out.device
+        one_tensor = torch.tensor([1], device=device)
+        b_hypos = self._init_b_hypos(device) if hypo is None else hypo
+        state_sizes = [len(state_tuple) for state_tuple in _get_hypo_state(b_hypos[0])]
+
+        engine = torch.classes.torchaudio.RNNTBeamSearchEngine(beam_width, self.step_max_tokens)
+        engine.reset(
+            [_get_hypo_tokens(h) for h in b_hypos],
+            [_get_hypo_score(h) for h in b_hypos],
+            torch.stack([_get_hypo_predictor_out(h) for h in b_hypos]),
+            _flatten_state(_batch_state(b_hypos)),
+        )
+        for t in range(enc_out.shape[1]):
+            engine.begin_frame()
+            while engine.has_active():
+                predictor_out = engine.active_predictor_out()
+                num_hypos = predictor_out.size(0)
+                joined_out, _, _ = self.model.join(
+                    enc_out[:, t : t + 1],
+                    one_tensor,
+                    predictor_out,
+                    torch.tensor([1] * num_hypos, device=device),
+                )
+                next_token_probs = torch.nn.functional.log_softmax(joined_out / self.temperature, dim=3)
+                tokens, states = engine.expand(next_token_probs[:, 0, 0].cpu())
+                if tokens.size(0) > 0:
+                    pred_out, _, pred_states = self.model.predict(
+                        tokens.to(device),
+                        torch.tensor([1] * tokens.size(0), device=device),
+                        _unflatten_state(states, state_sizes),
+                    )
+                    engine.add_predictions(pred_out.detach(), _flatten_state(pred_states))
+            engine.end_frame()
+
+        tokens, scores, predictor_out, states = engine.hypotheses()
+        states = _unflatten_state(states, state_sizes)
+        return [
+            (tokens[i], predictor_out[i], _slice_state(states, i, device), scores[i]) for i in range(len(tokens))
+        ]
+
     def _search(
         self,
         enc_out: torch.Tensor,
         hypo: Optional[List[Hypothesis]],
         beam_width: int,
     ) -> List[Hypothesis]:
+        if self.native_search and not torch.jit.is_scripting():
+            return self._search_native(enc_out, hypo, beam_width)
+
         n_time_steps = enc_out.shape[1]
         device = enc_out.device
 
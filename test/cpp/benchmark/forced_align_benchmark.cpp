@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+#include <libtorchaudio/forced_align/compute.h>
+#include <torch/torch.h>
+
+namespace {
+
+// Arguments: batch_size, num_frames, target_length, num_classes, num_threads,
+// checkpointed
+void BM_forced_align(benchmark::State& state) {
+  const int64_t batch_size = state.range(0);
+  const int64_t num_frames = state.range(1);
+  const int64_t target_length = state.range(2);
+  const int64_t num_classes = state.range(3);
+  at::set_num_threads(state.range(4));
+  const int64_t max_backpointer_bytes = state.range(5) ? 0 : 1 << 30;
+
+  torch::manual_seed(0);
+  auto log_probs = torch::log_softmax(
+      torch::randn({batch_size, num_frames, num_classes}), -1);
+  auto targets = torch::randint(
+      1, num_classes, {batch_size, target_length}, torch::kInt32);
+  auto input_lengths = torch::full({batch_size}, num_frames, torch::kInt32);
+  auto target_lengths =
+      torch::full({batch_size}, target_length, torch::kInt32);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(forced_align(
+        log_probs,
+        targets,
+        input_lengths,
+        target_lengths,
+        /*blank=*/0,
+        max_backpointer_bytes));
+  }
+  state.SetItemsProcessed(
+      state.iterations() * batch_size * num_frames * (2 * target_length + 1));
+}
+
+BENCHMARK(BM_forced_align)
+    ->ArgNames(
+        {"batch", "frames", "targets", "classes", "threads", "checkpointed"})
+    ->Args({1, 500, 100, 32, 1, 0})
+    ->Args({1, 3000, 600, 32, 1, 0})
+    ->Args({1, 3000, 600, 512, 1, 0})
+    ->Args({1, 30000, 6000, 32, 1, 0})
+    ->Args({1, 30000, 6000, 32, 1, 1})
+    ->Args({16, 500, 100, 32, 1, 0})
+    ->Args({16, 500, 100, 32, 4, 0})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
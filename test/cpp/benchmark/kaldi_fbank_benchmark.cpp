@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include <libtorchaudio/kaldi/fbank.h>
+#include <torch/torch.h>
+
+namespace {
+
+// Arguments: num_seconds, num_threads, with 16 kHz audio, 25 ms frames every
+// 10 ms and 80 mel bins.
+void BM_kaldi_fbank(benchmark::State& state) {
+  const int64_t num_samples = state.range(0) * 16000;
+  at::set_num_threads(state.range(1));
+  const int64_t window_size = 400;
+  const int64_t padded_window_size = 512;
+  const torchaudio::kaldi::FbankOptions options{
+      /*window_shift=*/160,
+      padded_window_size,
+      /*snip_edges=*/true,
+      /*dither=*/0.0,
+      /*remove_dc_offset=*/true,
+      /*preemphasis_coefficient=*/0.97,
+      /*raw_energy=*/true,
+      /*energy_floor=*/1.0,
+      /*use_power=*/true,
+      /*use_log_fbank=*/true};
+
+  torch::manual_seed(0);
+  auto waveform = torch::randn({num_samples});
+  auto window = torch::hann_window(window_size, /*periodic=*/false).pow(0.85);
+  auto mel_banks = torch::rand({80, padded_window_size / 2 + 1});
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(torchaudio::kaldi::compute_fbank(
+        waveform, torch::Tensor(), window, mel_banks, options));
+  }
+  state.SetItemsProcessed(
+      state.iterations() *
+      torchaudio::kaldi::num_frames(
+          num_samples, window_size, options.window_shift, options.snip_edges));
+}
+
+BENCHMARK(BM_kaldi_fbank)
+    ->ArgNames({"seconds", "threads"})
+    ->Args({10, 1})
+    ->Args({600, 1})
+    ->Args({600, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+#include <torch/torch.h>
+
+namespace {
+
+// Arguments: batch, channel, num_frames, order, num_threads
+void BM_lfilter_core_loop(benchmark::State& state) {
+  const int64_t batch = state.range(0);
+  const int64_t channel = state.range(1);
+  const int64_t num_frames = state.range(2);
+  const int64_t order = state.range(3);
+  at::set_num_threads(state.range(4));
+
+  static auto op = torch::Dispatcher::singleton()
+                       .findSchemaOrThrow("torchaudio::_lfilter_core_loop", "")
+                       .typed<void(
+                           const torch::Tensor&,
+                           const torch::Tensor&,
+                           torch::Tensor&)>();
+
+  torch::manual_seed(0);
+  auto input = torch::rand({batch, channel, num_frames});
+  auto a_coeff_flipped = torch::rand({channel, order}) * (0.5 / order);
+  auto output = torch::zeros({batch, channel, num_frames + order - 1});
+
+  for (auto _ : state) {
+    op.call(input, a_coeff_flipped, output);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * batch * channel * num_frames);
+}
+
+BENCHMARK(BM_lfilter_core_loop)
+    ->ArgNames({"batch", "channel", "frames", "order", "threads"})
+    ->ArgsProduct({{1, 8}, {1, 2}, {16000, 160000}, {3, 9}, {1, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Arguments: channel, num_frames, num_threads
+void BM_overdrive_core_loop(benchmark::State& state) {
+  const int64_t channel = state.range(0);
+  const int64_t num_frames = state.range(1);
+  at::set_num_threads(state.range(2));
+
+  static auto op =
+      torch::Dispatcher::singleton()
+          .findSchemaOrThrow("torchaudio::_overdrive_core_loop", "")
+          .typed<void(
+              torch::Tensor&,
+              torch::Tensor&,
+              torch::Tensor&,
+              torch::Tensor&,
+              torch::Tensor&)>();
+
+  torch::manual_seed(0);
+  auto waveform = torch::rand({channel, num_frames}) * 2 - 1;
+  auto temp = torch::tanh(waveform * 20);
+  auto last_in = torch::zeros({channel});
+  auto last_out = torch::zeros({channel});
+  auto output = torch::zeros_like(waveform);
+
+  for (auto _ : state) {
+    op.call(waveform, temp, last_in, last_out, output);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * channel * num_frames);
+}
+
+BENCHMARK(BM_overdrive_core_loop)
+    ->ArgNames({"channel", "frames", "threads"})
+    ->ArgsProduct({{1, 2, 8}, {16000, 160000}, {1, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
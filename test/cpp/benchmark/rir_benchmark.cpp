@@ -0,0 +1,135 @@
+#include <benchmark/benchmark.h>
+#include <torch/torch.h>
+
+namespace {
+
+// Arguments: num_image, num_mic
+void BM_simulate_rir(benchmark::State& state) {
+  const int64_t num_band = 7;
+  const int64_t num_image = state.range(0);
+  const int64_t num_mic = state.range(1);
+  const int64_t ir_length = 81;
+  const int64_t rir_length = 16000;
+
+  static auto op =
+      torch::Dispatcher::singleton()
+          .findSchemaOrThrow("torchaudio::_simulate_rir", "")
+          .typed<torch::Tensor(
+              const torch::Tensor&, const torch::Tensor&, int64_t)>();
+
+  torch::manual_seed(0);
+  auto irs = torch::rand({num_band, num_image, num_mic, ir_length});
+  auto delay = torch::randint(
+      0, rir_length - ir_length, {num_image, num_mic}, torch::kInt32);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(irs, delay, rir_length));
+  }
+  state.SetItemsProcessed(
+      state.iterations() * num_band * num_image * num_mic * ir_length);
+}
+
+BENCHMARK(BM_simulate_rir)
+    ->ArgNames({"images", "mics"})
+    ->ArgsProduct({{125, 1000, 4000}, {1, 4}})
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments: num_rays, num_mic
+void BM_ray_tracing(benchmark::State& state) {
+  const int64_t num_rays = state.range(0);
+  const int64_t num_mic = state.range(1);
+  const int64_t num_band = 7;
+
+  static auto op = torch::Dispatcher::singleton()
+                       .findSchemaOrThrow("torchaudio::ray_tracing", "")
+                       .typed<torch::Tensor(
+                           const torch::Tensor&,
+                           const torch::Tensor&,
+                           const torch::Tensor&,
+                           int64_t,
+                           const torch::Tensor&,
+                           const torch::Tensor&,
+                           double,
+                           double,
+                           double,
+                           double,
+                           double)>();
+
+  auto room = torch::tensor({6., 5., 3.}, torch::kFloat64);
+  auto source = torch::tensor({1., 4., 1.5}, torch::kFloat64);
+  auto mic_array =
+      torch::tensor({5., 1., 1.5}, torch::kFloat64).repeat({num_mic, 1}) +
+      torch::arange(num_mic, torch::kFloat64).unsqueeze(1) * 0.05;
+  auto absorption = torch::full({num_band, 6}, 0.1, torch::kFloat64);
+  auto scattering = torch::full({num_band, 6}, 0.2, torch::kFloat64);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(
+        room,
+        source,
+        mic_array,
+        num_rays,
+        absorption,
+        scattering,
+        /*mic_radius=*/0.5,
+        /*sound_speed=*/343.,
+        /*energy_thres=*/1e-7,
+        /*time_thres=*/0.5,
+        /*hist_bin_size=*/0.004));
+  }
+  state.SetItemsProcessed(state.iterations() * num_rays);
+}
+
+BENCHMARK(BM_ray_tracing)
+    ->ArgNames({"rays", "mics"})
+    ->ArgsProduct({{100, 1000}, {1, 4}})
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments: num_mic, num_bin, num_threads
+void BM_histogram_to_rir(benchmark::State& state) {
+  const int64_t num_mic = state.range(0);
+  const int64_t num_bin = state.range(1);
+  const int64_t num_band = 7;
+  at::set_num_threads(state.range(2));
+
+  static auto make_filter =
+      torch::Dispatcher::singleton()
+          .findSchemaOrThrow("torchaudio::_make_rir_filter", "")
+          .typed<torch::Tensor(torch::Tensor, double, int64_t)>();
+  static auto op = torch::Dispatcher::singleton()
+                       .findSchemaOrThrow("torchaudio::_histogram_to_rir", "")
+                       .typed<torch::Tensor(
+                           const torch::Tensor&,
+                           const torch::Tensor&,
+                           double,
+                           double,
+                           double,
+                           double,
+                           int64_t)>();
+
+  torch::manual_seed(0);
+  auto centers = 125. * torch::pow(2., torch::arange(num_band, torch::kFloat));
+  auto filters = make_filter.call(centers, 16000., 512);
+  auto histograms = torch::rand({num_mic, num_band, num_bin}) *
+      torch::exp(-torch::arange(num_bin, torch::kFloat) / 50.);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(
+        histograms,
+        filters,
+        /*volume=*/90.,
+        /*sample_rate=*/16000.,
+        /*hist_bin_size=*/0.004,
+        /*sound_speed=*/343.,
+        /*seed=*/0));
+  }
+  state.SetItemsProcessed(state.iterations() * num_mic * num_bin);
+}
+
+BENCHMARK(BM_histogram_to_rir)
+    ->ArgNames({"mics", "bins", "threads"})
+    ->ArgsProduct({{1, 8}, {125, 500}, {1, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
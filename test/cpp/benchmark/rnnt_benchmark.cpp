@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+#include <libtorchaudio/rnnt/compute.h>
+#include <torch/torch.h>
+
+namespace {
+
+// Arguments: batch, max_T, max_U, num_targets, num_threads
+void BM_rnnt_loss(benchmark::State& state) {
+  const int64_t batch = state.range(0);
+  const int64_t max_T = state.range(1);
+  const int64_t max_U = state.range(2);
+  const int64_t num_targets = state.range(3);
+  at::set_num_threads(state.range(4));
+
+  torch::manual_seed(0);
+  auto logits = torch::randn({batch, max_T, max_U + 1, num_targets});
+  auto targets =
+      torch::randint(1, num_targets, {batch, max_U}, torch::kInt32);
+  auto logit_lengths = torch::full({batch}, max_T, torch::kInt32);
+  auto target_lengths = torch::full({batch}, max_U, torch::kInt32);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rnnt_loss(
+        logits,
+        targets,
+        logit_lengths,
+        target_lengths,
+        /*blank=*/0,
+        /*clamp=*/-1,
+        /*fused_log_softmax=*/true,
+        /*num_threads=*/0));
+  }
+  state.SetItemsProcessed(
+      state.iterations() * batch * max_T * (max_U + 1) * num_targets);
+}
+
+BENCHMARK(BM_rnnt_loss)
+    ->ArgNames({"batch", "T", "U", "vocab", "threads"})
+    ->Args({4, 100, 20, 128, 1})
+    ->Args({4, 100, 20, 128, 4})
+    ->Args({8, 200, 40, 1024, 1})
+    ->Args({8, 200, 40, 1024, 4})
+    ->Args({16, 250, 60, 4096, 1})
+    ->Args({16, 250, 60, 4096, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
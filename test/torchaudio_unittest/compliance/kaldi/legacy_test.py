@@ -72,3 +72,53 @@ class Test_Kaldi(common_utils.TempDirMixin, common_utils.TorchaudioTestCase):
     def test_mfcc_empty(self):
         # Passing in an empty tensor should result in an error
         self.assertRaises(AssertionError, kaldi.mfcc, torch.empty(0))
+
+    def _test_native_fbank_helper(self, dtype, snip_edges, dither, raw_energy, remove_dc_offset, use_power):
+        torch.manual_seed(0)
+        waveform = torch.randn(1, 4000, dtype=dtype)
+        kwargs = {
+            "dither": dither,
+            "energy_floor": 0.0 if dither else 1.0,
+            "frame_length": 15.0,
+            "frame_shift": 7.0,
+            "preemphasis_coefficient": 0.97,
+            "raw_energy": raw_energy,
+            "remove_dc_offset": remove_dc_offset,
+            "snip_edges": snip_edges,
+            "use_energy": True,
+            "use_power": use_power,
+        }
+        torch.manual_seed(1)
+        native = kaldi.fbank(waveform, use_native=True, **kwargs)
+        torch.manual_seed(1)
+        generic = kaldi.fbank(waveform, **kwargs)
+        self.assertEqual(native, generic)
+
+    def test_native_fbank(self):
+        # the native fbank of the CPU matches the Python implementation.
+        for dtype in (torch.float32, torch.float64):
+            for snip_edges in (True, False):
+                for dither in (0.0, 1.0):
+                    for raw_energy in (True, False):
+                        for remove_dc_offset in (True, False):
+                            for use_power in (True, False):
+                                self._test_native_fbank_helper(
+                                    dtype, snip_edges, dither, raw_energy, remove_dc_offset, use_power
+                                )
+
+    def test_online_fbank(self):
+        # chunks of any size give the frames of the whole waveform.
+        kwargs = {"frame_length": 15.0, "frame_shift": 7.0, "use_energy": True}
+        for dtype in (torch.float32, torch.float64):
+            torch.manual_seed(0)
+            waveform = torch.randn(1, 4000, dtype=dtype)
+            chunk_sizes = [0, 1, 50, 111, 239, 240, 1000, 2359]
+            for online, expected in (
+                (kaldi.OnlineFbank(dtype=dtype, **kwargs), kaldi.fbank(waveform, **kwargs)),
+                (kaldi.OnlineMfcc(dtype=dtype, **kwargs), kaldi.mfcc(waveform, **kwargs)),
+            ):
+                for _ in range(2):
+                    chunks = torch.split(waveform, chunk_sizes, dim=1)
+                    output = torch.cat([online.accept_waveform(chunk) for chunk in chunks])
+                    self.assertEqual(output, expected)
+                    online.reset()
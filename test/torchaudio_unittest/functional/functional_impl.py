@@ -14,6 +14,7 @@ from torchaudio_unittest.common_utils import (
     get_whitenoise,
     nested_params,
     rnnt_utils,
+    skipIfNoRIR,
     TestBaseMixin,
 )
 
@@ -678,6 +679,32 @@ class Functional(TestBaseMixin):
             ref_costs, ref_gradients = rnnt_utils.compute_with_numpy_transducer(data=data)
             self._test_costs_and_gradients(data=data, ref_costs=ref_costs, ref_gradients=ref_gradients)
 
+    @parameterized.expand([(True,), (False,)])
+    def test_rnnt_loss_costs_and_gradients_large_lattice(self, fused_log_softmax):
+        """Lattices with at least 16 frames and 16 symbols, evaluated along anti-diagonals on CPU, match numpy"""
+        torch.manual_seed(31)
+        B, T, U, D = 4, 64, 40, 20
+        # min(T, U + 1) is 41, 16 and 20 for the first sequences, and below 16 for the last one.
+        logit_lengths = torch.tensor([64, 40, 20, 10], dtype=torch.int32, device=self.device)
+        target_lengths = torch.tensor([40, 15, 30, 12], dtype=torch.int32, device=self.device)
+        targets = torch.randint(0, D - 1, (B, U), dtype=torch.int32, device=self.device)
+        logits = torch.rand((B, T, U + 1, D), dtype=torch.float32, device=self.device).requires_grad_(True)
+
+        def grad_hook(grad):
+            logits.saved_grad = grad.clone()
+
+        logits.register_hook(grad_hook)
+        data = {
+            "logits": logits,
+            "targets": targets,
+            "logit_lengths": logit_lengths,
+            "target_lengths": target_lengths,
+            "blank": D - 1,
+            "fused_log_softmax": fused_log_softmax,
+        }
+        ref_costs, ref_gradients = rnnt_utils.compute_with_numpy_transducer(data=data)
+        self._test_costs_and_gradients(data=data, ref_costs=ref_costs, ref_gradients=ref_gradients)
+
     def test_rnnt_loss_nonfused_softmax(self):
         data = rnnt_utils.get_B1_T10_U3_D4_data()
         ref_costs, ref_gradients = rnnt_utils.compute_with_numpy_transducer(data=data)
@@ -687,6 +714,46 @@ class Functional(TestBaseMixin):
             ref_gradients=ref_gradients,
         )
 
+    def test_rnnt_loss_reuse_logits_for_grads(self):
+        """Writing the gradients into the logits storage gives the same costs and gradients"""
+        data = rnnt_utils.get_random_data(dtype=torch.float32, device=self.device, seed=21)
+        inputs = (data["targets"], data["logit_lengths"], data["target_lengths"])
+        leaf = data["logits"].detach().requires_grad_(True)
+        ref_costs = F.rnnt_loss(leaf, *inputs, reduction="none")
+        ref_costs.sum().backward()
+
+        logits = data["logits"].detach().requires_grad_(True)
+        overwritten = logits.clone()
+        version = overwritten._version
+        costs = F.rnnt_loss(overwritten, *inputs, reduction="none", reuse_logits_for_grads=True)
+        costs.sum().backward()
+        self.assertEqual(costs, ref_costs)
+        self.assertEqual(logits.grad, leaf.grad)
+        self.assertGreater(overwritten._version, version)
+
+        # only the op writing into the logits declares the mutation.
+        schema = torch.ops.torchaudio.rnnt_loss_reuse_logits.default._schema
+        self.assertTrue(schema.arguments[0].alias_info.is_write)
+        self.assertIsNone(torch.ops.torchaudio.rnnt_loss.default._schema.arguments[0].alias_info)
+
+        with self.assertRaises(ValueError):
+            F.rnnt_loss(logits, *inputs, reuse_logits_for_grads=True)
+
+        # without backward, the logits are left unchanged.
+        for requires_grad, grad_enabled in [(False, True), (True, False)]:
+            kept = data["logits"].detach().clone().requires_grad_(requires_grad).clone()
+            expected = kept.detach().clone()
+            with torch.set_grad_enabled(grad_enabled):
+                costs = F.rnnt_loss(kept, *inputs, reduction="none", reuse_logits_for_grads=True)
+            self.assertEqual(costs, ref_costs)
+            self.assertEqual(kept, expected)
+
+        # the output of log_softmax is saved for its backward, so it cannot be overwritten.
+        log_probs = torch.nn.functional.log_softmax(logits, dim=-1)
+        costs = F.rnnt_loss(log_probs, *inputs, fused_log_softmax=False, reuse_logits_for_grads=True)
+        with self.assertRaises(RuntimeError):
+            costs.backward()
+
     def test_psd(self):
         """Verify the ``F.psd`` method by the numpy implementation.
         Given the multi-channel complex-valued spectrum as the input,
@@ -1192,17 +1259,7 @@ class Functional(TestBaseMixin):
         with self.assertRaisesRegex(RuntimeError, r"targets must be int32 or int64 type"):
             hyp_path, hyp_scores = F.forced_align(log_probs, targets, input_lengths, target_lengths, blank)
 
-        log_probs = torch.rand(3, 4, 6, dtype=self.dtype, device=self.device)
-        targets = targets.int()
-        with self.assertRaisesRegex(
-            RuntimeError, r"The batch dimension for log_probs must be 1 at the current version"
-        ):
-            hyp_path, hyp_scores = F.forced_align(log_probs, targets, input_lengths, target_lengths, blank)
-
-        targets = torch.randint(0, 4, (3, 4), device=self.device)
         log_probs = torch.rand(1, 3, 6, dtype=self.dtype, device=self.device)
-        with self.assertRaisesRegex(RuntimeError, r"The batch dimension for targets must be 1 at the current version"):
-            hyp_path, hyp_scores = F.forced_align(log_probs, targets, input_lengths, target_lengths, blank)
 
         targets = torch.tensor([[0, 1, 2, 3]], dtype=targets_dtype, device=self.device)
         input_lengths = torch.randint(1, 5, (3, 5), device=self.device)
@@ -1348,8 +1405,557 @@ class FunctionalCPUOnly(TestBaseMixin):
             F.melscale_fbanks(201, 0, 8000, 128, 16000)
         assert len(w) == 1
 
+    @parameterized.expand([(1,), (2,), (3,)])
+    def test_rnnt_loss_num_threads(self, num_threads):
+        """Limiting the number of threads does not change the costs and gradients"""
+        data = rnnt_utils.get_random_data(dtype=torch.float32, device=self.device, seed=123)
+        ref_costs, ref_gradients = rnnt_utils.compute_with_pytorch_transducer(data=data)
+
+        logits = data["logits"].detach().requires_grad_(True)
+        costs = F.rnnt_loss(
+            logits,
+            data["targets"],
+            data["logit_lengths"],
+            data["target_lengths"],
+            reduction="none",
+            num_threads=num_threads,
+        )
+        costs.sum().backward()
+        self.assertEqual(costs, ref_costs)
+        self.assertEqual(logits.grad, ref_gradients)
+
+    def test_rnnt_best_path(self):
+        """rnnt_best_path matches a max-product dynamic programming over the lattice"""
+        data = rnnt_utils.get_random_data(max_B=4, max_T=16, max_U=8, dtype=torch.float32, device=self.device, seed=3)
+        logits, targets = data["logits"].detach(), data["targets"]
+        blank = logits.size(-1) - 1
+        paths, labels, scores = F.rnnt_best_path(logits, targets, data["logit_lengths"], data["target_lengths"])
+
+        log_probs = torch.nn.functional.log_softmax(logits, dim=-1)
+        for b, (T, U) in enumerate(zip(data["logit_lengths"].tolist(), data["target_lengths"].tolist())):
+            best = torch.full((T, U + 1), -float("inf"), dtype=torch.float64)
+            best[0, 0] = 0
+            for t in range(T):
+                for u in range(U + 1):
+                    if t > 0:
+                        best[t, u] = max(best[t, u], best[t - 1, u] + log_probs[b, t - 1, u, blank])
+                    if u > 0:
+                        best[t, u] = max(best[t, u], best[t, u - 1] + log_probs[b, t, u - 1, targets[b, u - 1]])
+            ref_score = best[T - 1, U] + log_probs[b, T - 1, U, blank]
+
+            num_steps = T + U
+            self.assertEqual(scores[b].sum().item(), ref_score.item(), atol=1e-4, rtol=1e-5)
+            self.assertEqual(labels[b, num_steps:], torch.full_like(labels[b, num_steps:], -1))
+            self.assertEqual((labels[b, :num_steps] != blank).sum().item(), U)
+            for (t, u), label, score in zip(paths[b, :num_steps].tolist(), labels[b].tolist(), scores[b].tolist()):
+                self.assertEqual(score, log_probs[b, t, u, label].item(), atol=1e-5, rtol=1e-5)
+
+    def test_rnnt_loss_deferred(self):
+        """Gradients computed in backward match the ones computed eagerly by rnnt_loss_forward"""
+        data = rnnt_utils.get_random_data(dtype=torch.float32, device=self.device, seed=5)
+        logits = data["logits"].detach().requires_grad_(True)
+        inputs = (data["targets"], data["logit_lengths"], data["target_lengths"])
+        dy = torch.rand((logits.size(0),), device=self.device)
+        blank = logits.size(-1) - 1
+
+        costs = F.rnnt_loss(logits, *inputs, blank=blank, clamp=0.5, reduction="none")
+        (grad,) = torch.autograd.grad(costs, logits, dy)
+
+        ref_costs, ref_grad = torch.ops.torchaudio.rnnt_loss_forward(logits.detach(), *inputs, blank, 0.5, True)
+        self.assertEqual(costs, ref_costs)
+        self.assertEqual(grad, ref_grad * dy.view((-1, 1, 1, 1)))
+
+    def test_rnnt_loss_deferred_workspace_reuse(self):
+        """The deferred forward pass takes its scratch buffer from the workspace pool"""
+        data = rnnt_utils.get_random_data(dtype=torch.float32, device=self.device, seed=5)
+        inputs = (data["targets"], data["logit_lengths"], data["target_lengths"])
+
+        def compute():
+            logits = data["logits"].detach().requires_grad_(True)
+            costs = F.rnnt_loss(logits, *inputs, reduction="none")
+            costs.sum().backward()
+            return costs, logits.grad
+
+        torch.ops.torchaudio.rnnt_release_workspaces()
+        costs1, grads1 = compute()
+        _, allocations, reuses = torch.ops.torchaudio.rnnt_workspace_stats()
+        costs, grads = compute()
+        _, allocations2, reuses2 = torch.ops.torchaudio.rnnt_workspace_stats()
+        self.assertEqual(allocations2, allocations)
+        self.assertEqual(reuses2, reuses + 1)
+        self.assertEqual(costs, costs1)
+        self.assertEqual(grads, grads1)
+
+    def test_rnnt_loss_workspace_reuse(self):
+        """Cached workspaces do not leak state between calls with different shapes"""
+
+        def compute(data):
+            logits = data["logits"].detach().requires_grad_(True)
+            costs = F.rnnt_loss(
+                logits, data["targets"], data["logit_lengths"], data["target_lengths"], reduction="none"
+            )
+            costs.sum().backward()
+            return costs, logits.grad
+
+        data1 = rnnt_utils.get_random_data(dtype=torch.float32, device=self.device, seed=1)
+        data2 = rnnt_utils.get_random_data(max_T=64, max_U=16, dtype=torch.float32, device=self.device, seed=2)
+        costs1, grads1 = compute(data1)
+        compute(data2)
+        costs, grads = compute(data1)
+        self.assertEqual(costs, costs1)
+        self.assertEqual(grads, grads1)
+
+        torch.ops.torchaudio.rnnt_release_workspaces()
+        costs, grads = compute(data1)
+        self.assertEqual(costs, costs1)
+        self.assertEqual(grads, grads1)
+
+    def test_rnnt_loss_workspace_cache_limit(self):
+        """Idle workspaces beyond the cache limit are freed, the least recently released first"""
+
+        def forward(data):
+            logits = data["logits"].detach()
+            inputs = (data["targets"], data["logit_lengths"], data["target_lengths"])
+            torch.ops.torchaudio.rnnt_loss_forward(logits, *inputs, logits.size(-1) - 1, -1.0, True)
+
+        stats = torch.ops.torchaudio.rnnt_workspace_stats
+        data1 = rnnt_utils.get_random_data(dtype=torch.float32, device=self.device, seed=1)
+        data2 = rnnt_utils.get_random_data(max_T=64, max_U=16, dtype=torch.float32, device=self.device, seed=2)
+        torch.ops.torchaudio.rnnt_release_workspaces()
+        try:
+            forward(data1)
+            bytes1, allocations, _ = stats()
+            forward(data2)
+            bytes2 = stats()[0] - bytes1
+            self.assertEqual(stats()[1], allocations + 1)
+
+            # only the workspace of data2, the most recently released, fits.
+            torch.ops.torchaudio.rnnt_set_workspace_cache_limit(bytes2)
+            self.assertEqual(stats()[0], bytes2)
+            forward(data2)
+            self.assertEqual(stats()[1], allocations + 1)
+            forward(data1)
+            self.assertEqual(stats()[1], allocations + 2)
+            self.assertLessEqual(stats()[0], bytes2)
+
+            torch.ops.torchaudio.rnnt_set_workspace_cache_limit(0)
+            self.assertEqual(stats()[0], 0)
+        finally:
+            torch.ops.torchaudio.rnnt_set_workspace_cache_limit(2**30)
+
+    @parameterized.expand(
+        [
+            (rnnt_utils.get_B1_T2_U3_D5_data,),
+            (rnnt_utils.get_B2_T4_U3_D3_data,),
+        ]
+    )
+    def test_rnnt_loss_costs_and_gradients_bfloat16(self, data_func):
+        data, ref_costs, ref_gradients = data_func(
+            dtype=torch.bfloat16,
+            device=self.device,
+        )
+        self._test_costs_and_gradients(
+            data=data,
+            ref_costs=ref_costs,
+            ref_gradients=ref_gradients,
+            atol=1e-2,
+            rtol=1e-2,
+        )
+
+    @parameterized.expand([(torch.float16,), (torch.bfloat16,)])
+    def test_rnnt_loss_costs_and_gradients_half_wide_vocab(self, dtype):
+        """Half precision losses over a vocabulary that fills the vector lanes of the log-sum-exp match float32"""
+        torch.manual_seed(0)
+        B, T, U, D = 3, 20, 8, 67
+        logits = torch.randn(B, T, U + 1, D, device=self.device).to(dtype)
+        targets = torch.randint(0, D - 1, (B, U), dtype=torch.int32, device=self.device)
+        logit_lengths = torch.tensor([T, T - 3, T - 7], dtype=torch.int32, device=self.device)
+        target_lengths = torch.tensor([U, U - 2, U - 5], dtype=torch.int32, device=self.device)
+
+        def compute(logits):
+            logits = logits.detach().requires_grad_(True)
+            costs = F.rnnt_loss(logits, targets, logit_lengths, target_lengths, blank=D - 1, reduction="none")
+            costs.sum().backward()
+            return costs, logits.grad
+
+        costs, grads = compute(logits)
+        # the same values in float32.
+        ref_costs, ref_grads = compute(logits.float())
+        self.assertEqual(costs.dtype, dtype)
+        self.assertEqual(costs.float(), ref_costs, atol=1e-2, rtol=1e-2)
+        self.assertEqual(grads.float(), ref_grads, atol=1e-2, rtol=1e-2)
+
+    @parameterized.expand([(torch.float32,), (torch.float16,), (torch.bfloat16,)])
+    def test_rnnt_row_logsumexp(self, dtype):
+        """The log-sum-exp kernel of the CPU loss matches torch.logsumexp, over the vector lanes and the tail"""
+        torch.manual_seed(0)
+        for D in [1, 7, 8, 9, 15, 16, 17, 32, 33, 67, 1000]:
+            x = (torch.randn(16, D) * 10).to(dtype)
+            # rows far from zero, with one large element, and with -inf elements.
+            x[1] += 1000
+            x[2, D // 2] = 80
+            x[3, ::2] = -math.inf
+            result = torch.ops.torchaudio._rnnt_row_logsumexp_for_test(x)
+            expected = torch.logsumexp(x.float(), dim=1)
+            self.assertEqual(result, expected, atol=1e-5, rtol=1e-5)
+
+    @parameterized.expand([(True,), (False,)])
+    def test_rnnt_loss_pruned_full_band(self, fused_log_softmax):
+        """rnnt_loss_pruned matches rnnt_loss when the band covers the whole lattice"""
+        data = rnnt_utils.get_random_data(
+            fused_log_softmax=fused_log_softmax, dtype=torch.float32, device=self.device, seed=7
+        )
+        B, T = data["logits"].shape[:2]
+        ranges = torch.zeros((B, T), dtype=torch.int32, device=self.device)
+
+        logits = data["logits"].detach().requires_grad_(True)
+        costs = F.rnnt_loss_pruned(
+            logits,
+            data["targets"],
+            ranges,
+            data["logit_lengths"],
+            data["target_lengths"],
+            reduction="none",
+            fused_log_softmax=fused_log_softmax,
+        )
+        costs.sum().backward()
+
+        ref_logits = data["logits"].detach().requires_grad_(True)
+        ref_costs = F.rnnt_loss(
+            ref_logits,
+            data["targets"],
+            data["logit_lengths"],
+            data["target_lengths"],
+            reduction="none",
+            fused_log_softmax=fused_log_softmax,
+        )
+        ref_costs.sum().backward()
+        self.assertEqual(costs, ref_costs)
+        self.assertEqual(logits.grad, ref_logits.grad)
+
+    @parameterized.expand([(True,), (False,)])
+    def test_rnnt_loss_pruned_narrow_band(self, fused_log_softmax):
+        """rnnt_loss_pruned matches the loss of the full lattice restricted to a band narrower than the targets"""
+        torch.manual_seed(13)
+        B, T, U, D, s_range = 3, 20, 10, 12, 4
+        blank = D - 1
+        full_logits = torch.randn(B, T, U + 1, D, device=self.device)
+        targets = torch.randint(0, blank, (B, U), dtype=torch.int32, device=self.device)
+        logit_lengths = torch.tensor([T, 17, 12], dtype=torch.int32, device=self.device)
+        target_lengths = torch.tensor([U, 8, 6], dtype=torch.int32, device=self.device)
+
+        # bands sliding linearly from the first to the last symbol.
+        ranges = torch.empty((B, T), dtype=torch.int32, device=self.device)
+        for b in range(B):
+            length, last = int(logit_lengths[b]), int(target_lengths[b]) + 1 - s_range
+            ranges[b, :length] = torch.linspace(0, last, length).round().to(torch.int32)
+            ranges[b, length:] = last
+        self.assertTrue((ranges[:, 1:] > 0).any())
+
+        symbols = ranges[..., None] + torch.arange(s_range, device=self.device)
+        index = symbols.clamp(max=U)[..., None].expand(B, T, s_range, D).long()
+        logits = full_logits.gather(2, index).requires_grad_(True)
+        costs = F.rnnt_loss_pruned(
+            logits,
+            targets,
+            ranges,
+            logit_lengths,
+            target_lengths,
+            blank=blank,
+            reduction="none",
+            fused_log_softmax=fused_log_softmax,
+        )
+        costs.sum().backward()
+
+        # alpha recursion over the nodes of the full lattice that are in the band of their frame.
+        ref_logits = full_logits.double().requires_grad_(True)
+        log_probs = ref_logits.log_softmax(-1) if fused_log_softmax else ref_logits
+        ref_costs = []
+        for b in range(B):
+            band = ranges[b].tolist()
+            num_frames, num_symbols = int(logit_lengths[b]), int(target_lengths[b]) + 1
+            alpha = {(0, 0): log_probs.new_zeros(())}
+            for t in range(num_frames):
+                for u in range(band[t], min(band[t] + s_range, num_symbols)):
+                    terms = []
+                    if (t - 1, u) in alpha:
+                        terms.append(alpha[(t - 1, u)] + log_probs[b, t - 1, u, blank])
+                    if (t, u - 1) in alpha:
+                        terms.append(alpha[(t, u - 1)] + log_probs[b, t, u - 1, targets[b, u - 1]])
+                    if terms:
+                        alpha[(t, u)] = torch.logsumexp(torch.stack(terms), 0)
+            last = (num_frames - 1, num_symbols - 1)
+            ref_costs.append(-(alpha[last] + log_probs[b, last[0], last[1], blank]))
+        ref_costs = torch.stack(ref_costs)
+        ref_costs.sum().backward()
+
+        ref_grad = ref_logits.grad.gather(2, index).masked_fill(symbols[..., None] > U, 0)
+        self.assertEqual(costs, ref_costs.float(), atol=1e-4, rtol=1e-4)
+        self.assertEqual(logits.grad, ref_grad.float(), atol=1e-4, rtol=1e-4)
+
+    def test_rnnt_loss_simple(self):
+        """rnnt_loss_simple matches rnnt_loss on the trivial joiner, and returns valid ranges"""
+        data = rnnt_utils.get_random_data(dtype=torch.float32, device=self.device, seed=11)
+        B, T, U, D = data["logits"].shape
+        s_range = 8
+        am = torch.randn((B, T, D), device=self.device, requires_grad=True)
+        lm = torch.randn((B, U, D), device=self.device, requires_grad=True)
+
+        costs, ranges = F.rnnt_loss_simple(
+            am, lm, data["targets"], data["logit_lengths"], data["target_lengths"], s_range, reduction="none"
+        )
+        am_grad, lm_grad = torch.autograd.grad(costs.sum(), (am, lm))
+
+        ref_costs = F.rnnt_loss(
+            am[:, :, None, :] + lm[:, None, :, :],
+            data["targets"],
+            data["logit_lengths"],
+            data["target_lengths"],
+            reduction="none",
+        )
+        ref_am_grad, ref_lm_grad = torch.autograd.grad(ref_costs.sum(), (am, lm))
+        self.assertEqual(costs, ref_costs, atol=1e-4, rtol=1e-4)
+        self.assertEqual(am_grad, ref_am_grad, atol=1e-4, rtol=1e-4)
+        self.assertEqual(lm_grad, ref_lm_grad, atol=1e-4, rtol=1e-4)
+
+        self.assertEqual(ranges.shape, (B, T))
+        for b in range(B):
+            length = data["logit_lengths"][b]
+            r = ranges[b, :length]
+            num_symbols = data["target_lengths"][b] + 1
+            self.assertEqual(r[0], 0)
+            self.assertTrue(((r[1:] - r[:-1]) >= 0).all())
+            self.assertTrue(((r[1:] - r[:-1]) < s_range).all())
+            self.assertTrue(r[-1] + s_range >= num_symbols)
+
+    @parameterized.expand([("relu",), ("tanh",)])
+    def test_rnnt_loss_fused_joiner(self, activation):
+        """rnnt_loss_fused_joiner matches rnnt_loss on the materialized joiner output"""
+        data = rnnt_utils.get_random_data(dtype=torch.float32, device=self.device, seed=13)
+        B, T, U, D = data["logits"].shape
+        H = 16
+        source = torch.randn((B, T, H), device=self.device, requires_grad=True)
+        target = torch.randn((B, U, H), device=self.device, requires_grad=True)
+        weight = torch.randn((D, H), device=self.device, requires_grad=True)
+        bias = torch.randn((D,), device=self.device, requires_grad=True)
+        inputs = (source, target, weight, bias)
+        dy = torch.rand((B,), device=self.device)
+
+        costs = F.rnnt_loss_fused_joiner(
+            *inputs,
+            data["targets"],
+            data["logit_lengths"],
+            data["target_lengths"],
+            activation=activation,
+            reduction="none",
+        )
+        grads = torch.autograd.grad(costs, inputs, dy)
+
+        hidden = source[:, :, None, :] + target[:, None, :, :]
+        hidden = torch.relu(hidden) if activation == "relu" else torch.tanh(hidden)
+        ref_costs = F.rnnt_loss(
+            torch.nn.functional.linear(hidden, weight, bias),
+            data["targets"],
+            data["logit_lengths"],
+            data["target_lengths"],
+            reduction="none",
+        )
+        ref_grads = torch.autograd.grad(ref_costs, inputs, dy)
+        self.assertEqual(costs, ref_costs, atol=1e-4, rtol=1e-4)
+        for grad, ref_grad in zip(grads, ref_grads):
+            self.assertEqual(grad, ref_grad, atol=1e-3, rtol=1e-3)
+
+    @parameterized.expand([(True,), (False,)])
+    def test_rnnt_loss_packed(self, fused_log_softmax):
+        """rnnt_loss_packed matches rnnt_loss on the padded logits"""
+        data = rnnt_utils.get_random_data(dtype=torch.float32, device=self.device, seed=17)
+        logits = data["logits"].detach()
+        if not fused_log_softmax:
+            logits = torch.nn.functional.log_softmax(logits, dim=-1)
+        logits.requires_grad_(True)
+        logit_lengths = data["logit_lengths"]
+        target_lengths = data["target_lengths"]
+        dy = torch.rand((logits.size(0),), device=self.device)
+
+        ref_costs = F.rnnt_loss(
+            logits,
+            data["targets"],
+            logit_lengths,
+            target_lengths,
+            reduction="none",
+            fused_log_softmax=fused_log_softmax,
+        )
+        (ref_grad,) = torch.autograd.grad(ref_costs, logits, dy)
+
+        def pack(padded):
+            lengths = zip(logit_lengths.tolist(), target_lengths.tolist())
+            return torch.cat([padded[b, :T, : U + 1].flatten(0, 1) for b, (T, U) in enumerate(lengths)])
+
+        packed = pack(logits)
+        costs = F.rnnt_loss_packed(
+            packed,
+            data["targets"],
+            logit_lengths,
+            target_lengths,
+            reduction="none",
+            fused_log_softmax=fused_log_softmax,
+        )
+        (grad,) = torch.autograd.grad(costs, packed, dy)
+        self.assertEqual(costs, ref_costs)
+        self.assertEqual(grad, pack(ref_grad))
+
+    @parameterized.expand([(torch.int32,), (torch.int64,)])
+    def test_forced_align_batch(self, targets_dtype):
+        """Aligning a ragged batch gives the alignments of its utterances"""
+        torch.random.manual_seed(0)
+        blank = 7
+        input_lengths = torch.tensor([30, 50, 12, 41])
+        target_lengths = torch.tensor([7, 10, 1, 4])
+        log_probs = torch.randn(4, 50, 8, dtype=self.dtype, device=self.device).log_softmax(-1)
+        targets = torch.randint(0, blank, (4, 10), dtype=targets_dtype, device=self.device)
+        paths, scores = F.forced_align(log_probs, targets, input_lengths, target_lengths, blank)
+        for b, (T, L) in enumerate(zip(input_lengths.tolist(), target_lengths.tolist())):
+            ref_path, ref_scores = F.forced_align(log_probs[b : b + 1, :T], targets[b : b + 1, :L], blank=blank)
+            self.assertEqual(paths[b, :T], ref_path[0])
+            self.assertEqual(scores[b, :T], ref_scores[0])
+            self.assertTrue((paths[b, T:] == blank).all())
+            self.assertTrue((scores[b, T:] == 0).all())
+
+        with self.assertRaisesRegex(RuntimeError, r"batch dimension mismatch between log_probs and targets"):
+            F.forced_align(log_probs, targets[:3], input_lengths, target_lengths, blank)
+        with self.assertRaisesRegex(RuntimeError, r"batch dimension mismatch between log_probs and input_lengths"):
+            F.forced_align(log_probs, targets, input_lengths[:3], target_lengths, blank)
+
+    @parameterized.expand([(torch.int32,), (torch.int64,)])
+    def test_forced_align_checkpointed(self, targets_dtype):
+        """Checkpointed alignment, used for long utterances, gives the same paths"""
+        torch.random.manual_seed(0)
+        blank = 0
+        input_lengths = torch.tensor([200, 37, 1])
+        target_lengths = torch.tensor([40, 12, 1])
+        log_probs = torch.randn(3, 200, 10, dtype=self.dtype, device=self.device).log_softmax(-1)
+        targets = torch.randint(1, 4, (3, 40), dtype=targets_dtype, device=self.device)
+        ref_paths, _ = torch.ops.torchaudio.forced_align(log_probs, targets, input_lengths, target_lengths, blank)
+        paths, _ = torch.ops.torchaudio.forced_align(log_probs, targets, input_lengths, target_lengths, blank, 0)
+        self.assertEqual(paths, ref_paths)
+
+    def test_forced_align_scores(self):
+        """Scores are the log probs of the path labels"""
+        torch.random.manual_seed(0)
+        input_lengths = torch.tensor([60, 45])
+        target_lengths = torch.tensor([20, 9])
+        log_probs = torch.randn(2, 60, 8, dtype=self.dtype, device=self.device).log_softmax(-1)
+        targets = torch.randint(1, 8, (2, 20), dtype=torch.int32, device=self.device)
+        paths, scores = F.forced_align(log_probs, targets, input_lengths, target_lengths, blank=0)
+        expected = log_probs.gather(-1, paths.long().unsqueeze(-1)).squeeze(-1)
+        expected[1, 45:] = 0
+        self.assertEqual(scores, expected)
+
+    @parameterized.expand([(torch.int32,), (torch.int64,)])
+    def test_forced_align_windowed(self, targets_dtype):
+        """Windowed alignment stitches the windows at anchors, and matches the full alignment"""
+        torch.random.manual_seed(0)
+        L, C = 200, 10
+        T = 10 * L + 7
+        targets = torch.randint(1, C, (1, L), dtype=targets_dtype)
+        # each target is emitted with a high probability over 3 frames, blank elsewhere.
+        emission = torch.full((1, T, C), 0.05 / (C - 1), dtype=self.dtype)
+        emission[0, :, 0] = 0.95
+        for i, token in enumerate(targets[0].tolist()):
+            emission[0, 10 * i + 2 : 10 * i + 5, 0] = 0.05 / (C - 1)
+            emission[0, 10 * i + 2 : 10 * i + 5, token] = 0.95
+        log_probs = emission.log()
+
+        ref_paths, ref_scores = F.forced_align(log_probs, targets, blank=0)
+        paths, scores, failed = F.forced_align_windowed(log_probs, targets, blank=0, window_size=150, overlap=30)
+        self.assertEqual(paths, ref_paths)
+        self.assertEqual(scores, ref_scores)
+        self.assertLess(failed.numel(), T // 150 // 2)
+
+        # without confident emissions, no window can be stitched.
+        log_probs = torch.randn(1, T, C, dtype=self.dtype).log_softmax(-1)
+        ref_paths, _ = F.forced_align(log_probs, targets, blank=0)
+        paths, _, failed = F.forced_align_windowed(log_probs, targets, blank=0, window_size=150, overlap=30)
+        self.assertEqual(paths, ref_paths)
+        self.assertEqual(failed, torch.arange(1, (T + 149) // 150))
+
+    def test_merge_tokens_native(self):
+        """Native merging gives the spans of the non-blank tokens and their mean scores"""
+        tokens = torch.tensor([0, 3, 3, 0, 0, 5, 3, 3, 3, 0, 2], dtype=torch.int32)
+        scores = torch.tensor([0.1, 0.2, 0.4, 0.5, 0.5, 0.9, 0.3, 0.6, 0.9, 0.1, 0.8], dtype=self.dtype)
+        span_tokens, starts, ends, span_scores = torch.ops.torchaudio.merge_tokens(tokens, scores, 0)
+        self.assertEqual(span_tokens, torch.tensor([3, 5, 3, 2], dtype=torch.int32))
+        self.assertEqual(starts, torch.tensor([1, 5, 6, 10]))
+        self.assertEqual(ends, torch.tensor([3, 6, 9, 11]))
+        self.assertEqual(span_scores, torch.tensor([0.3, 0.9, 0.6, 0.8], dtype=self.dtype))
+
+        span_tokens, starts, ends, span_scores = torch.ops.torchaudio.merge_tokens(tokens[:0], scores[:0], 0)
+        self.assertEqual(span_tokens.numel(), 0)
+
+    def _get_energy_histograms(self, num_mics, num_bins=50):
+        torch.manual_seed(0)
+        decay = torch.exp(-torch.arange(num_bins, dtype=self.dtype) / 10)
+        return torch.rand(num_mics, 7, num_bins, dtype=self.dtype) * decay
+
+    @skipIfNoRIR
+    def test_histogram_to_rir_shape(self):
+        """Each histogram bin gives hist_bin_size * sample_rate samples of the room impulse response"""
+        histograms = self._get_energy_histograms(num_mics=3, num_bins=50)
+        rirs = F.histogram_to_rir(histograms, 16000, volume=90.0, hist_bin_size=0.004)
+        self.assertEqual(rirs.shape, (3, 50 * 64))
+        self.assertEqual(rirs.dtype, self.dtype)
+        self.assertTrue(rirs.abs().sum() > 0)
+
+    @skipIfNoRIR
+    def test_histogram_to_rir_seed(self):
+        """The same seed gives the same room impulse responses, and microphone m uses seed + m"""
+        histograms = self._get_energy_histograms(num_mics=3)
+        rirs = F.histogram_to_rir(histograms, 16000, volume=90.0, seed=1)
+        self.assertEqual(F.histogram_to_rir(histograms, 16000, volume=90.0, seed=1), rirs, atol=0, rtol=0)
+        self.assertFalse(torch.equal(F.histogram_to_rir(histograms, 16000, volume=90.0, seed=2), rirs))
+        self.assertEqual(F.histogram_to_rir(histograms[1:], 16000, volume=90.0, seed=2), rirs[1:], atol=0, rtol=0)
+
+    @skipIfNoRIR
+    def test_histogram_to_rir_num_threads(self):
+        """The room impulse responses do not depend on the number of threads"""
+        histograms = self._get_energy_histograms(num_mics=8)
+        num_threads = torch.get_num_threads()
+        try:
+            torch.set_num_threads(1)
+            ref = F.histogram_to_rir(histograms, 16000, volume=90.0)
+            torch.set_num_threads(4)
+            rirs = F.histogram_to_rir(histograms, 16000, volume=90.0)
+        finally:
+            torch.set_num_threads(num_threads)
+        self.assertEqual(rirs, ref, atol=0, rtol=0)
+
+    @skipIfNoRIR
+    def test_histogram_to_rir_negative(self):
+        """Negative energies are rejected"""
+        histograms = self._get_energy_histograms(num_mics=2)
+        histograms[1, 3, 5] = -1.0
+        with self.assertRaisesRegex(RuntimeError, "non-negative"):
+            F.histogram_to_rir(histograms, 16000, volume=90.0)
+
 
 class FunctionalCUDAOnly(TestBaseMixin):
+    @parameterized.expand([(torch.int32,), (torch.int64,)])
+    def test_forced_align_batch_fail(self, targets_dtype):
+        log_probs = torch.rand(3, 4, 6, dtype=self.dtype, device=self.device)
+        targets = torch.tensor([[0, 1, 2, 3]], dtype=targets_dtype, device=self.device)
+        blank = 5
+        input_lengths = torch.tensor([log_probs.shape[1]], device=self.device)
+        target_lengths = torch.tensor([targets.shape[1]], device=self.device)
+        with self.assertRaisesRegex(
+            RuntimeError, r"The batch dimension for log_probs must be 1 at the current version"
+        ):
+            hyp_path, hyp_scores = F.forced_align(log_probs, targets, input_lengths, target_lengths, blank)
+
+        targets = torch.randint(0, 4, (3, 4), dtype=targets_dtype, device=self.device)
+        log_probs = torch.rand(1, 3, 6, dtype=self.dtype, device=self.device)
+        with self.assertRaisesRegex(RuntimeError, r"The batch dimension for targets must be 1 at the current version"):
+            hyp_path, hyp_scores = F.forced_align(log_probs, targets, input_lengths, target_lengths, blank)
+
     @nested_params(
         [torch.half, torch.float, torch.double],
         [torch.int32, torch.int64],
@@ -10,9 +10,9 @@ from torchaudio_unittest.common_utils import (
 NUM_TOKENS = 7
 
 
-@skipIfNoCuda
-@skipIfNoCuCtcDecoder
-class CUCTCDecoderTest(TempDirMixin, TorchaudioTestCase):
+class CUCTCDecoderTestMixin:
+    device = None
+
     def _get_decoder(self, tokens=None, **kwargs):
         from torchaudio.models.decoder import cuda_ctc_decoder
 
@@ -28,7 +28,7 @@ class CUCTCDecoderTest(TempDirMixin, TorchaudioTestCase):
     def _get_emissions(self):
         B, T, N = 4, 15, NUM_TOKENS
 
-        emissions = torch.rand(B, T, N).cuda()
+        emissions = torch.rand(B, T, N).to(self.device)
         emissions = torch.nn.functional.log_softmax(emissions, -1)
 
         return emissions
@@ -43,7 +43,135 @@ class CUCTCDecoderTest(TempDirMixin, TorchaudioTestCase):
 
     def test_shape(self):
         log_probs = self._get_emissions()
-        encoder_out_lens = torch.tensor([15, 14, 13, 12], dtype=torch.int32).cuda()
+        encoder_out_lens = torch.tensor([15, 14, 13, 12], dtype=torch.int32).to(self.device)
         decoder = self._get_decoder()
         results = decoder(log_probs, encoder_out_lens)
         self.assertEqual(len(results), log_probs.shape[0])
+
+    def test_peaky_emissions(self):
+        """The best hypothesis of peaky emissions is their collapsed argmax"""
+        B, T, N = 4, 15, NUM_TOKENS
+        torch.manual_seed(0)
+        labels = torch.randint(0, N, (B, T))
+        log_probs = torch.nn.functional.log_softmax(10 * torch.nn.functional.one_hot(labels, N).float(), -1)
+        encoder_out_lens = torch.tensor([15, 14, 13, 12], dtype=torch.int32)
+        decoder = self._get_decoder()
+        results = decoder(log_probs.to(self.device), encoder_out_lens.to(self.device))
+        for b in range(B):
+            expected = torch.unique_consecutive(labels[b, : encoder_out_lens[b]])
+            expected = expected[expected != 0].tolist()
+            self.assertEqual(results[b][0].tokens, expected)
+
+    def test_workspace_reuse(self):
+        """The workspace is kept across calls, and only grows for larger batches"""
+        log_probs = self._get_emissions()
+        encoder_out_lens = torch.tensor([15, 14, 13, 12], dtype=torch.int32).to(self.device)
+        decoder = self._get_decoder()
+        expected = decoder(log_probs, encoder_out_lens)
+        stats = decoder.workspace_stats(self.device)
+        self.assertEqual(stats["calls"], 1)
+        self.assertGreater(stats["capacity"], 0)
+        self.assertGreater(stats["reallocations"], 0)
+
+        self.assertEqual(decoder(log_probs, encoder_out_lens), expected)
+        decoder(log_probs[:2, :10].contiguous(), encoder_out_lens[:2].clamp(max=10))
+        self.assertEqual(decoder.workspace_stats(self.device), {**stats, "calls": 3})
+
+
+@skipIfNoCuda
+@skipIfNoCuCtcDecoder
+class CUCTCDecoderTest(CUCTCDecoderTestMixin, TempDirMixin, TorchaudioTestCase):
+    device = torch.device("cuda")
+
+    def test_cpu_cuda_consistency(self):
+        """CPU and CUDA decoders return the same hypotheses"""
+        torch.manual_seed(0)
+        log_probs = torch.nn.functional.log_softmax(3 * torch.randn(4, 15, NUM_TOKENS), -1)
+        encoder_out_lens = torch.tensor([15, 14, 13, 12], dtype=torch.int32)
+        decoder = self._get_decoder(nbest=3)
+        cpu_results = decoder(log_probs, encoder_out_lens)
+        cuda_results = decoder(log_probs.cuda(), encoder_out_lens.cuda())
+        for cpu_hypos, cuda_hypos in zip(cpu_results, cuda_results):
+            self.assertEqual(cpu_hypos[0].tokens, cuda_hypos[0].tokens)
+            self.assertEqual(
+                [hypo.score for hypo in cpu_hypos], [hypo.score for hypo in cuda_hypos], atol=1e-4, rtol=1e-4
+            )
+
+
+@skipIfNoCuCtcDecoder
+class CUCTCDecoderCPUTest(CUCTCDecoderTestMixin, TempDirMixin, TorchaudioTestCase):
+    device = torch.device("cpu")
+
+    def test_streaming(self):
+        """Decoding a stream chunk by chunk gives the hypotheses of the whole sequences"""
+        torch.manual_seed(0)
+        log_probs = torch.nn.functional.log_softmax(3 * torch.randn(4, 15, NUM_TOKENS), -1)
+        encoder_out_lens = torch.tensor([15, 14, 13, 12], dtype=torch.int32)
+        decoder = self._get_decoder(nbest=3)
+        expected = decoder(log_probs, encoder_out_lens)
+
+        decoder.begin(4)
+        for start in range(0, 15, 4):
+            chunk = log_probs[:, start : start + 4]
+            chunk_lens = (encoder_out_lens - start).clamp(0, chunk.size(1)).to(torch.int32)
+            partial = decoder.step(chunk, chunk_lens)
+            self.assertEqual(len(partial), 4)
+        results = decoder.finalize()
+        for hypos, expected_hypos in zip(results, expected):
+            self.assertEqual([hypo.tokens for hypo in hypos], [hypo.tokens for hypo in expected_hypos])
+            self.assertEqual([hypo.score for hypo in hypos], [hypo.score for hypo in expected_hypos])
+
+    def test_call_during_stream(self):
+        """Decoding a batch while a stream is active fails without touching the stream"""
+        torch.manual_seed(0)
+        log_probs = torch.nn.functional.log_softmax(3 * torch.randn(4, 15, NUM_TOKENS), -1)
+        encoder_out_lens = torch.tensor([15, 14, 13, 12], dtype=torch.int32)
+        decoder = self._get_decoder(nbest=3)
+        expected = decoder(log_probs, encoder_out_lens)
+
+        decoder.begin(4)
+        decoder.step(log_probs[:, :8], encoder_out_lens.clamp(max=8))
+        with self.assertRaises(AssertionError):
+            decoder(log_probs, encoder_out_lens)
+        decoder.step(log_probs[:, 8:], (encoder_out_lens - 8).clamp(min=0))
+        self.assertEqual(decoder.finalize(), expected)
+        self.assertEqual(decoder(log_probs, encoder_out_lens), expected)
+
+    def test_invalid_step(self):
+        """Invalid inputs of a step raise ValueError without touching the stream"""
+        torch.manual_seed(0)
+        log_probs = torch.nn.functional.log_softmax(3 * torch.randn(4, 15, NUM_TOKENS), -1)
+        encoder_out_lens = torch.tensor([15, 14, 13, 12], dtype=torch.int32)
+        decoder = self._get_decoder(nbest=3)
+        expected = decoder(log_probs, encoder_out_lens)
+
+        decoder.begin(4)
+        with self.assertRaises(ValueError):
+            decoder.step(log_probs[:, :4], torch.full((4,), 5, dtype=torch.int32))
+        decoder.step(log_probs, encoder_out_lens)
+        self.assertEqual(decoder.finalize(), expected)
+
+    def test_hotwords(self):
+        """Hotwords bias the search towards them, without changing the scores of the other hypotheses"""
+        tokens = ["-", "|", "f", "o", "b", "a", "r"]
+        probs = torch.tensor(
+            [
+                [0.05, 0.03, 0.5, 0.01, 0.4, 0.005, 0.005],
+                [0.9, 0.02, 0.02, 0.02, 0.02, 0.01, 0.01],
+                [0.05, 0.03, 0.01, 0.5, 0.005, 0.4, 0.005],
+                [0.9, 0.02, 0.02, 0.02, 0.02, 0.01, 0.01],
+            ]
+        )
+        log_probs = probs.log().unsqueeze(0)
+        encoder_out_lens = torch.tensor([4], dtype=torch.int32)
+        decoder = self._get_decoder(tokens=tokens, nbest=2)
+        expected = decoder(log_probs, encoder_out_lens)[0]
+        self.assertEqual(expected[0].words, ["f", "o"])
+
+        decoder.set_hotwords([["b", "a"]], 1.0)
+        hypos = decoder(log_probs, encoder_out_lens)[0]
+        self.assertEqual([hypo.words for hypo in hypos], [["b", "a"], ["f", "o"]])
+        self.assertEqual(hypos[1].score, expected[0].score)
+
+        decoder.set_hotwords([])
+        self.assertEqual(decoder(log_probs, encoder_out_lens)[0], expected)
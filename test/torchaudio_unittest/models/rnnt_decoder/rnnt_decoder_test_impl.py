@@ -103,3 +103,32 @@ class RNNTBeamSearchTestImpl(TestBaseMixin):
 
             scripted_state = scripted_res[1]
             scripted_hypo = scripted_res[0]
+
+    def test_native_search(self):
+        r"""Verify that the native search returns the same hypotheses as the Python search."""
+
+        input_config = self._get_input_config()
+        batch_size = input_config["batch_size"]
+        max_input_length = input_config["max_input_length"]
+        right_context_length = input_config["right_context_length"]
+        input_dim = input_config["input_dim"]
+        num_symbols = input_config["num_symbols"]
+        blank_idx = num_symbols - 1
+        beam_width = 5
+
+        input = torch.rand(batch_size, max_input_length + right_context_length, input_dim).to(
+            device=self.device, dtype=self.dtype
+        )
+        lengths = torch.full((batch_size,), max_input_length, device=self.device, dtype=torch.int32)
+
+        model = self._get_model()
+        with torch.no_grad():
+            res = RNNTBeamSearch(model, blank_idx)(input, lengths, beam_width)
+            native_res = RNNTBeamSearch(model, blank_idx, native_search=True)(input, lengths, beam_width)
+
+        self.assertEqual(len(res), len(native_res))
+        for hypo, native_hypo in zip(res, native_res):
+            self.assertEqual(hypo[0], native_hypo[0])
+            self.assertEqual(hypo[1], native_hypo[1])
+            self.assertEqual(hypo[2], native_hypo[2])
+            self.assertEqual(hypo[3], native_hypo[3], atol=1e-4, rtol=1e-5)
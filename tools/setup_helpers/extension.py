@@ -34,6 +34,7 @@ def _get_build(var, default=False):
 
 
 _BUILD_CPP_TEST = _get_build("BUILD_CPP_TEST", False)
+_BUILD_CPP_BENCHMARK = _get_build("BUILD_CPP_BENCHMARK", False)
 _BUILD_SOX = False if platform.system() == "Windows" else _get_build("BUILD_SOX", True)
 _BUILD_RIR = _get_build("BUILD_RIR", True)
 _BUILD_RNNT = _get_build("BUILD_RNNT", True)
@@ -42,6 +43,7 @@ _USE_ROCM = _get_build("USE_ROCM", torch.backends.cuda.is_built() and torch.vers
 _USE_CUDA = _get_build("USE_CUDA", torch.backends.cuda.is_built() and torch.version.hip is None)
 _BUILD_ALIGN = _get_build("BUILD_ALIGN", True)
 _BUILD_CUDA_CTC_DECODER = _get_build("BUILD_CUDA_CTC_DECODER", _USE_CUDA)
+_BUILD_CPU_CTC_DECODER = _get_build("BUILD_CPU_CTC_DECODER", True)
 _USE_OPENMP = _get_build("USE_OPENMP", True) and "ATen parallel backend: OpenMP" in torch.__config__.parallel_info()
 _TORCH_CUDA_ARCH_LIST = os.environ.get("TORCH_CUDA_ARCH_LIST", None)
 
@@ -51,7 +53,7 @@ def get_ext_modules():
         Extension(name="torchaudio.lib.libtorchaudio", sources=[]),
         Extension(name="torchaudio.lib._torchaudio", sources=[]),
     ]
-    if _BUILD_CUDA_CTC_DECODER:
+    if _BUILD_CUDA_CTC_DECODER or _BUILD_CPU_CTC_DECODER:
         modules.extend(
             [
                 Extension(name="torchaudio.lib.libctc_prefix_decoder", sources=[]),
@@ -102,11 +104,13 @@ class CMakeBuild(build_ext):
             "-DCMAKE_VERBOSE_MAKEFILE=ON",
             f"-DPython_INCLUDE_DIR={distutils.sysconfig.get_python_inc()}",
             f"-DBUILD_CPP_TEST={'ON' if _BUILD_CPP_TEST else 'OFF'}",
+            f"-DBUILD_CPP_BENCHMARK={'ON' if _BUILD_CPP_BENCHMARK else 'OFF'}",
             f"-DBUILD_SOX:BOOL={'ON' if _BUILD_SOX else 'OFF'}",
             f"-DBUILD_RIR:BOOL={'ON' if _BUILD_RIR else 'OFF'}",
             f"-DBUILD_RNNT:BOOL={'ON' if _BUILD_RNNT else 'OFF'}",
             f"-DBUILD_ALIGN:BOOL={'ON' if _BUILD_ALIGN else 'OFF'}",
             f"-DBUILD_CUDA_CTC_DECODER:BOOL={'ON' if _BUILD_CUDA_CTC_DECODER else 'OFF'}",
+            f"-DBUILD_CPU_CTC_DECODER:BOOL={'ON' if _BUILD_CPU_CTC_DECODER else 'OFF'}",
             "-DBUILD_TORCHAUDIO_PYTHON_EXTENSION:BOOL=ON",
             "-DBUILD_TORIO_PYTHON_EXTENSION:BOOL=ON",
             f"-DUSE_ROCM:BOOL={'ON' if _USE_ROCM else 'OFF'}",